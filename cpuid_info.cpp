@@ -1,137 +1,43 @@
+#include <cpuid_info/affinity.hpp>
+#include <cpuid_info/amx.hpp>
+#include <cpuid_info/autotune.hpp>
+#include <cpuid_info/bench.hpp>
+#include <cpuid_info/bench_bandwidth.hpp>
+#include <cpuid_info/bench_dot.hpp>
+#include <cpuid_info/bench_fma.hpp>
+#include <cpuid_info/bench_kernel.hpp>
+#include <cpuid_info/bench_latency.hpp>
+#include <cpuid_info/bench_pingpong.hpp>
+#include <cpuid_info/cache_domain.hpp>
+#include <cpuid_info/compiler_flags.hpp>
+#include <cpuid_info/dump.hpp>
+#include <cpuid_info/cpu_info.hpp>
+#include <cpuid_info/fleet.hpp>
+#include <cpuid_info/hybrid.hpp>
+#include <cpuid_info/hypervisor.hpp>
+#include <cpuid_info/mitigation.hpp>
+#include <cpuid_info/monitor.hpp>
+#include <cpuid_info/rdt.hpp>
+#include <cpuid_info/report.hpp>
+#include <cpuid_info/resctrl.hpp>
+#include <cpuid_info/target_header.hpp>
+#include <cpuid_info/topology.hpp>
+#include <cpuid_info/tsc.hpp>
+#include <cpuid_info/uarch.hpp>
+#include <cpuid_info/xsave.hpp>
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
-#ifdef _MSC
-#include <intrin.h>
-#endif
-
-struct Register {
-    unsigned eax;
-    unsigned ebx;
-    unsigned ecx;
-    unsigned edx;
-};
-
-inline Register cpuid(unsigned eax, unsigned ecx)
-{
-    Register reg;
-
-#ifdef _MSC
-    __cpuidex(reinterpret_cast<int *>(&reg), static_cast<int>(eax),
-        static_cast<int>(ecx));
-#else
-    unsigned ebx = 0;
-    unsigned edx = 0;
-    __asm__ volatile("cpuid\n"
-                     : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
-                     : "a"(eax), "c"(ecx));
-    reg.eax = eax;
-    reg.ebx = ebx;
-    reg.ecx = ecx;
-    reg.edx = edx;
-#endif
-
-    return reg;
-}
-
-inline unsigned extract_bits(unsigned r, int hi, int lo)
-{
-    return (r << (31 - hi)) >> (31 - hi + lo);
-}
-
-inline unsigned extract_byte(unsigned r, int b)
-{
-    return (r & (0xFFU << (b * 8))) >> (b * 8);
-}
-
-inline bool test_bit(unsigned r, int b) { return r & (0x01U << b); }
-
-class CacheParam
-{
-    public:
-    CacheParam(const Register &reg)
-        : level_(0)
-        , max_proc_sharing_(0)
-        , max_proc_physical_(0)
-        , line_size_(0)
-        , partitions_(0)
-        , ways_(0)
-        , sets_(0)
-        , self_initializing_(false)
-        , fully_associative_(false)
-        , wbinvd_(false)
-        , inclusiveness_(false)
-        , complex_indexing_(false)
-    {
-        switch (extract_bits(reg.eax, 4, 0)) {
-            case 1:
-                type_ = "Data";
-                break;
-            case 2:
-                type_ = "Instruction";
-                break;
-            case 3:
-                type_ = "Unified";
-                break;
-            default:
-                type_ = "Null";
-                return;
-        }
-
-        level_ = extract_bits(reg.eax, 7, 5);
-        self_initializing_ = test_bit(reg.eax, 8);
-        fully_associative_ = test_bit(reg.eax, 9);
-        max_proc_sharing_ = extract_bits(reg.eax, 25, 14) + 1;
-        max_proc_physical_ = extract_bits(reg.eax, 31, 26) + 1;
-
-        line_size_ = extract_bits(reg.ebx, 11, 0) + 1;
-        partitions_ = extract_bits(reg.ebx, 21, 12) + 1;
-        ways_ = extract_bits(reg.ebx, 31, 22) + 1;
-        sets_ = reg.ecx + 1;
-        size_ = line_size_ * partitions_ * ways_ * sets_;
-
-        wbinvd_ = test_bit(reg.edx, 0);
-        inclusiveness_ = test_bit(reg.edx, 1);
-        complex_indexing_ = test_bit(reg.edx, 2);
-    }
-
-    const std::string &type() const { return type_; }
-    unsigned level() const { return level_; }
-    unsigned max_proc_sharing() const { return max_proc_sharing_; }
-    unsigned max_proc_physical() const { return max_proc_physical_; }
-    unsigned line_size() const { return line_size_; }
-    unsigned partitions() const { return partitions_; }
-    unsigned ways() const { return ways_; }
-    unsigned sets() const { return sets_; }
-    unsigned size() const { return size_; }
-    bool self_initializing() const { return self_initializing_; }
-    bool fully_associative() const { return fully_associative_; }
-    bool wbinvd() const { return wbinvd_; }
-    bool inclusiveness() const { return inclusiveness_; }
-    bool complex_indexing() const { return complex_indexing_; }
-
-    private:
-    std::string type_;
-    unsigned level_;
-    unsigned max_proc_sharing_;
-    unsigned max_proc_physical_;
-    unsigned line_size_;
-    unsigned partitions_;
-    unsigned ways_;
-    unsigned sets_;
-    unsigned size_;
-    bool self_initializing_;
-    bool fully_associative_;
-    bool wbinvd_;
-    bool inclusiveness_;
-    bool complex_indexing_;
-}; // class CacheParam
+using namespace cpuid_info;
 
 inline void print_equal() { std::cout << std::string(100, '=') << std::endl; }
 
@@ -146,32 +52,35 @@ inline std::string hexnum(unsigned x)
     return ss.str();
 }
 
-inline void print_vendor()
+inline std::string bytes(unsigned b)
 {
-    Register reg(cpuid(0x00, 0x00));
-    char str[sizeof(unsigned) * 3 + 1] = {'\0'};
-    std::memcpy(str + sizeof(unsigned) * 0, &reg.ebx, sizeof(unsigned));
-    std::memcpy(str + sizeof(unsigned) * 1, &reg.edx, sizeof(unsigned));
-    std::memcpy(str + sizeof(unsigned) * 2, &reg.ecx, sizeof(unsigned));
+    std::stringstream ss;
+    if (b < 1024) {
+        ss << b;
+    } else if ((b /= 1024) < 1024) {
+        ss << b << "K";
+    } else if ((b /= 1024) < 1024) {
+        ss << b << "M";
+    } else {
+        ss << b / 1024 << "G";
+    }
 
-    std::cout << std::setw(10) << std::left << "Vendor" << str << std::endl;
+    return ss.str();
 }
 
-inline void print_brand()
+inline void print_vendor(const CpuInfo &info)
 {
-    if (cpuid(0x80000000, 0x00).eax < 0x80000004)
-        return;
+    std::cout << std::setw(10) << std::left << "Vendor" << info.vendor()
+              << std::endl;
+}
 
-    Register reg2(cpuid(0x80000002, 0));
-    Register reg3(cpuid(0x80000003, 0));
-    Register reg4(cpuid(0x80000004, 0));
-    const std::size_t reg_size = sizeof(unsigned) * 4;
-    char str[reg_size * 3] = {'\0'};
-    std::memcpy(str + reg_size * 0, &reg2, reg_size);
-    std::memcpy(str + reg_size * 1, &reg3, reg_size);
-    std::memcpy(str + reg_size * 2, &reg4, reg_size);
+inline void print_brand(const CpuInfo &info)
+{
+    if (info.snapshot().max_extended() < 0x80000004)
+        return;
 
-    std::cout << std::setw(10) << std::left << "Brand" << str << std::endl;
+    std::cout << std::setw(10) << std::left << "Brand" << info.brand()
+              << std::endl;
 }
 
 inline void test_feature(unsigned r, unsigned b, const std::string &feat)
@@ -181,14 +90,6 @@ inline void test_feature(unsigned r, unsigned b, const std::string &feat)
             std::cout << feat << std::endl;
 }
 
-inline void test_feature(std::vector<std::string> &feats, unsigned r,
-    unsigned b, const std::string &feat)
-{
-    if (test_bit(r, b))
-        if (feat != std::string("Reserved"))
-            feats.push_back(feat);
-}
-
 inline void print_leave(unsigned eax, unsigned ecx, const std::string &info)
 {
     print_equal();
@@ -199,162 +100,114 @@ inline void print_leave(unsigned eax, unsigned ecx, const std::string &info)
     print_dash();
 }
 
-inline void print_feature(std::vector<std::string> &feats)
+inline bool name_less(const char *a, const char *b)
 {
-    std::sort(feats.begin(), feats.end());
-    for (std::size_t i = 0; i != feats.size(); ++i) {
+    return std::strcmp(a, b) < 0;
+}
+
+inline void print_section(const std::string &title)
+{
+    print_equal();
+    std::cout << title << std::endl;
+    print_dash();
+}
+
+inline void print_feature(
+    const Features &features, unsigned eax, unsigned ecx = 0)
+{
+    const char *feats[feature_count];
+    std::size_t n = 0;
+    for (unsigned i = 0; i != feature_count; ++i) {
+        Feature f = static_cast<Feature>(i);
+        if (feature_info(f).eax == eax && feature_info(f).ecx == ecx &&
+            features.has(f))
+            feats[n++] = feature_name(f);
+    }
+
+    std::sort(feats, feats + n, name_less);
+    for (std::size_t i = 0; i != n; ++i) {
         std::cout << std::setw(16) << std::left << feats[i];
-        if (i % 6 == 5 || i + 1 == feats.size())
+        if (i % 6 == 5 || i + 1 == n)
             std::cout << std::endl;
     }
     print_dash();
 }
 
+inline bool any_feature(
+    const Features &features, unsigned eax, unsigned ecx = 0)
+{
+    for (unsigned i = 0; i != feature_count; ++i) {
+        Feature f = static_cast<Feature>(i);
+        if (feature_info(f).eax == eax && feature_info(f).ecx == ecx &&
+            features.has(f))
+            return true;
+    }
+
+    return false;
+}
+
 template <unsigned>
-inline void print_eax();
+inline void print_eax(const CpuInfo &info);
 
 template <>
-inline void print_eax<0x01>()
+inline void print_eax<0x01>(const CpuInfo &info)
 {
-    if (cpuid(0x00, 0x00).eax < 0x01)
+    if (info.snapshot().max_basic() < 0x01)
         return;
 
-    Register reg(cpuid(0x01, 0x00));
+    Signature sig(info.signature());
+    const Microarch *uarch = identify_microarch(info);
+    Quirks quirks(microarch_quirks(info));
+    print_leave(0x01, 0x00, "Processor Signature");
+
+    std::cout << std::setw(30) << std::left << "Family:";
+    std::cout << hexnum(sig.family) << std::endl;
+    std::cout << std::setw(30) << std::left << "Model:";
+    std::cout << hexnum(sig.model) << std::endl;
+    std::cout << std::setw(30) << std::left << "Stepping:";
+    std::cout << sig.stepping << std::endl;
+    std::cout << std::setw(30) << std::left << "Microarchitecture:";
+    std::cout << (uarch != nullptr ? uarch->name : "Unknown") << std::endl;
+    print_dash();
+
+    std::cout << std::setw(30) << std::left << "Slow PDEP/PEXT:";
+    std::cout << (quirks.slow_pdep_pext ? "Yes" : "No") << std::endl;
+    std::cout << std::setw(30) << std::left << "AVX-512 FMA ports:";
+    std::cout << quirks.avx512_fma_ports << std::endl;
+    std::cout << std::setw(30) << std::left << "rep movsb fastest for:";
+    std::cout << rep_movsb_name(quirks.rep_movsb) << std::endl;
+    std::cout << std::setw(30) << std::left << "Split lock detection:";
+    std::cout << (quirks.split_lock_detect ? "Yes" : "No") << std::endl;
+    print_dash();
+
     print_leave(0x01, 0x00, "Feature flags");
-    std::vector<std::string> feats;
-
-    test_feature(feats, reg.ecx, 0, "SSE3");
-    test_feature(feats, reg.ecx, 1, "PCLMULQDQ");
-    test_feature(feats, reg.ecx, 2, "DTES64");
-    test_feature(feats, reg.ecx, 3, "MONITOR");
-    test_feature(feats, reg.ecx, 4, "DS-CPL");
-    test_feature(feats, reg.ecx, 5, "VMX");
-    test_feature(feats, reg.ecx, 6, "SMX");
-    test_feature(feats, reg.ecx, 7, "EIST");
-    test_feature(feats, reg.ecx, 8, "TM2");
-    test_feature(feats, reg.ecx, 9, "SSSE3");
-    test_feature(feats, reg.ecx, 10, "CNXT-ID");
-    test_feature(feats, reg.ecx, 11, "SDBG");
-    test_feature(feats, reg.ecx, 12, "FMA");
-    test_feature(feats, reg.ecx, 13, "CMPXCHG16B");
-    test_feature(feats, reg.ecx, 14, "xTPR");
-    test_feature(feats, reg.ecx, 15, "PDCM");
-    test_feature(feats, reg.ecx, 16, "Reserved");
-    test_feature(feats, reg.ecx, 17, "PCID");
-    test_feature(feats, reg.ecx, 18, "DCA");
-    test_feature(feats, reg.ecx, 19, "SSE4.1");
-    test_feature(feats, reg.ecx, 20, "SSE4.2");
-    test_feature(feats, reg.ecx, 21, "x2APIC");
-    test_feature(feats, reg.ecx, 22, "MOVBE");
-    test_feature(feats, reg.ecx, 23, "POPCNT");
-    test_feature(feats, reg.ecx, 24, "TSC-Deadline");
-    test_feature(feats, reg.ecx, 25, "AESNI");
-    test_feature(feats, reg.ecx, 26, "XSAVE");
-    test_feature(feats, reg.ecx, 27, "OSXSAVE");
-    test_feature(feats, reg.ecx, 28, "AVX");
-    test_feature(feats, reg.ecx, 29, "F16C");
-    test_feature(feats, reg.ecx, 30, "RDRAND");
-    test_feature(feats, reg.ecx, 31, "Hypervisor");
-
-    test_feature(feats, reg.edx, 0, "FPU");
-    test_feature(feats, reg.edx, 1, "VME");
-    test_feature(feats, reg.edx, 2, "DE");
-    test_feature(feats, reg.edx, 3, "PSE");
-    test_feature(feats, reg.edx, 4, "TSC");
-    test_feature(feats, reg.edx, 5, "MSR");
-    test_feature(feats, reg.edx, 6, "PAE");
-    test_feature(feats, reg.edx, 7, "MCE");
-    test_feature(feats, reg.edx, 8, "CX8");
-    test_feature(feats, reg.edx, 9, "APIC");
-    test_feature(feats, reg.edx, 10, "Reserved");
-    test_feature(feats, reg.edx, 11, "SEP");
-    test_feature(feats, reg.edx, 12, "MTRR");
-    test_feature(feats, reg.edx, 13, "PGE");
-    test_feature(feats, reg.edx, 14, "MCA");
-    test_feature(feats, reg.edx, 15, "CMOV");
-    test_feature(feats, reg.edx, 16, "PAT");
-    test_feature(feats, reg.edx, 17, "PSE-36");
-    test_feature(feats, reg.edx, 18, "PSN");
-    test_feature(feats, reg.edx, 19, "CLFSH");
-    test_feature(feats, reg.edx, 20, "Reserved");
-    test_feature(feats, reg.edx, 21, "DS");
-    test_feature(feats, reg.edx, 22, "ACPI");
-    test_feature(feats, reg.edx, 23, "MMX");
-    test_feature(feats, reg.edx, 24, "FXSR");
-    test_feature(feats, reg.edx, 25, "SSE");
-    test_feature(feats, reg.edx, 26, "SSE2");
-    test_feature(feats, reg.edx, 27, "SS");
-    test_feature(feats, reg.edx, 28, "HTT");
-    test_feature(feats, reg.edx, 29, "TM");
-    test_feature(feats, reg.edx, 30, "IA64");
-    test_feature(feats, reg.edx, 31, "PBE");
-
-    print_feature(feats);
+    print_feature(info.features(), 0x01);
 }
 
 template <>
-inline void print_eax<0x02>()
+inline void print_eax<0x02>(const CpuInfo &info)
 {
-    if (cpuid(0x00, 0x00).eax < 0x02)
+    if (info.snapshot().max_basic() < 0x02)
         return;
 
-    Register reg(cpuid(0x02, 0x00));
+    Register reg(info.snapshot().get(0x02));
     print_leave(0x02, 0x00, "Cache and TLB information");
-    std::vector<unsigned> feats;
-
-    if (!test_bit(reg.eax, 31)) {
-        feats.push_back(extract_byte(reg.eax, 1));
-        feats.push_back(extract_byte(reg.eax, 2));
-        feats.push_back(extract_byte(reg.eax, 3));
-    }
-
-    if (!test_bit(reg.ebx, 31)) {
-        feats.push_back(extract_byte(reg.ebx, 0));
-        feats.push_back(extract_byte(reg.ebx, 1));
-        feats.push_back(extract_byte(reg.ebx, 2));
-        feats.push_back(extract_byte(reg.ebx, 3));
-    }
-
-    if (!test_bit(reg.ecx, 31)) {
-        feats.push_back(extract_byte(reg.ecx, 0));
-        feats.push_back(extract_byte(reg.ecx, 1));
-        feats.push_back(extract_byte(reg.ecx, 2));
-        feats.push_back(extract_byte(reg.ecx, 3));
-    }
-
-    if (!test_bit(reg.edx, 31)) {
-        feats.push_back(extract_byte(reg.edx, 0));
-        feats.push_back(extract_byte(reg.edx, 1));
-        feats.push_back(extract_byte(reg.edx, 2));
-        feats.push_back(extract_byte(reg.edx, 3));
-    }
-
-    std::sort(feats.begin(), feats.end());
-    for (std::size_t i = 0; i != feats.size(); ++i)
-        if (feats[i] != 0)
-            std::cout << hexnum(feats[i]) << ' ';
+    std::vector<unsigned> descriptors(leaf2_descriptors(reg));
+    for (std::size_t i = 0; i != descriptors.size(); ++i)
+        std::cout << hexnum(descriptors[i]) << ' ';
     std::cout << std::endl;
     print_dash();
 }
 
 template <>
-inline void print_eax<0x04>()
+inline void print_eax<0x04>(const CpuInfo &info)
 {
-    if (cpuid(0x00, 0x00).eax < 0x04)
+    unsigned eax = info.cache_leaf();
+    if (eax == 0 && info.snapshot().max_basic() < 0x04)
         return;
 
-    print_leave(0x04, 0x00, "Deterministic Cache Parameters");
-    unsigned ecx = 0x00;
-    std::vector<CacheParam> caches;
-    while (true) {
-        Register reg(cpuid(0x04, ecx));
-        if (extract_bits(reg.eax, 4, 0) == 0)
-            break;
-        caches.push_back(CacheParam(reg));
-        ++ecx;
-    }
-
-    std::stringstream ss;
+    print_leave(eax == 0 ? 0x04 : eax, 0x00, "Deterministic Cache Parameters");
+    const std::vector<CacheParam> &caches = info.caches();
 
     const int fix = 12;
     const int width = 40;
@@ -370,18 +223,7 @@ inline void print_eax<0x04>()
 
     std::cout << std::setw(width) << std::left << "Cache size (byte)";
     for (std::size_t i = 0; i != caches.size(); ++i) {
-        unsigned b = caches[i].size();
-        ss.str(std::string());
-        if (b < 1024) {
-            ss << b;
-        } else if ((b /= 1024) < 1024) {
-            ss << b << "K";
-        } else if ((b /= 1024) < 1024) {
-            ss << b << "M";
-        } else {
-            ss << b / 1024 << "G";
-        }
-        std::cout << std::setw(fix) << ss.str();
+        std::cout << std::setw(fix) << bytes(caches[i].size());
     }
     std::cout << std::endl;
 
@@ -453,235 +295,2089 @@ inline void print_eax<0x04>()
 }
 
 template <>
-inline void print_eax<0x06>()
+inline void print_eax<0x18>(const CpuInfo &info)
+{
+    unsigned eax = info.tlb_leaf();
+    if (eax == 0)
+        return;
+
+    print_leave(eax, 0x00, "Deterministic Address Translation Parameters");
+    const std::vector<TlbParam> &tlbs = info.tlbs();
+
+    const int fix = 12;
+    const int width = 40;
+    std::cout << std::setw(width) << std::left << "TLB level";
+    for (std::size_t i = 0; i != tlbs.size(); ++i)
+        std::cout << std::setw(fix) << tlbs[i].level;
+    std::cout << std::endl;
+
+    std::cout << std::setw(width) << std::left << "TLB type";
+    for (std::size_t i = 0; i != tlbs.size(); ++i)
+        std::cout << std::setw(fix) << tlbs[i].type;
+    std::cout << std::endl;
+
+    std::cout << std::setw(width) << std::left << "Page sizes";
+    for (std::size_t i = 0; i != tlbs.size(); ++i)
+        std::cout << std::setw(fix) << tlb_page_names(tlbs[i].pages);
+    std::cout << std::endl;
+
+    std::cout << std::setw(width) << std::left << "Entries";
+    for (std::size_t i = 0; i != tlbs.size(); ++i)
+        std::cout << std::setw(fix) << tlbs[i].entries;
+    std::cout << std::endl;
+
+    std::cout << std::setw(width) << std::left << "Ways of associative";
+    for (std::size_t i = 0; i != tlbs.size(); ++i) {
+        if (tlbs[i].ways == 0)
+            std::cout << std::setw(fix) << "-";
+        else
+            std::cout << std::setw(fix) << tlbs[i].ways;
+    }
+    std::cout << std::endl;
+
+    std::cout << std::setw(width) << std::left << "Fully associative";
+    for (std::size_t i = 0; i != tlbs.size(); ++i) {
+        std::cout << std::setw(fix)
+                  << (tlbs[i].fully_associative ? "Yes" : "No");
+    }
+    std::cout << std::endl;
+
+    std::cout << std::setw(width) << std::left << "Maximum Proc sharing";
+    for (std::size_t i = 0; i != tlbs.size(); ++i) {
+        if (tlbs[i].max_proc_sharing == 0)
+            std::cout << std::setw(fix) << "-";
+        else
+            std::cout << std::setw(fix) << tlbs[i].max_proc_sharing;
+    }
+    std::cout << std::endl;
+    print_dash();
+}
+
+template <>
+inline void print_eax<0x06>(const CpuInfo &info)
 {
-    if (cpuid(0x00, 0x00).eax < 0x06)
+    if (info.snapshot().max_basic() < 0x06)
         return;
 
-    Register reg(cpuid(0x06, 0x00));
+    Register reg(info.snapshot().get(0x06));
     print_leave(0x06, 0x00, "Thermal and Power Management");
 
-    test_feature(reg.eax, 0, "Digital temperature sensor");
-    test_feature(reg.eax, 1, "Intel Turbo Boost Technology");
-    test_feature(reg.eax, 2, "ARAT. APIC-Timer-always-running feature");
-    test_feature(reg.eax, 3, "Reserved");
-    test_feature(reg.eax, 4, "PLN. Power limit notification controls");
-    test_feature(reg.eax, 5, "ECMD. Clock modulation duty cycle extension");
-    test_feature(reg.eax, 6, "PTM. Package thermal management");
-    test_feature(reg.eax, 7, "HWP base registers");
-    test_feature(reg.eax, 8, "HWP_Notification ");
-    test_feature(reg.eax, 9, "HWP_Activity_Window");
-    test_feature(reg.eax, 10, "HWP_Energy_Performance_Preference");
-    test_feature(reg.eax, 11, "HWP_Package_Level_Request");
-    test_feature(reg.eax, 12, "Reserved");
-    test_feature(reg.eax, 13, "HDC base registers");
+    for (unsigned i = 0; i != power_feature_count; ++i) {
+        const PowerFeatureInfo &p = power_feature_table[i];
+        if (p.reg == RegisterName::EAX)
+            test_feature(reg.eax, p.bit, p.name);
+    }
 
     std::cout << "Number of Interrupt Thresholds in Digitial Thermal Sensor: "
               << (reg.ebx & 7) << std::endl;
 
-    test_feature(reg.ecx, 0, "Hardware Coordination Feedback Capability");
-    test_feature(reg.ecx, 1, "Reserved");
-    test_feature(reg.ecx, 2, "Reserved");
-    test_feature(reg.ecx, 3, "Performance-energy bias preference");
+    for (unsigned i = 0; i != power_feature_count; ++i) {
+        const PowerFeatureInfo &p = power_feature_table[i];
+        if (p.reg == RegisterName::ECX)
+            test_feature(reg.ecx, p.bit, p.name);
+    }
 
     print_dash();
 }
 
 template <>
-inline void print_eax<0x07>()
+inline void print_eax<0x07>(const CpuInfo &info)
 {
-    if (cpuid(0x00, 0x00).eax < 0x07)
+    if (info.snapshot().max_basic() < 0x07)
         return;
 
-    Register reg(cpuid(0x07, 0x00));
     print_leave(0x07, 0x00, "Extended feature flags");
-    std::vector<std::string> feats;
-
-    test_feature(feats, reg.ebx, 0, "FSGSBASE");
-    test_feature(feats, reg.ebx, 1, "IA32_TSC_ADJUST");
-    test_feature(feats, reg.ebx, 2, "SGX");
-    test_feature(feats, reg.ebx, 3, "BMI1");
-    test_feature(feats, reg.ebx, 4, "HLE");
-    test_feature(feats, reg.ebx, 5, "AVX2");
-    test_feature(feats, reg.ebx, 6, "Reserved");
-    test_feature(feats, reg.ebx, 7, "SMEP");
-    test_feature(feats, reg.ebx, 8, "BMI2");
-    test_feature(feats, reg.ebx, 9, "ERMS");
-    test_feature(feats, reg.ebx, 10, "INVPCID");
-    test_feature(feats, reg.ebx, 11, "RTM");
-    test_feature(feats, reg.ebx, 12, "PQM");
-    test_feature(feats, reg.ebx, 13, "FPU_CS_DS");
-    test_feature(feats, reg.ebx, 14, "MPX");
-    test_feature(feats, reg.ebx, 15, "PQE");
-    test_feature(feats, reg.ebx, 16, "AVX512F");
-    test_feature(feats, reg.ebx, 17, "AVX512DQ");
-    test_feature(feats, reg.ebx, 18, "RDSEED");
-    test_feature(feats, reg.ebx, 19, "ADX");
-    test_feature(feats, reg.ebx, 20, "SMAP");
-    test_feature(feats, reg.ebx, 21, "AVX512IFMA52");
-    test_feature(feats, reg.ebx, 22, "PCOMMIT");
-    test_feature(feats, reg.ebx, 23, "CLFLUSHOPT");
-    test_feature(feats, reg.ebx, 24, "CLWB");
-    test_feature(feats, reg.ebx, 25, "INTEL_TRACE");
-    test_feature(feats, reg.ebx, 26, "AVX512PF");
-    test_feature(feats, reg.ebx, 27, "AVX512ER");
-    test_feature(feats, reg.ebx, 28, "AVX512CD");
-    test_feature(feats, reg.ebx, 29, "SHA");
-    test_feature(feats, reg.ebx, 30, "AVX512BW");
-    test_feature(feats, reg.ebx, 31, "AVX512VL");
-
-    test_feature(feats, reg.ecx, 0, "PREFETCHHWT1");
-    test_feature(feats, reg.ecx, 1, "AVX512VBMI");
-    test_feature(feats, reg.ecx, 2, "Reserved");
-    test_feature(feats, reg.ecx, 3, "PKU");
-    test_feature(feats, reg.ecx, 4, "OSPKE");
-    test_feature(feats, reg.ecx, 5, "Reserved");
-    test_feature(feats, reg.ecx, 6, "Reserved");
-    test_feature(feats, reg.ecx, 7, "Reserved");
-    test_feature(feats, reg.ecx, 8, "Reserved");
-    test_feature(feats, reg.ecx, 9, "Reserved");
-    test_feature(feats, reg.ecx, 10, "Reserved");
-    test_feature(feats, reg.ecx, 11, "Reserved");
-    test_feature(feats, reg.ecx, 12, "Reserved");
-    test_feature(feats, reg.ecx, 13, "Reserved");
-    test_feature(feats, reg.ecx, 14, "Reserved");
-    test_feature(feats, reg.ecx, 15, "Reserved");
-    test_feature(feats, reg.ecx, 16, "Reserved");
-    test_feature(feats, reg.ecx, 17, "Reserved");
-    test_feature(feats, reg.ecx, 18, "Reserved");
-    test_feature(feats, reg.ecx, 19, "Reserved");
-    test_feature(feats, reg.ecx, 20, "Reserved");
-    test_feature(feats, reg.ecx, 21, "Reserved");
-    test_feature(feats, reg.ecx, 22, "Reserved");
-    test_feature(feats, reg.ecx, 23, "Reserved");
-    test_feature(feats, reg.ecx, 24, "Reserved");
-    test_feature(feats, reg.ecx, 25, "Reserved");
-    test_feature(feats, reg.ecx, 26, "Reserved");
-    test_feature(feats, reg.ecx, 27, "Reserved");
-    test_feature(feats, reg.ecx, 28, "Reserved");
-    test_feature(feats, reg.ecx, 29, "Reserved");
-    test_feature(feats, reg.ecx, 30, "Reserved");
-    test_feature(feats, reg.ecx, 31, "Reserved");
-
-    print_feature(feats);
+    print_feature(info.features(), 0x07);
+    if (info.snapshot().get(0x07).eax < 0x01)
+        return;
+
+    print_leave(0x07, 0x01, "Extended feature flags");
+    print_feature(info.features(), 0x07, 0x01);
+    if (info.snapshot().get(0x07).eax < 0x02)
+        return;
+
+    print_leave(0x07, 0x02, "Speculation controls");
+    print_feature(info.features(), 0x07, 0x02);
+}
+
+template <>
+inline void print_eax<0x1D>(const CpuInfo &info)
+{
+    AmxInfo amx(amx_info(info.snapshot()));
+    if (amx.empty())
+        return;
+
+    print_leave(0x1D, 0x00, "Tile Information (AMX)");
+    for (std::size_t i = 0; i != amx.palettes.size(); ++i) {
+        const AmxPalette &palette = amx.palettes[i];
+        std::cout << "Palette " << palette.id << ": " << palette.max_names
+                  << " tiles of " << palette.max_rows << " rows x "
+                  << palette.bytes_per_row << " bytes ("
+                  << palette.bytes_per_tile << " bytes each, "
+                  << palette.total_tile_bytes << " total)" << std::endl;
+    }
+    if (amx.tmul_max_k != 0)
+        std::cout << "TMUL: K up to " << amx.tmul_max_k << ", N up to "
+                  << amx.tmul_max_n << " bytes" << std::endl;
+    print_dash();
+}
+
+// Leaf 0x0D; with `live` also the state XCR0 of this CPU enables, which a
+// replayed dump does not record
+inline void print_xsave(const CpuInfo &info, bool live)
+{
+    XsaveInfo xsave(xsave_info(info.snapshot()));
+    if (xsave.empty())
+        return;
+
+    print_leave(0x0D, 0x00, "Processor Extended State Enumeration");
+    const int width = 30;
+    std::cout << std::setw(width) << std::left << "Instructions:";
+    std::cout << "XSAVE" << (xsave.xsaveopt ? " XSAVEOPT" : "")
+              << (xsave.xsavec ? " XSAVEC" : "")
+              << (xsave.xgetbv1 ? " XGETBV1" : "")
+              << (xsave.xsaves ? " XSAVES" : "") << (xsave.xfd ? " XFD" : "")
+              << std::endl;
+    std::uint64_t xcr0 = live ? os_xcr0() : 0;
+    if (live) {
+        std::stringstream ss;
+        ss << "0x" << std::hex << std::uppercase << xcr0;
+        std::cout << std::setw(width) << std::left << "XCR0 (enabled by OS):";
+        std::cout << ss.str() << std::endl;
+    }
+    print_dash();
+
+    const int fix = 16;
+    std::cout << std::setw(fix) << std::left << "Component";
+    std::cout << std::setw(fix) << std::right << "Bit";
+    std::cout << std::setw(fix) << std::right << "Bytes";
+    std::cout << std::setw(fix) << std::right << "Offset";
+    std::cout << std::setw(fix) << std::right << "State";
+    std::cout << std::setw(fix) << std::right << (live ? "Enabled" : "")
+              << std::endl;
+    unsigned avx512_bytes = 0;
+    unsigned amx_bytes = 0;
+    for (std::size_t i = 0; i != xsave.components.size(); ++i) {
+        const XsaveComponent &comp = xsave.components[i];
+        std::uint64_t bit = std::uint64_t(1) << comp.index;
+        if (xstate_avx512 & bit & ~xstate_avx)
+            avx512_bytes += comp.size;
+        if (xstate_amx & bit)
+            amx_bytes += comp.size;
+        std::cout << std::setw(fix) << std::left
+                  << xsave_component_name(comp.index);
+        std::cout << std::setw(fix) << std::right << comp.index;
+        std::cout << std::setw(fix) << std::right << comp.size;
+        std::cout << std::setw(fix) << std::right << comp.offset;
+        std::cout << std::setw(fix) << std::right
+                  << (comp.supervisor ? "Supervisor" : "User");
+        if (live && !comp.supervisor)
+            std::cout << std::setw(fix) << std::right
+                      << ((xcr0 & bit) ? "Yes" : "No");
+        std::cout << std::endl;
+    }
+    print_dash();
+
+    std::cout << std::setw(width) << std::left << "Standard format size:";
+    std::cout << xsave.enabled_size << " bytes enabled, " << xsave.max_size
+              << " with every component" << std::endl;
+    if (xsave.xsaves) {
+        std::cout << std::setw(width) << std::left << "Context switch size:";
+        std::cout << xsave.compacted_size << " bytes (XSAVES compacted)"
+                  << std::endl;
+    }
+    if (avx512_bytes != 0) {
+        std::cout << std::setw(width) << std::left << "AVX-512 state:";
+        std::cout << avx512_bytes << " bytes" << std::endl;
+    }
+    if (amx_bytes != 0) {
+        std::cout << std::setw(width) << std::left << "AMX state:";
+        std::cout << amx_bytes << " bytes, tile data only for threads that "
+                  << "requested it" << std::endl;
+    }
+    if (live) {
+        Features usable(usable_features(info.features(), xcr0));
+        std::stringstream ss;
+        for (unsigned f = 0; f != feature_count; ++f) {
+            Feature feature = static_cast<Feature>(f);
+            if (info.features().has(feature) && !usable.has(feature))
+                ss << ' ' << feature_name(feature);
+        }
+        std::string disabled(ss.str());
+        std::cout << std::setw(width) << std::left << "Present but not usable:";
+        std::cout << (disabled.empty() ? std::string("(none)")
+                                       : disabled.substr(1))
+                  << std::endl;
+    }
+    print_dash();
 }
 
 template <>
-inline void print_eax<0x16>()
+inline void print_eax<0x0F>(const CpuInfo &info)
 {
-    if (cpuid(0x00, 0x00).eax < 0x16)
+    RdtInfo rdt(rdt_info(info.snapshot()));
+    if (!rdt.monitoring())
         return;
 
-    Register reg(cpuid(0x16, 0x00));
+    print_leave(0x0F, 0x00, "Resource Director Monitoring");
+    const int width = 30;
+    std::cout << std::setw(width) << std::left << "Highest RMID:";
+    std::cout << rdt.max_rmid << std::endl;
+    if (rdt.l3_monitoring) {
+        std::cout << std::setw(width) << std::left << "L3 highest RMID:";
+        std::cout << rdt.l3_max_rmid << std::endl;
+        std::cout << std::setw(width) << std::left << "L3 events:";
+        std::cout << (rdt.l3_occupancy ? "Occupancy " : "")
+                  << (rdt.l3_total_bandwidth ? "Total-MBM " : "")
+                  << (rdt.l3_local_bandwidth ? "Local-MBM" : "") << std::endl;
+        std::cout << std::setw(width) << std::left << "Counter unit:";
+        std::cout << rdt.l3_scale << " bytes" << std::endl;
+        std::cout << std::setw(width) << std::left << "MBM counter width:";
+        std::cout << rdt.l3_counter_width << " bits"
+                  << (rdt.l3_overflow_bit ? ", overflow bit" : "")
+                  << std::endl;
+    }
+    print_dash();
+}
+
+template <>
+inline void print_eax<0x10>(const CpuInfo &info)
+{
+    RdtInfo rdt(rdt_info(info.snapshot()));
+    if (!rdt.allocation())
+        return;
+
+    print_leave(0x10, 0x00, "Resource Director Allocation");
+    const int fix = 16;
+    if (!rdt.caches.empty()) {
+        std::cout << std::setw(fix) << std::left << "Cache";
+        std::cout << std::setw(fix) << std::right << "Mask bits";
+        std::cout << std::setw(fix) << std::right << "Shareable";
+        std::cout << std::setw(fix) << std::right << "COS";
+        std::cout << std::setw(fix) << std::right << "CDP";
+        std::cout << std::setw(fix) << std::right << "Non-contiguous"
+                  << std::endl;
+        for (std::size_t i = 0; i != rdt.caches.size(); ++i) {
+            const RdtCacheAllocation &cache = rdt.caches[i];
+            std::cout << 'L' << std::setw(fix - 1) << std::left
+                      << cache.level;
+            std::cout << std::setw(fix) << std::right << cache.cbm_length;
+            std::cout << std::setw(fix) << std::right
+                      << hexnum(cache.shareable_mask);
+            std::cout << std::setw(fix) << std::right << cache.cos_count;
+            std::cout << std::setw(fix) << std::right
+                      << (cache.cdp ? "Yes" : "No");
+            std::cout << std::setw(fix) << std::right
+                      << (cache.non_contiguous ? "Yes" : "No") << std::endl;
+        }
+        print_dash();
+    }
+    if (rdt.mba) {
+        const int width = 30;
+        std::cout << std::setw(width) << std::left << "Memory bandwidth:";
+        if (rdt.mba_amd)
+            std::cout << "Limit up to " << rdt.mba_max << " x 1/8 GB/s";
+        else
+            std::cout << "Throttle up to " << rdt.mba_max << "%"
+                      << (rdt.mba_linear ? " (linear)" : " (non-linear)");
+        std::cout << ", " << rdt.mba_cos_count << " COS" << std::endl;
+        print_dash();
+    }
+}
+
+template <>
+inline void print_eax<0x15>(const CpuInfo &info)
+{
+    const Snapshot &snapshot = info.snapshot();
+    if (snapshot.max_basic() < 0x15 && snapshot.max_extended() < 0x80000007)
+        return;
+
+    TscInfo tsc(tsc_info(info));
+    print_leave(0x15, 0x00, "Time Stamp Counter");
+    const int width = 30;
+    std::cout << std::setw(width) << std::left << "Invariant TSC:";
+    std::cout << (tsc.invariant ? "Yes" : "No") << std::endl;
+    std::cout << std::setw(width) << std::left << "RDTSCP:";
+    std::cout << (tsc.rdtscp ? "Yes" : "No") << std::endl;
+    if (tsc.ratio_numerator != 0 && tsc.ratio_denominator != 0) {
+        std::cout << std::setw(width) << std::left << "TSC/crystal ratio:";
+        std::cout << tsc.ratio_numerator << "/" << tsc.ratio_denominator
+                  << std::endl;
+    }
+    if (tsc.crystal_hz != 0) {
+        std::cout << std::setw(width) << std::left << "Crystal clock:";
+        std::cout << tsc.crystal_hz / 1e6 << " MHz" << std::endl;
+    }
+    std::cout << std::setw(width) << std::left << "TSC frequency:";
+    if (tsc.hz != 0)
+        std::cout << std::fixed << std::setprecision(3) << tsc.hz / 1e6
+                  << " MHz (" << tsc_source_name(tsc.source) << ")";
+    else
+        std::cout << "Not enumerated, calibrate with --tsc";
+    std::cout << std::endl;
+    std::cout.unsetf(std::ios_base::floatfield);
+
+    print_dash();
+}
+
+template <>
+inline void print_eax<0x16>(const CpuInfo &info)
+{
+    if (info.snapshot().max_basic() < 0x16)
+        return;
+
+    const Frequency &freq = info.frequency();
     print_leave(0x16, 0x00, "Processor Frequency Information");
 
     std::cout << std::setw(30) << std::left << "Processor Base Frequence:";
-    std::cout << std::setw(10) << std::right << (reg.eax & 0xFFFF) << " MHz";
+    std::cout << std::setw(10) << std::right << freq.base << " MHz";
     std::cout << std::endl;
     std::cout << std::setw(30) << std::left << "Maximum Frequence:";
-    std::cout << std::setw(10) << std::right << (reg.ebx & 0xFFFF) << " MHz";
+    std::cout << std::setw(10) << std::right << freq.max << " MHz";
     std::cout << std::endl;
     std::cout << std::setw(30) << std::left << "Bus (Reference) frequence:";
-    std::cout << std::setw(10) << std::right << (reg.ecx & 0xFFFF) << " MHz";
+    std::cout << std::setw(10) << std::right << freq.bus << " MHz";
     std::cout << std::endl;
 
     print_dash();
 }
 
 template <>
-inline void print_eax<0x80000001>()
+inline void print_eax<0x40000000>(const CpuInfo &info)
+{
+    HypervisorInfo hv(hypervisor_info(info.snapshot()));
+    if (hv.empty())
+        return;
+
+    print_leave(hv.base, 0x00, "Hypervisor");
+    const int width = 30;
+    std::cout << std::setw(width) << std::left << "Vendor:";
+    std::cout << hypervisor_name(hv.vendor);
+    if (!hv.signature.empty())
+        std::cout << " (\"" << hv.signature << "\")";
+    std::cout << std::endl;
+    if (hv.base != 0) {
+        std::cout << std::setw(width) << std::left << "Leaves:";
+        std::cout << hexnum(hv.base) << " to " << hexnum(hv.max_leaf)
+                  << std::endl;
+    }
+    std::cout << std::setw(width) << std::left << "Hyper-V interface:";
+    std::cout << (hv.hyperv_interface ? "Yes" : "No") << std::endl;
+    std::cout << std::setw(width) << std::left << "Stable paravirtual clock:";
+    std::cout << (hv.stable_clock ? "Yes" : "No") << std::endl;
+    if (hv.vendor == Hypervisor::KVM) {
+        std::cout << std::setw(width) << std::left << "Dedicated vCPUs:";
+        std::cout << (hv.dedicated_cpus ? "Yes" : "No") << std::endl;
+    }
+    if (hv.vendor == Hypervisor::Xen) {
+        std::cout << std::setw(width) << std::left << "TSC emulated:";
+        std::cout << (hv.tsc_emulated ? "Yes" : "No") << std::endl;
+    }
+    if (hv.tsc_hz != 0) {
+        std::cout << std::setw(width) << std::left << "TSC frequency:";
+        std::cout << hv.tsc_hz / 1e6 << " MHz" << std::endl;
+    }
+    if (hv.apic_hz != 0) {
+        std::cout << std::setw(width) << std::left << "APIC timer frequency:";
+        std::cout << hv.apic_hz / 1e6 << " MHz" << std::endl;
+    }
+    print_dash();
+
+    if (!hv.features.empty()) {
+        for (std::size_t i = 0; i != hv.features.size(); ++i) {
+            std::cout << std::setw(20) << std::left << hv.features[i];
+            if (i % 5 == 4 || i + 1 == hv.features.size())
+                std::cout << std::endl;
+        }
+        print_dash();
+    }
+}
+
+template <>
+inline void print_eax<0x80000001>(const CpuInfo &info)
 {
-    if (cpuid(0x80000000, 0x00).eax < 0x80000001)
+    if (info.snapshot().max_extended() < 0x80000001)
         return;
 
-    Register reg(cpuid(0x80000001, 0x00));
     print_leave(
         0x80000001, 0x00, "Extended Processor Signature and Feature Bits");
-    std::vector<std::string> feats;
-
-    test_feature(feats, reg.ecx, 0, "LAHF_LM");
-    test_feature(feats, reg.ecx, 1, "CMP_LEGACY");
-    test_feature(feats, reg.ecx, 2, "SVM");
-    test_feature(feats, reg.ecx, 3, "EXTAPIC");
-    test_feature(feats, reg.ecx, 4, "CR8_LEGACY");
-    test_feature(feats, reg.ecx, 5, "ABM");
-    test_feature(feats, reg.ecx, 6, "SSE4A");
-    test_feature(feats, reg.ecx, 7, "MISALIGNSSE");
-    test_feature(feats, reg.ecx, 8, "3DNOWPREFETCH");
-    test_feature(feats, reg.ecx, 9, "OSVW");
-    test_feature(feats, reg.ecx, 10, "IBS");
-    test_feature(feats, reg.ecx, 11, "XOP");
-    test_feature(feats, reg.ecx, 12, "SKINIT");
-    test_feature(feats, reg.ecx, 13, "WDT");
-    test_feature(feats, reg.ecx, 14, "Reserved");
-    test_feature(feats, reg.ecx, 15, "LWP");
-    test_feature(feats, reg.ecx, 16, "FMA4");
-    test_feature(feats, reg.ecx, 17, "TCE");
-    test_feature(feats, reg.ecx, 18, "Reserved");
-    test_feature(feats, reg.ecx, 19, "NODEID_MSR");
-    test_feature(feats, reg.ecx, 20, "Reserved");
-    test_feature(feats, reg.ecx, 21, "TBM");
-    test_feature(feats, reg.ecx, 22, "TOPOEXT");
-    test_feature(feats, reg.ecx, 23, "PERFCTR_CORE");
-    test_feature(feats, reg.ecx, 24, "PERFCTR_NB");
-    test_feature(feats, reg.ecx, 25, "Reserved");
-    test_feature(feats, reg.ecx, 26, "DBX");
-    test_feature(feats, reg.ecx, 27, "PERFTSC");
-    test_feature(feats, reg.ecx, 28, "PCX_L2I");
-    test_feature(feats, reg.ecx, 29, "Reserved");
-    test_feature(feats, reg.ecx, 30, "Reserved");
-    test_feature(feats, reg.ecx, 31, "Reserved");
-
-    test_feature(feats, reg.edx, 0, "FPU");
-    test_feature(feats, reg.edx, 1, "VME");
-    test_feature(feats, reg.edx, 2, "DE");
-    test_feature(feats, reg.edx, 3, "PSE");
-    test_feature(feats, reg.edx, 4, "TSC");
-    test_feature(feats, reg.edx, 5, "MSR");
-    test_feature(feats, reg.edx, 6, "PAE");
-    test_feature(feats, reg.edx, 7, "MCE");
-    test_feature(feats, reg.edx, 8, "CX8");
-    test_feature(feats, reg.edx, 9, "APIC");
-    test_feature(feats, reg.edx, 10, "Reserved");
-    test_feature(feats, reg.edx, 11, "SYSCALL");
-    test_feature(feats, reg.edx, 12, "MTRR");
-    test_feature(feats, reg.edx, 13, "PGE");
-    test_feature(feats, reg.edx, 14, "MCA");
-    test_feature(feats, reg.edx, 15, "CMOV");
-    test_feature(feats, reg.edx, 16, "PAT");
-    test_feature(feats, reg.edx, 17, "PSE36");
-    test_feature(feats, reg.edx, 18, "Reserved");
-    test_feature(feats, reg.edx, 19, "MP");
-    test_feature(feats, reg.edx, 20, "NX");
-    test_feature(feats, reg.edx, 21, "Reserved");
-    test_feature(feats, reg.edx, 22, "MMX");
-    test_feature(feats, reg.edx, 23, "MMXEXT");
-    test_feature(feats, reg.edx, 24, "FXSR");
-    test_feature(feats, reg.edx, 25, "FXSR_OPT");
-    test_feature(feats, reg.edx, 26, "GBPAGES");
-    test_feature(feats, reg.edx, 27, "RDTSCP");
-    test_feature(feats, reg.edx, 28, "Reserved");
-    test_feature(feats, reg.edx, 29, "LM");
-    test_feature(feats, reg.edx, 30, "3DNOWEXT");
-    test_feature(feats, reg.edx, 31, "3DNOW");
-
-    print_feature(feats);
-}
-
-int main()
+    print_feature(info.features(), 0x80000001);
+}
+
+template <>
+inline void print_eax<0x80000008>(const CpuInfo &info)
+{
+    if (info.snapshot().max_extended() < 0x80000008)
+        return;
+
+    Register reg(info.snapshot().get(0x80000008));
+    const CoreCount &count = info.core_count();
+    print_leave(0x80000008, 0x00, "Address Sizes and Core Count");
+
+    std::cout << std::setw(30) << std::left << "Physical address bits:";
+    std::cout << std::setw(10) << std::right << extract_bits(reg.eax, 7, 0);
+    std::cout << std::endl;
+    std::cout << std::setw(30) << std::left << "Linear address bits:";
+    std::cout << std::setw(10) << std::right << extract_bits(reg.eax, 15, 8);
+    std::cout << std::endl;
+    // ECX is reserved on Intel
+    if (reg.ecx != 0) {
+        std::cout << std::setw(30) << std::left << "Threads per package (NC):";
+        std::cout << std::setw(10) << std::right
+                  << extract_bits(reg.ecx, 7, 0) + 1;
+        std::cout << std::endl;
+        std::cout << std::setw(30) << std::left << "APIC ID bits (ApicIdSize):";
+        std::cout << std::setw(10) << std::right
+                  << extract_bits(reg.ecx, 15, 12);
+        std::cout << std::endl;
+    }
+    std::cout << std::setw(30) << std::left << "Core count from:";
+    std::cout << std::setw(10) << std::right << hexnum(count.leaf);
+    std::cout << (count.leaf == 0x04 ? " and 0x01" : "") << std::endl;
+    std::cout << std::setw(30) << std::left << "Threads per core:";
+    std::cout << std::setw(10) << std::right << count.threads_per_core;
+    std::cout << std::endl;
+    std::cout << std::setw(30) << std::left << "Cores per package:";
+    std::cout << std::setw(10) << std::right << count.cores_per_package;
+    std::cout << std::endl;
+    std::cout << std::setw(30) << std::left << "Threads per package:";
+    std::cout << std::setw(10) << std::right << count.threads_per_package;
+    std::cout << std::endl;
+    print_dash();
+
+    // AMD's speculation controls
+    if (any_feature(info.features(), 0x80000008)) {
+        print_leave(0x80000008, 0x00, "Speculation controls");
+        print_feature(info.features(), 0x80000008);
+    }
+    if (any_feature(info.features(), 0x80000021)) {
+        print_leave(0x80000021, 0x00, "Extended feature flags 2");
+        print_feature(info.features(), 0x80000021);
+    }
+}
+
+template <>
+inline void print_eax<0x8000001E>(const CpuInfo &info)
+{
+    if (info.snapshot().max_extended() < 0x8000001E ||
+        !info.features().has(Feature::TOPOEXT))
+        return;
+
+    Register reg(info.snapshot().get(0x8000001E));
+    print_leave(0x8000001E, 0x00, "Extended APIC ID, Core and Node");
+
+    std::cout << std::setw(30) << std::left << "Extended APIC ID:";
+    std::cout << std::setw(10) << std::right << hexnum(reg.eax);
+    std::cout << std::endl;
+    std::cout << std::setw(30) << std::left << "Core ID:";
+    std::cout << std::setw(10) << std::right << extract_bits(reg.ebx, 7, 0);
+    std::cout << std::endl;
+    std::cout << std::setw(30) << std::left << "Threads per core:";
+    std::cout << std::setw(10) << std::right
+              << extract_bits(reg.ebx, 15, 8) + 1;
+    std::cout << std::endl;
+    std::cout << std::setw(30) << std::left << "Node ID:";
+    std::cout << std::setw(10) << std::right << extract_bits(reg.ecx, 7, 0);
+    std::cout << std::endl;
+    std::cout << std::setw(30) << std::left << "Nodes per processor:";
+    std::cout << std::setw(10) << std::right
+              << extract_bits(reg.ecx, 10, 8) + 1;
+    std::cout << std::endl;
+
+    print_dash();
+}
+
+// `ms` is the enumeration time, negative for a replayed topology
+inline void print_topology(const Topology &topo, double ms)
+{
+    print_section("Processor Topology");
+    std::cout << topo.threads() << " logical CPUs, " << topo.cores()
+              << " cores, " << topo.dies() << " dies, " << topo.packages()
+              << " packages";
+    if (ms < 0)
+        std::cout << " (replayed)" << std::endl;
+    else
+        std::cout << " (enumerated in " << std::fixed << std::setprecision(3)
+                  << ms << " ms)" << std::endl;
+    std::cout.unsetf(std::ios_base::floatfield);
+    print_dash();
+
+    const int fix = 12;
+    std::cout << std::setw(fix) << std::left << "CPU";
+    std::cout << std::setw(fix) << std::left << "x2APIC ID";
+    std::cout << std::setw(fix) << std::left << "Package";
+    std::cout << std::setw(fix) << std::left << "Die";
+    std::cout << std::setw(fix) << std::left << "Core";
+    std::cout << std::setw(fix) << std::left << "Thread";
+    std::cout << std::endl;
+    for (std::size_t i = 0; i != topo.cpus().size(); ++i) {
+        const LogicalCpu &cpu = topo.cpus()[i];
+        std::cout << std::setw(fix) << cpu.os_id;
+        std::cout << std::setw(fix) << hexnum(cpu.apic_id);
+        std::cout << std::setw(fix) << cpu.package;
+        std::cout << std::setw(fix) << cpu.die;
+        std::cout << std::setw(fix) << cpu.core;
+        std::cout << std::setw(fix) << cpu.thread;
+        std::cout << std::endl;
+    }
+    print_dash();
+
+    std::vector<unsigned> packages(topo.package_ids());
+    for (std::size_t i = 0; i != packages.size(); ++i) {
+        std::cout << "Package " << packages[i] << ": "
+                  << cpulist(topo.package_cpus(packages[i])) << std::endl;
+        std::vector<unsigned> dies(topo.die_ids(packages[i]));
+        for (std::size_t j = 0; j != dies.size(); ++j) {
+            std::cout << "    Die " << dies[j] << ": "
+                      << cpulist(topo.die_cpus(packages[i], dies[j]))
+                      << std::endl;
+        }
+    }
+    std::cout << "One thread per core: " << cpulist(topo.one_thread_per_core())
+              << std::endl;
+    print_dash();
+}
+
+inline void print_cache_domains(const Topology &topo)
+{
+    std::vector<CacheDomain> domains(cache_domains(topo));
+
+    print_section("Cache Sharing Domains");
+    const int fix = 12;
+    std::cout << std::setw(fix) << std::left << "Level";
+    std::cout << std::setw(fix) << std::left << "Type";
+    std::cout << std::setw(fix) << std::left << "Size";
+    std::cout << std::setw(fix) << std::left << "Cache ID";
+    std::cout << "CPUs" << std::endl;
+    for (std::size_t i = 0; i != domains.size(); ++i) {
+        std::cout << std::setw(fix) << domains[i].level;
+        std::cout << std::setw(fix) << domains[i].type;
+        std::cout << std::setw(fix) << bytes(domains[i].size);
+        std::cout << std::setw(fix) << hexnum(domains[i].id);
+        std::cout << domains[i].cpulist() << std::endl;
+    }
+    print_dash();
+
+    std::vector<CacheDomain> llc(last_level_cache_domains(topo));
+    std::cout << llc.size() << " last level cache domains:";
+    for (std::size_t i = 0; i != llc.size(); ++i)
+        std::cout << ' ' << llc[i].cpulist();
+    std::cout << std::endl;
+    print_dash();
+}
+
+inline void print_hybrid(const Topology &topo)
+{
+    std::vector<CoreClass> classes(core_classes(topo));
+
+    print_section("Hybrid Core Classes");
+    std::cout << "Hybrid: " << (is_hybrid(topo) ? "Yes" : "No") << std::endl;
+    print_dash();
+
+    const int fix = 16;
+    const int width = 24;
+    std::cout << std::setw(width) << std::left << "Core type";
+    for (std::size_t i = 0; i != classes.size(); ++i)
+        std::cout << std::setw(fix) << core_type_name(classes[i].type);
+    std::cout << std::endl;
+
+    std::cout << std::setw(width) << std::left << "Native model ID";
+    for (std::size_t i = 0; i != classes.size(); ++i)
+        std::cout << std::setw(fix) << hexnum(classes[i].native_model);
+    std::cout << std::endl;
+
+    std::cout << std::setw(width) << std::left << "Logical CPUs";
+    for (std::size_t i = 0; i != classes.size(); ++i)
+        std::cout << std::setw(fix) << classes[i].cpus.size();
+    std::cout << std::endl;
+
+    std::cout << std::setw(width) << std::left << "Base frequency (MHz)";
+    for (std::size_t i = 0; i != classes.size(); ++i)
+        std::cout << std::setw(fix) << classes[i].frequency.base;
+    std::cout << std::endl;
+
+    std::cout << std::setw(width) << std::left << "Max frequency (MHz)";
+    for (std::size_t i = 0; i != classes.size(); ++i)
+        std::cout << std::setw(fix) << classes[i].frequency.max;
+    std::cout << std::endl;
+
+    // One row per cache level and type, sizes shown with the number of
+    // logical CPUs sharing each instance
+    std::vector<CacheParam> rows;
+    for (std::size_t i = 0; i != classes.size(); ++i) {
+        for (std::size_t j = 0; j != classes[i].caches.size(); ++j) {
+            const CacheParam &cache = classes[i].caches[j];
+            std::size_t k = 0;
+            while (k != rows.size() && (rows[k].level() != cache.level() ||
+                                           rows[k].type() != cache.type()))
+                ++k;
+            if (k == rows.size())
+                rows.push_back(cache);
+        }
+    }
+    for (std::size_t k = 0; k != rows.size(); ++k) {
+        std::stringstream ss;
+        ss << "L" << rows[k].level() << " " << rows[k].type();
+        std::cout << std::setw(width) << std::left << ss.str();
+        for (std::size_t i = 0; i != classes.size(); ++i) {
+            std::stringstream size;
+            for (std::size_t j = 0; j != classes[i].caches.size(); ++j) {
+                const CacheParam &cache = classes[i].caches[j];
+                if (cache.level() == rows[k].level() &&
+                    cache.type() == rows[k].type())
+                    size << bytes(cache.size()) << " / "
+                         << cache.max_proc_sharing();
+            }
+            std::cout << std::setw(fix)
+                      << (size.str().empty() ? "-" : size.str());
+        }
+        std::cout << std::endl;
+    }
+    print_dash();
+
+    // Features not shared by every class
+    Features common;
+    Features any;
+    for (std::size_t i = 0; i != classes.size(); ++i) {
+        common = i == 0 ? classes[i].features : common & classes[i].features;
+        any |= classes[i].features;
+    }
+    std::cout << "ISA differences:";
+    bool differs = false;
+    for (unsigned f = 0; f != feature_count; ++f) {
+        Feature feat = static_cast<Feature>(f);
+        if (!any.has(feat) || common.has(feat))
+            continue;
+        differs = true;
+        std::cout << std::endl << std::setw(width) << feature_name(feat);
+        for (std::size_t i = 0; i != classes.size(); ++i)
+            std::cout << std::setw(fix)
+                      << (classes[i].features.has(feat) ? "Yes" : "No");
+    }
+    std::cout << (differs ? "" : " None") << std::endl;
+    print_dash();
+
+    for (std::size_t i = 0; i != classes.size(); ++i) {
+        std::cout << std::setw(width) << core_type_name(classes[i].type)
+                  << cpulist(classes[i].cpus) << std::endl;
+    }
+    std::cout << std::setw(width) << "Performance cores only"
+              << cpulist(performance_cpus(topo)) << std::endl;
+    print_dash();
+}
+
+inline void print_latency(std::size_t max_bytes)
+{
+    CpuInfo info;
+    const std::vector<CacheParam> &caches = info.caches();
+    std::size_t line_size = 64;
+    if (max_bytes == 0) {
+        max_bytes = std::size_t(256) << 20;
+        for (std::size_t i = 0; i != caches.size(); ++i) {
+            max_bytes = std::max(max_bytes, std::size_t(caches[i].size()) * 4);
+            line_size = caches[i].line_size();
+        }
+        max_bytes = std::min(max_bytes, std::size_t(1) << 30);
+    }
+
+    pin_this_thread(current_cpu());
+    LatencyLadder ladder(measure_latency(max_bytes, line_size));
+
+    std::stringstream title;
+    title << "Cache Latency Ladder (core clock " << std::fixed
+          << std::setprecision(2) << ladder.ghz << " GHz)";
+    print_section(title.str());
+
+    const int fix = 16;
+    std::cout << std::setw(fix) << std::left << "Working set";
+    std::cout << std::setw(fix) << std::right << "ns/load";
+    std::cout << std::setw(fix) << std::right << "cycles/load";
+    std::cout << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (std::size_t i = 0; i != ladder.points.size(); ++i) {
+        const LatencyPoint &point = ladder.points[i];
+        // Knees fall between two sizes, mark the larger one
+        std::size_t prev = i == 0 ? 0 : ladder.points[i - 1].bytes;
+        bool knee = false;
+        for (std::size_t k = 0; k != ladder.knees.size(); ++k)
+            knee = knee ||
+                (ladder.knees[k] > prev && ladder.knees[k] <= point.bytes);
+        std::cout << std::setw(fix) << std::left
+                  << format_bytes(static_cast<double>(point.bytes));
+        std::cout << std::setw(fix) << std::right << point.ns;
+        std::cout << std::setw(fix) << std::right << point.cycles;
+        std::cout << (knee ? "  <- knee" : "") << std::endl;
+    }
+    print_dash();
+
+    std::size_t largest =
+        ladder.points.empty() ? 0 : ladder.points.back().bytes;
+    std::vector<LatencyCheck> checks(
+        check_caches(caches, ladder.knees, largest));
+    std::cout << std::setw(fix) << std::left << "Cache level";
+    std::cout << std::setw(fix) << std::left << "Reported";
+    std::cout << std::setw(fix) << std::left << "Measured" << std::endl;
+    for (std::size_t i = 0; i != checks.size(); ++i) {
+        std::cout << std::setw(fix) << std::left << checks[i].level;
+        std::cout << std::setw(fix) << bytes(checks[i].reported);
+        std::string measured("-");
+        if (checks[i].measured != 0)
+            measured = format_bytes(static_cast<double>(checks[i].measured));
+        std::cout << std::setw(fix) << measured;
+        if (!checks[i].in_range)
+            std::cout << "not measured (above --max-size)" << std::endl;
+        else
+            std::cout << (checks[i].agree ? "OK" : "MISMATCH") << std::endl;
+    }
+    print_dash();
+    std::cout.unsetf(std::ios_base::floatfield);
+}
+
+inline void print_bandwidth_table(const BandwidthScaling &scaling)
+{
+    const int fix = 12;
+    std::cout << std::setw(fix) << std::left << "Threads";
+    for (unsigned k = 0; k != bandwidth_kernel_count; ++k) {
+        std::cout << std::setw(fix) << std::right
+                  << bandwidth_kernel_name(static_cast<BandwidthKernel>(k));
+    }
+    std::cout << std::endl;
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (std::size_t i = 0; i != scaling.samples.size(); ++i) {
+        std::cout << std::setw(fix) << std::left << scaling.samples[i].threads;
+        if (!scaling.samples[i].pinned) {
+            std::cout << "Cannot pin the threads, not measured" << std::endl;
+            continue;
+        }
+        for (unsigned k = 0; k != bandwidth_kernel_count; ++k)
+            std::cout << std::setw(fix) << std::right
+                      << scaling.samples[i].gbps[k];
+        std::cout << std::endl;
+    }
+    std::cout.unsetf(std::ios_base::floatfield);
+}
+
+inline void print_saturation(
+    const std::string &domain, const BandwidthScaling &scaling)
+{
+    const int fix = 12;
+    std::cout << std::setw(24) << std::left << domain;
+    std::cout << std::setw(16) << std::left << cpulist(scaling.cpus);
+    for (std::size_t i = 0; i != scaling.samples.size(); ++i) {
+        if (!scaling.samples[i].pinned) {
+            std::cout << "Cannot pin the threads, not measured" << std::endl;
+            return;
+        }
+    }
+    std::cout << std::fixed << std::setprecision(1);
+    const BandwidthKernel kernels[] = {BandwidthKernel::Read,
+        BandwidthKernel::Copy, BandwidthKernel::Triad};
+    for (std::size_t k = 0; k != 3; ++k) {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1)
+           << peak_gbps(scaling, kernels[k]) << "@"
+           << saturation_threads(scaling, kernels[k]);
+        std::cout << std::setw(fix) << std::right << ss.str();
+    }
+    std::cout << std::endl;
+    std::cout.unsetf(std::ios_base::floatfield);
+}
+
+inline void print_bandwidth(std::size_t bytes)
+{
+    Topology topo(Topology::enumerate());
+    std::vector<CacheDomain> llc(last_level_cache_domains(topo));
+    if (bytes == 0) {
+        for (std::size_t i = 0; i != llc.size(); ++i)
+            bytes += std::size_t(llc[i].size) * 4;
+        bytes = std::min(
+            std::max(bytes, std::size_t(64) << 20), std::size_t(1) << 30);
+    }
+    SimdLevel simd = select_simd(this_cpu().features());
+
+    // Spread threads over the last level caches, cores before SMT siblings
+    std::vector<std::vector<int> > domains;
+    for (std::size_t i = 0; i != llc.size(); ++i)
+        domains.push_back(topo.cores_first(llc[i].cpus));
+    std::vector<int> spread;
+    for (std::size_t j = 0; !domains.empty() && spread.size() != topo.threads();
+         ++j) {
+        std::size_t added = 0;
+        for (std::size_t i = 0; i != domains.size(); ++i) {
+            if (j < domains[i].size()) {
+                spread.push_back(domains[i][j]);
+                ++added;
+            }
+        }
+        if (added == 0)
+            break;
+    }
+    // Without cache leaves, e.g. in some VMs, there are no domains
+    if (spread.empty())
+        spread = topo.cores_first(allowed_cpus());
+
+    std::stringstream title;
+    title << "Memory Bandwidth (GB/s, " << simd_name(simd) << " kernels, "
+          << format_bytes(static_cast<double>(bytes)) << " per array)";
+    print_section(title.str());
+    BandwidthScaling system(measure_bandwidth(
+        spread, scaling_steps(static_cast<unsigned>(spread.size())), simd,
+        bytes));
+    print_bandwidth_table(system);
+    print_dash();
+
+    std::cout << std::setw(24) << std::left << "Domain";
+    std::cout << std::setw(16) << std::left << "CPUs";
+    std::cout << std::setw(12) << std::right << "Read";
+    std::cout << std::setw(12) << std::right << "Copy";
+    std::cout << std::setw(12) << std::right << "Triad" << std::endl;
+    std::cout << "(peak GB/s @ threads reaching 95% of the peak)" << std::endl;
+    print_saturation("System", system);
+
+    std::vector<NumaNode> nodes(numa_nodes());
+    for (std::size_t i = 0; i != nodes.size(); ++i) {
+        std::vector<int> cpus(topo.cores_first(nodes[i].cpus));
+        std::stringstream name;
+        name << "NUMA node " << nodes[i].id;
+        print_saturation(name.str(),
+            measure_bandwidth(cpus,
+                scaling_steps(static_cast<unsigned>(cpus.size())), simd,
+                bytes));
+    }
+    for (std::size_t i = 0; i != llc.size(); ++i) {
+        std::stringstream name;
+        name << "L" << llc[i].level << " " << hexnum(llc[i].id);
+        print_saturation(name.str(),
+            measure_bandwidth(domains[i],
+                scaling_steps(static_cast<unsigned>(domains[i].size())),
+                simd, bytes));
+    }
+    print_dash();
+}
+
+inline void print_pingpong(bool serial)
+{
+    Topology topo(Topology::enumerate());
+    std::vector<CacheDomain> llc(last_level_cache_domains(topo));
+    std::vector<int> cpus;
+    for (std::size_t i = 0; i != topo.cpus().size(); ++i)
+        cpus.push_back(topo.cpus()[i].os_id);
+
+    std::stringstream title;
+    title << "Core-to-Core Latency (ns per round trip, "
+          << (serial ? "one pair at a time)" : "disjoint pairs concurrently)");
+    print_section(title.str());
+    if (cpus.size() < 2) {
+        std::cout << "Fewer than two logical CPUs available" << std::endl;
+        print_dash();
+        return;
+    }
+    PingPongMatrix matrix(measure_pingpong(cpus, 1000, !serial));
+
+    // Where each CPU sits, from the x2APIC leaves and leaf 0x04
+    const int fix = 10;
+    std::cout << std::setw(fix) << std::left << "CPU";
+    std::cout << std::setw(fix) << std::left << "APIC ID";
+    std::cout << std::setw(fix) << std::left << "Package";
+    std::cout << std::setw(fix) << std::left << "Die";
+    std::cout << std::setw(fix) << std::left << "Core";
+    std::cout << std::setw(fix) << std::left << "Thread";
+    std::cout << "Last level cache" << std::endl;
+    for (std::size_t i = 0; i != topo.cpus().size(); ++i) {
+        const LogicalCpu &cpu = topo.cpus()[i];
+        std::cout << std::setw(fix) << std::left << cpu.os_id;
+        std::cout << std::setw(fix) << std::left << hexnum(cpu.apic_id);
+        std::cout << std::setw(fix) << std::left << cpu.package;
+        std::cout << std::setw(fix) << std::left << cpu.die;
+        std::cout << std::setw(fix) << std::left << cpu.core;
+        std::cout << std::setw(fix) << std::left << cpu.thread;
+        for (std::size_t j = 0; j != llc.size(); ++j) {
+            if (std::find(llc[j].cpus.begin(), llc[j].cpus.end(),
+                    cpu.os_id) != llc[j].cpus.end())
+                std::cout << "L" << llc[j].level << " " << hexnum(llc[j].id)
+                          << " (" << bytes(llc[j].size) << ")";
+        }
+        std::cout << std::endl;
+    }
+    print_dash();
+
+    const int cell = 6;
+    std::cout << std::setw(cell) << std::left << "CPU";
+    for (std::size_t j = 0; j != cpus.size(); ++j)
+        std::cout << std::setw(cell) << std::right << cpus[j];
+    std::cout << std::endl;
+    std::cout << std::fixed << std::setprecision(0);
+    for (std::size_t i = 0; i != cpus.size(); ++i) {
+        std::cout << std::setw(cell) << std::left << cpus[i];
+        for (std::size_t j = 0; j != cpus.size(); ++j) {
+            if (i == j)
+                std::cout << std::setw(cell) << std::right << "-";
+            else if (!matrix.measured(i, j))
+                std::cout << std::setw(cell) << std::right << "?";
+            else
+                std::cout << std::setw(cell) << std::right << matrix.at(i, j);
+        }
+        std::cout << std::endl;
+    }
+    std::vector<int> unpinned;
+    for (std::size_t i = 0; i != cpus.size(); ++i)
+        if (!matrix.pinned[i])
+            unpinned.push_back(cpus[i]);
+    if (!unpinned.empty())
+        std::cout << "Cannot pin to CPUs " << cpulist(unpinned)
+                  << ", their pairs (?) are not measured" << std::endl;
+    print_dash();
+
+    std::cout << std::setw(16) << std::left << "Pair class";
+    std::cout << std::setw(fix) << std::right << "Pairs";
+    std::cout << std::setw(fix) << std::right << "Min";
+    std::cout << std::setw(fix) << std::right << "Avg";
+    std::cout << std::setw(fix) << std::right << "Max" << std::endl;
+    std::cout << std::setprecision(1);
+    for (unsigned c = 0; c != pair_class_count; ++c) {
+        PairClass cls = static_cast<PairClass>(c);
+        PairSummary summary(summarize_pairs(matrix, topo, llc, cls));
+        std::cout << std::setw(16) << std::left << pair_class_name(cls);
+        std::cout << std::setw(fix) << std::right << summary.pairs;
+        if (summary.pairs == 0) {
+            std::cout << std::setw(fix) << std::right << "-";
+            std::cout << std::setw(fix) << std::right << "-";
+            std::cout << std::setw(fix) << std::right << "-";
+        } else {
+            std::cout << std::setw(fix) << std::right << summary.min_ns;
+            std::cout << std::setw(fix) << std::right << summary.avg_ns;
+            std::cout << std::setw(fix) << std::right << summary.max_ns;
+        }
+        std::cout << std::endl;
+    }
+    print_dash();
+    std::cout.unsetf(std::ios_base::floatfield);
+}
+
+inline void print_tlb_reach(std::size_t max_bytes)
+{
+    if (max_bytes == 0)
+        max_bytes = std::size_t(1) << 30;
+    const CpuInfo &info = this_cpu();
+    const std::vector<TlbParam> &tlbs = info.tlbs();
+
+    pin_this_thread(current_cpu());
+    double ghz = core_ghz();
+
+    std::stringstream title;
+    title << "TLB Reach (ns per 4K page touched, core clock " << std::fixed
+          << std::setprecision(2) << ghz << " GHz)";
+    print_section(title.str());
+
+    // Data and unified TLBs and the memory each covers
+    const int fix = 16;
+    std::cout << std::setw(fix) << std::left << "TLB";
+    std::cout << std::setw(fix) << std::left << "Page sizes";
+    std::cout << std::setw(fix) << std::right << "Entries";
+    std::cout << std::setw(fix) << std::right << "Reach" << std::endl;
+    for (std::size_t i = 0; i != tlbs.size(); ++i) {
+        if (tlbs[i].type == "Instruction")
+            continue;
+        std::stringstream name;
+        name << "L" << tlbs[i].level << " " << tlbs[i].type;
+        std::cout << std::setw(fix) << std::left << name.str();
+        std::cout << std::setw(fix) << std::left
+                  << tlb_page_names(tlbs[i].pages);
+        std::cout << std::setw(fix) << std::right << tlbs[i].entries;
+
+        // Reach with the largest page size the TLB holds
+        double page = 4096;
+        if (tlbs[i].pages & TlbPage1G)
+            page = 1024.0 * 1024 * 1024;
+        else if (tlbs[i].pages & TlbPage4M)
+            page = 4.0 * 1024 * 1024;
+        else if (tlbs[i].pages & TlbPage2M)
+            page = 2.0 * 1024 * 1024;
+        std::cout << std::setw(fix) << std::right
+                  << format_bytes(page * tlbs[i].entries) << std::endl;
+    }
+    print_dash();
+
+    // 2M pages from the hugetlb pool, else transparent huge pages; 1G pages
+    // need GBPAGES and a reserved 1G pool
+    std::vector<std::string> names;
+    std::vector<std::vector<LatencyPoint> > sweeps;
+    names.push_back("4K");
+    sweeps.push_back(measure_tlb_reach(PageSize::Small, max_bytes, ghz));
+    names.push_back("2M");
+    sweeps.push_back(measure_tlb_reach(PageSize::Huge2M, max_bytes, ghz));
+    if (sweeps.back().empty()) {
+        names.back() = "2M (THP)";
+        sweeps.back() =
+            measure_tlb_reach(PageSize::Transparent, max_bytes, ghz);
+    }
+    names.push_back("1G");
+    if (info.features().has(Feature::GBPAGES))
+        sweeps.push_back(measure_tlb_reach(PageSize::Huge1G, max_bytes, ghz));
+    else
+        sweeps.push_back(std::vector<LatencyPoint>());
+
+    std::cout << std::setw(fix) << std::left << "Working set";
+    for (std::size_t k = 0; k != names.size(); ++k)
+        std::cout << std::setw(fix) << std::right << names[k];
+    std::cout << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (std::size_t i = 0; i != sweeps[0].size(); ++i) {
+        std::cout << std::setw(fix) << std::left
+                  << format_bytes(static_cast<double>(sweeps[0][i].bytes));
+        for (std::size_t k = 0; k != sweeps.size(); ++k) {
+            if (i < sweeps[k].size())
+                std::cout << std::setw(fix) << std::right << sweeps[k][i].ns;
+            else
+                std::cout << std::setw(fix) << std::right << "-";
+        }
+        std::cout << std::endl;
+    }
+    if (!info.features().has(Feature::GBPAGES))
+        std::cout << "1G pages are not supported (GBPAGES)" << std::endl;
+    else if (sweeps.back().empty())
+        std::cout << "1G pages are not available, reserve them in "
+                  << "/sys/kernel/mm/hugepages/hugepages-1048576kB"
+                  << std::endl;
+    print_dash();
+    std::cout.unsetf(std::ios_base::floatfield);
+}
+
+inline void print_fma(bool all_cores)
+{
+    const CpuInfo &info = this_cpu();
+    std::vector<int> cpus(1, current_cpu());
+    if (all_cores)
+        cpus = allowed_cpus();
+
+    std::stringstream title;
+    title << "FMA Throughput and Frequency License (" << cpus.size()
+          << (cpus.size() == 1 ? " thread)" : " threads at once)");
+    print_section(title.str());
+    if (!fma_width_supported(FmaWidth::Scalar, info.features())) {
+        std::cout << "FMA is not supported" << std::endl;
+        print_dash();
+        return;
+    }
+
+    // FLOP/cycle is per thread, so SMT siblings share the FMA ports
+    const int fix = 16;
+    std::cout << std::setw(fix) << std::left << "Width";
+    std::cout << std::setw(fix) << std::right << "GFLOP/s";
+    std::cout << std::setw(fix) << std::right << "GHz";
+    std::cout << std::setw(fix) << std::right << "FLOP/cycle" << std::endl;
+    std::vector<FmaSample> samples;
+    std::cout << std::fixed << std::setprecision(2);
+    for (unsigned w = 0; w != fma_width_count; ++w) {
+        FmaWidth width = static_cast<FmaWidth>(w);
+        if (!fma_width_supported(width, info.features()))
+            continue;
+        samples.push_back(measure_fma(cpus, width));
+        const FmaSample &sample = samples.back();
+        std::cout << std::setw(fix) << std::left << fma_width_name(width);
+        if (!sample.pinned) {
+            std::cout << "Cannot pin the threads, not measured" << std::endl;
+            continue;
+        }
+        std::cout << std::setw(fix) << std::right << sample.gflops;
+        std::cout << std::setw(fix) << std::right << sample.ghz;
+        std::cout << std::setw(fix) << std::right
+                  << sample.gflops / sample.threads / sample.ghz << std::endl;
+    }
+    print_dash();
+
+    // Transitions are timed on one core, the others idle
+    pin_this_thread(current_cpu());
+    std::cout << std::setw(fix) << std::left << "License";
+    std::cout << std::setw(fix) << std::right << "Scalar GHz";
+    std::cout << std::setw(fix) << std::right << "Loaded GHz";
+    std::cout << std::setw(fix) << std::right << "Enter us";
+    std::cout << std::setw(fix) << std::right << "Exit us" << std::endl;
+    for (std::size_t i = 1; i != samples.size(); ++i) {
+        LicenseTransition transition(
+            measure_license_transition(samples[i].width));
+        std::cout << std::setw(fix) << std::left
+                  << fma_width_name(transition.width);
+        std::cout << std::setw(fix) << std::right << transition.base_ghz;
+        std::cout << std::setw(fix) << std::right << transition.heavy_ghz;
+        std::cout << std::setw(fix) << std::right << transition.enter_us;
+        std::cout << std::setw(fix) << std::right << transition.exit_us;
+        std::cout << std::endl;
+    }
+    print_dash();
+
+    if (samples.size() != fma_width_count) {
+        std::cout << "AVX-512 is not supported, no 512-bit code to compare"
+                  << std::endl;
+    } else if (!samples[1].pinned || !samples[2].pinned) {
+        std::cout << "Cannot pin the threads, no 512-bit code to compare"
+                  << std::endl;
+    } else {
+        WideVerdict verdict(wide_vector_verdict(samples[1], samples[2]));
+        std::cout << "AVX-512 over AVX2: " << verdict.speedup
+                  << "x the FLOP/s at " << verdict.clock_ratio
+                  << "x the clock" << std::endl;
+        if (verdict.break_even >= 1)
+            std::cout << "512-bit code never pays off";
+        else
+            std::cout << "512-bit code pays off when vector loops take over "
+                      << std::setprecision(0) << verdict.break_even * 100
+                      << "% of the run time";
+        std::cout << ": " << (verdict.net_win ? "net win" : "not a net win")
+                  << ", prefer -mprefer-vector-width="
+                  << (verdict.net_win ? 512 : 256) << std::endl;
+    }
+    print_dash();
+    std::cout.unsetf(std::ios_base::floatfield);
+}
+
+inline void print_dot()
+{
+    const CpuInfo &info = this_cpu();
+    pin_this_thread(current_cpu());
+    print_section("Dot Product Throughput (1 thread)");
+
+    const int fix = 16;
+    std::cout << std::setw(fix) << std::left << "Kernel";
+    std::cout << std::setw(fix) << std::left << "Inputs";
+    std::cout << std::setw(fix) << std::right << "GOPS" << std::endl;
+    DotSample best[2] = {};
+    std::cout << std::fixed << std::setprecision(1);
+    for (unsigned k = 0; k != dot_kernel_count; ++k) {
+        DotKernel kernel = static_cast<DotKernel>(k);
+        if (!dot_kernel_supported(kernel, info.features()))
+            continue;
+        DotSample sample(measure_dot(kernel));
+        DotType type = dot_kernel_type(kernel);
+        std::cout << std::setw(fix) << std::left << dot_kernel_name(kernel);
+        std::cout << std::setw(fix) << std::left << dot_type_name(type);
+        if (!sample.ok) {
+            std::cout << std::setw(fix) << std::right << "-"
+                      << "  (not enabled by the OS)" << std::endl;
+            continue;
+        }
+        std::cout << std::setw(fix) << std::right << sample.gops << std::endl;
+        DotSample &prev = best[type == DotType::Int8 ? 0 : 1];
+        if (sample.gops > prev.gops)
+            prev = sample;
+    }
+    print_dash();
+
+    const DotType types[2] = {DotType::Int8, DotType::Bf16};
+    for (unsigned t = 0; t != 2; ++t) {
+        std::cout << std::setw(fix) << std::left
+                  << (std::string(dot_type_name(types[t])) + " path:");
+        if (best[t].gops > 0)
+            std::cout << dot_kernel_name(best[t].kernel) << std::endl;
+        else
+            std::cout << "(none, no dot product instructions)" << std::endl;
+    }
+    print_dash();
+    std::cout.unsetf(std::ios_base::floatfield);
+}
+
+inline void print_tsc()
+{
+    const CpuInfo &info = this_cpu();
+    TscInfo tsc(tsc_info(info));
+    pin_this_thread(current_cpu());
+
+    print_section("Time Stamp Counter");
+    const int width = 30;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << std::setw(width) << std::left << "CPUID frequency:";
+    if (tsc.hz != 0)
+        std::cout << tsc.hz / 1e6 << " MHz (" << tsc_source_name(tsc.source)
+                  << ")" << std::endl;
+    else
+        std::cout << "Not enumerated" << std::endl;
+
+    bench_clock::time_point start = bench_clock::now();
+    double calibrated = calibrate_tsc_hz();
+    double ms = elapsed_ns(start) / 1e6;
+    std::cout << std::setw(width) << std::left << "Calibrated frequency:";
+    std::cout << calibrated / 1e6 << " MHz in " << std::setprecision(1) << ms
+              << " ms" << std::endl;
+    if (tsc.hz != 0) {
+        std::cout << std::setw(width) << std::left << "Difference:";
+        std::cout << (calibrated - tsc.hz) / tsc.hz * 1e6 << " ppm"
+                  << std::endl;
+    }
+    if (!tsc.invariant)
+        std::cout << "The TSC is not invariant, its rate follows the clock"
+                  << std::endl;
+    print_dash();
+
+    TscClock clock(tsc.hz != 0 ? tsc.hz : calibrated);
+    std::vector<TimerCost> costs(measure_timer_costs(clock, tsc.rdtscp));
+    const int fix = 24;
+    std::cout << std::setw(fix) << std::left << "Time source";
+    std::cout << std::setw(fix) << std::right << "ns/read" << std::endl;
+    std::cout << std::setprecision(2);
+    for (std::size_t i = 0; i != costs.size(); ++i) {
+        std::cout << std::setw(fix) << std::left << costs[i].name;
+        std::cout << std::setw(fix) << std::right << costs[i].ns << std::endl;
+    }
+    print_dash();
+    std::cout.unsetf(std::ios_base::floatfield);
+}
+
+// Schemata for a latency-critical group under `root`, from the mounted
+// resctrl file system or else from CPUID and the topology
+inline bool print_resctrl(const CpuInfo &info, const Topology &topo,
+    const std::string &root, unsigned ways, unsigned mba_percent, bool apply)
+{
+    RdtInfo rdt(rdt_info(info.snapshot()));
+    ResctrlLayout layout;
+    if (!read_resctrl_layout(root, rdt, layout))
+        layout = resctrl_layout(rdt, topo);
+
+    print_section("Resource Control (resctrl)");
+    const int width = 30;
+    std::cout << std::setw(width) << std::left << "Layout:";
+    std::cout << (layout.mounted ? "Mounted at " : "CPUID, not mounted at ")
+              << root << std::endl;
+    print_dash();
+
+    const int fix = 16;
+    std::cout << std::setw(fix) << std::left << "Resource";
+    std::cout << std::setw(fix) << std::right << "Domains";
+    std::cout << std::setw(fix) << std::right << "Mask bits";
+    std::cout << std::setw(fix) << std::right << "Shareable";
+    std::cout << std::setw(fix) << std::right << "Minimum";
+    std::cout << std::setw(fix) << std::right << "Granularity" << std::endl;
+    for (std::size_t i = 0; i != layout.resources.size(); ++i) {
+        const ResctrlResource &resource = layout.resources[i];
+        std::cout << std::setw(fix) << std::left << resource.name;
+        std::cout << std::setw(fix) << std::right << resource.domains.size();
+        if (resource.cache()) {
+            std::cout << std::setw(fix) << std::right << resource.cbm_length;
+            std::cout << std::setw(fix) << std::right
+                      << hexnum(resource.shareable_mask);
+            std::cout << std::setw(fix) << std::right
+                      << resource.min_cbm_bits;
+            std::cout << std::setw(fix) << std::right << "-";
+        } else {
+            std::cout << std::setw(fix) << std::right << "-";
+            std::cout << std::setw(fix) << std::right << "-";
+            std::cout << std::setw(fix) << std::right
+                      << resource.min_bandwidth;
+            std::cout << std::setw(fix) << std::right
+                      << resource.bandwidth_gran;
+        }
+        std::cout << std::endl;
+    }
+    if (layout.resources.empty())
+        std::cout << "(none, no cache or bandwidth allocation)" << std::endl;
+    print_dash();
+
+    ResctrlPlan plan;
+    if (!plan_resctrl(layout, ways, mba_percent, plan)) {
+        std::cerr << "Cannot reserve " << ways << " L3 ways and "
+                  << mba_percent << "% memory bandwidth with this layout"
+                  << std::endl;
+        return false;
+    }
+    const std::string group("critical");
+    std::cout << root << "/" << group << "/schemata:" << std::endl;
+    std::cout << plan.critical;
+    std::cout << root << "/schemata:" << std::endl;
+    std::cout << plan.batch;
+    print_dash();
+
+    if (apply) {
+        if (!apply_resctrl(root, group, plan)) {
+            std::cerr << "Cannot write the schemata under " << root
+                      << ", see " << root << "/info/last_cmd_status"
+                      << std::endl;
+            return false;
+        }
+        std::cout << "Written; move tasks with echo PID > " << root << "/"
+                  << group << "/tasks" << std::endl;
+        print_dash();
+    }
+
+    return true;
+}
+
+inline void print_vm_exits()
+{
+    const CpuInfo &info = this_cpu();
+    HypervisorInfo hv(hypervisor_info(info.snapshot()));
+    pin_this_thread(current_cpu());
+
+    print_section("VM Exit Cost");
+    const int width = 30;
+    std::cout << std::setw(width) << std::left << "Hypervisor:";
+    std::cout << hypervisor_name(hv.vendor) << std::endl;
+    print_dash();
+
+    std::vector<ExitCost> costs(measure_exit_costs(
+        info.features().has(Feature::RDTSCP),
+        info.features().has(Feature::RDPID)));
+    const int fix = 16;
+    std::cout << std::setw(fix) << std::left << "Instruction";
+    std::cout << std::setw(fix) << std::right << "ns";
+    std::cout << std::setw(fix) << std::right << "Likely exit" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::string exits;
+    for (std::size_t i = 0; i != costs.size(); ++i) {
+        std::cout << std::setw(fix) << std::left << costs[i].name;
+        std::cout << std::setw(fix) << std::right << costs[i].ns;
+        std::cout << std::setw(fix) << std::right
+                  << (costs[i].likely_exit ? "Yes" : "No") << std::endl;
+        if (costs[i].likely_exit)
+            exits += std::string(" ") + costs[i].name;
+    }
+    print_dash();
+    std::cout.unsetf(std::ios_base::floatfield);
+
+    std::cout << std::setw(width) << std::left << "Keep off hot paths:";
+    std::cout << (exits.empty() ? std::string("(none)") : exits.substr(1))
+              << std::endl;
+    print_dash();
+}
+
+// Control names separated by spaces, "(none)" if empty
+inline std::string feature_list(const std::vector<Feature> &features)
+{
+    std::string list;
+    for (std::size_t i = 0; i != features.size(); ++i)
+        list += std::string(" ") + feature_name(features[i]);
+
+    return list.empty() ? std::string("(none)") : list.substr(1);
+}
+
+inline void print_mitigations()
+{
+    const CpuInfo &info = this_cpu();
+    int cpu = current_cpu();
+    pin_this_thread(cpu);
+
+    print_section("Speculation Mitigations");
+    const int width = 30;
+    std::cout << std::setw(width) << std::left << "CPU controls:";
+    std::cout << feature_list(speculation_controls(info.features()))
+              << std::endl;
+    std::vector<std::string> options(mitigation_options());
+    std::cout << std::setw(width) << std::left << "Kernel options:";
+    for (std::size_t i = 0; i != options.size(); ++i)
+        std::cout << (i == 0 ? "" : " ") << options[i];
+    std::cout << (options.empty() ? "(defaults)" : "") << std::endl;
+    print_dash();
+
+    std::vector<Vulnerability> vulns(read_vulnerabilities(info.features()));
+    for (std::size_t i = 0; i != vulns.size(); ++i) {
+        std::cout << std::setw(width) << std::left << vulns[i].name + ":";
+        std::cout << vulns[i].status << std::endl;
+        if (!vulns[i].controls.empty()) {
+            std::cout << std::setw(width) << std::left << "";
+            std::cout << "Controls: " << feature_list(vulns[i].controls)
+                      << std::endl;
+        }
+    }
+    if (vulns.empty())
+        std::cout << "(no /sys/devices/system/cpu/vulnerabilities)"
+                  << std::endl;
+    print_dash();
+
+    const int fix = 24;
+    std::cout << std::setw(fix) << std::left << "Kernel operation";
+    std::cout << std::setw(fix) << std::right << "ns" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::setw(fix) << std::left << "syscall round trip";
+    std::cout << std::setw(fix) << std::right << measure_syscall_ns()
+              << std::endl;
+    std::cout << std::setw(fix) << std::left << "context switch";
+    double switch_ns = measure_context_switch_ns(cpu);
+    if (switch_ns > 0)
+        std::cout << std::setw(fix) << std::right << switch_ns << std::endl;
+    else
+        std::cout << std::setw(fix) << std::right << "(cannot pin)"
+                  << std::endl;
+    std::cout << std::setw(fix) << std::left << "page fault (4 KiB)";
+    std::cout << std::setw(fix) << std::right << measure_page_fault_ns()
+              << std::endl;
+    print_dash();
+    std::cout.unsetf(std::ios_base::floatfield);
+}
+
+// Per-CPU clock and C0 residency every `interval_ms` for `intervals`
+// intervals, then the clock by the number of busy CPUs
+inline bool print_monitor(unsigned interval_ms, unsigned intervals)
+{
+    const CpuInfo &info = this_cpu();
+    std::vector<int> cpus(allowed_cpus());
+    FrequencyMonitor monitor(cpus, tsc_hz(info));
+
+    print_section("Effective Frequency");
+    const int width = 30;
+    std::cout << std::setw(width) << std::left << "Counters:";
+    std::cout << counter_source_name(monitor.source()) << std::endl;
+    std::cout << std::setw(width) << std::left << "APERF/MPERF (leaf 0x06):";
+    std::cout << (test_bit(info.snapshot().get(0x06).ecx, 0) ? "Yes" : "No")
+              << std::endl;
+    if (info.frequency().base != 0) {
+        std::cout << std::setw(width) << std::left << "Base / maximum:";
+        std::cout << info.frequency().base << " / " << info.frequency().max
+                  << " MHz" << std::endl;
+    }
+    std::cout << std::setw(width) << std::left << "Sampling:";
+    std::cout << intervals << " x " << interval_ms << " ms on " << cpus.size()
+              << " CPUs" << std::endl;
+    print_dash();
+
+    if (!monitor.start(interval_ms)) {
+        std::cerr << "Cannot read cycle counters: " << monitor.error()
+                  << std::endl;
+        return false;
+    }
+
+    const int fix = 16;
+    std::cout << std::setw(fix) << std::left << "Time s";
+    std::cout << std::setw(fix) << std::right << "CPU";
+    std::cout << std::setw(fix) << std::right << "MHz";
+    std::cout << std::setw(fix) << std::right << "C0 %" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::vector<FrequencySample> samples;
+    std::vector<FrequencySample> batch;
+    // A few intervals of grace in case the sampler cannot read any CPU
+    unsigned done = 0;
+    for (unsigned waited = 0; done < intervals && waited < intervals + 3;
+         ++waited) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+        batch.clear();
+        monitor.drain(batch);
+        for (std::size_t i = 0; i != batch.size(); ++i) {
+            const FrequencySample &sample = batch[i];
+            if (sample.interval >= intervals)
+                break;
+            done = sample.interval + 1;
+            samples.push_back(sample);
+            // Idle CPUs would drown the busy ones
+            if (sample.c0 < 0.01)
+                continue;
+            std::cout << std::setw(fix) << std::left << sample.seconds;
+            std::cout << std::setw(fix) << std::right << sample.cpu;
+            std::cout << std::setw(fix) << std::right << sample.mhz;
+            std::cout << std::setw(fix) << std::right << sample.c0 * 100
+                      << std::endl;
+        }
+    }
+    monitor.stop();
+    print_dash();
+    if (monitor.dropped() != 0) {
+        std::cout << std::setw(width) << std::left << "Dropped samples:";
+        std::cout << monitor.dropped() << std::endl;
+        print_dash();
+    }
+
+    std::vector<TurboStep> steps(turbo_steps(samples));
+    std::cout << std::setw(fix) << std::left << "Busy CPUs";
+    std::cout << std::setw(fix) << std::right << "Intervals";
+    std::cout << std::setw(fix) << std::right << "MHz";
+    std::cout << std::setw(fix) << std::right << "vs fewest %" << std::endl;
+    for (std::size_t i = 0; i != steps.size(); ++i) {
+        std::cout << std::setw(fix) << std::left << steps[i].active;
+        std::cout << std::setw(fix) << std::right << steps[i].intervals;
+        std::cout << std::setw(fix) << std::right << steps[i].mhz;
+        std::cout << std::setw(fix) << std::right
+                  << (steps[i].mhz / steps[0].mhz - 1) * 100 << std::endl;
+    }
+    if (steps.empty())
+        std::cout << "(no CPU was in C0 for half an interval)" << std::endl;
+    print_dash();
+    std::cout.unsetf(std::ios_base::floatfield);
+
+    return true;
+}
+
+// One line per cache, e.g. "L1d 48K/12 L1i 32K/8 L2 2M/16"
+inline std::string cache_config(const CpuInfo &info)
+{
+    std::stringstream ss;
+    const std::vector<CacheParam> &caches = info.caches();
+    for (std::size_t i = 0; i != caches.size(); ++i) {
+        const std::string &type = caches[i].type();
+        ss << (i == 0 ? "L" : " L") << caches[i].level();
+        if (type == "Data")
+            ss << 'd';
+        else if (type == "Instruction")
+            ss << 'i';
+        ss << ' ' << bytes(caches[i].size()) << '/' << caches[i].ways();
+    }
+
+    return caches.empty() ? std::string("(none)") : ss.str();
+}
+
+template <typename Key>
+inline bool more_hosts(const std::pair<Key, unsigned long long> &a,
+    const std::pair<Key, unsigned long long> &b)
+{
+    return a.second > b.second;
+}
+
+// Count the distinct hosts of groups with equal keys (one per group),
+// most hosts first; a hybrid host has a group per core type and counts once
+template <typename Key>
+inline std::vector<std::pair<Key, unsigned long long> > count_hosts(
+    const std::vector<Key> &keys, const std::vector<FleetMix> &mixes)
+{
+    std::vector<std::pair<Key, unsigned long long> > counts;
+    std::vector<std::size_t> slot;
+    for (std::size_t i = 0; i != keys.size(); ++i) {
+        std::size_t j = 0;
+        while (j != counts.size() && counts[j].first != keys[i])
+            ++j;
+        if (j == counts.size())
+            counts.push_back(std::make_pair(keys[i], 0ULL));
+        slot.push_back(j);
+    }
+
+    std::vector<bool> counted;
+    for (std::size_t m = 0; m != mixes.size(); ++m) {
+        counted.assign(counts.size(), false);
+        const std::vector<std::size_t> &groups = mixes[m].groups;
+        for (std::size_t g = 0; g != groups.size(); ++g) {
+            std::size_t j = slot[groups[g]];
+            if (!counted[j])
+                counts[j].second += mixes[m].hosts;
+            counted[j] = true;
+        }
+    }
+    std::stable_sort(counts.begin(), counts.end(), more_hosts<Key>);
+
+    return counts;
+}
+
+inline void print_fleet(const FleetSummary &fleet, double ms)
 {
+    const std::vector<FleetGroup> &groups = fleet.groups;
+    std::vector<CpuInfo> infos;
+    for (std::size_t i = 0; i != groups.size(); ++i)
+        infos.push_back(CpuInfo(groups[i].snapshot));
+
+    print_section("Fleet");
+    std::cout << fleet.files << " files, " << fleet.hosts << " hosts, "
+              << groups.size() << " distinct CPU types, " << fleet.failed
+              << " unreadable (ingested in " << std::fixed
+              << std::setprecision(3) << ms << " ms)" << std::endl;
+    print_dash();
+
+    const int fix = 10;
+    std::cout << std::setw(fix) << std::left << "Hosts";
+    std::cout << std::setw(16) << std::left << "Vendor";
+    std::cout << std::setw(fix) << std::left << "Family";
+    std::cout << std::setw(fix) << std::left << "Model";
+    std::cout << std::setw(fix) << std::left << "Stepping";
+    std::cout << "Brand" << std::endl;
+    for (std::size_t i = 0; i != groups.size(); ++i) {
+        Signature sig(infos[i].signature());
+        std::cout << std::setw(fix) << groups[i].hosts;
+        std::cout << std::setw(16) << infos[i].vendor();
+        std::cout << std::setw(fix) << hexnum(sig.family);
+        std::cout << std::setw(fix) << hexnum(sig.model);
+        std::cout << std::setw(fix) << sig.stepping;
+        std::cout << infos[i].brand() << std::endl;
+    }
+    print_dash();
+
+    std::vector<std::string> configs;
+    for (std::size_t i = 0; i != infos.size(); ++i)
+        configs.push_back(cache_config(infos[i]));
+    std::vector<std::pair<std::string, unsigned long long> > by_cache(
+        count_hosts(configs, fleet.mixes));
+    std::cout << std::setw(fix) << std::left << "Hosts";
+    std::cout << "Cache configuration (size/ways)" << std::endl;
+    for (std::size_t i = 0; i != by_cache.size(); ++i) {
+        std::cout << std::setw(fix) << by_cache[i].second;
+        std::cout << by_cache[i].first << std::endl;
+    }
+    print_dash();
+
+    std::vector<Features> sets;
+    for (std::size_t i = 0; i != infos.size(); ++i)
+        sets.push_back(infos[i].features());
+    std::vector<std::pair<Features, unsigned long long> > by_features(
+        count_hosts(sets, fleet.mixes));
+    std::cout << std::setw(fix) << std::left << "Hosts";
+    std::cout << "Features beyond the common set" << std::endl;
+    for (std::size_t i = 0; i != by_features.size(); ++i) {
+        std::stringstream ss;
+        for (unsigned f = 0; f != feature_count; ++f) {
+            Feature feature = static_cast<Feature>(f);
+            if (by_features[i].first.has(feature) &&
+                !fleet.common.has(feature))
+                ss << ' ' << feature_name(feature);
+        }
+        std::string extra(ss.str());
+        std::cout << std::setw(fix) << by_features[i].second;
+        std::cout << (extra.empty() ? std::string("(none)") : extra.substr(1))
+                  << std::endl;
+    }
+    print_dash();
+
+    std::cout << "Common ISA (" << fleet.common.count() << " features):";
+    for (unsigned f = 0; f != feature_count; ++f)
+        if (fleet.common.has(static_cast<Feature>(f)))
+            std::cout << ' ' << feature_name(static_cast<Feature>(f));
+    std::cout << std::endl;
+    print_dash();
+    std::cout.unsetf(std::ios_base::floatfield);
+}
+
+inline void print_flags(const CompilerFlags &flags)
+{
+    print_section("Compiler Flags");
+    const int width = 30;
+    std::cout << std::setw(width) << std::left << "x86-64 level:";
+    std::cout << isa_level_name(flags.level) << std::endl;
+    std::cout << std::setw(width) << std::left << "Tuning:";
+    std::cout << flags.mtune << std::endl;
+    std::cout << std::setw(width) << std::left << "Preferred vector width:";
+    if (flags.vector_width != 0)
+        std::cout << flags.vector_width << std::endl;
+    else
+        std::cout << "(default)" << std::endl;
+    std::cout << std::setw(width) << std::left << "Extensions above level:";
+    for (std::size_t i = 0; i != flags.extensions.size(); ++i)
+        std::cout << (i == 0 ? "" : " ") << flags.extensions[i];
+    std::cout << std::endl;
+    print_dash();
+    std::cout << flags.str() << std::endl;
+    print_dash();
+}
+
+inline void print_tune_table(const TuneTable &table)
+{
+    const int fix = 12;
+    std::cout << std::setw(fix) << std::left << "Primitive";
+    std::cout << std::setw(fix) << std::left << "Up to";
+    std::cout << std::setw(fix) << std::left << "Variant";
+    std::cout << std::setw(fix) << std::right << "GB/s" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (std::size_t i = 0; i != table.choices.size(); ++i) {
+        const TuneChoice &choice = table.choices[i];
+        std::cout << std::setw(fix) << std::left
+                  << primitive_name(choice.primitive);
+        std::cout << std::setw(fix) << std::left
+                  << format_bytes(static_cast<double>(choice.bytes));
+        std::cout << std::setw(fix) << std::left
+                  << variant_name(choice.variant);
+        std::cout << std::setw(fix) << std::right << choice.gbps << std::endl;
+    }
+    std::cout.unsetf(std::ios_base::floatfield);
+}
+
+// Measure every variant on this CPU and store the decisions in `cache` if
+// not empty
+inline void print_autotune(const std::string &cache)
+{
+    const CpuInfo &info = this_cpu();
+    std::vector<TunePoint> points(autotune(info));
+
+    print_section("Autotune (GB/s, * marks the fastest)");
+    const int fix = 10;
+    for (unsigned p = 0; p != primitive_count; ++p) {
+        Primitive primitive = static_cast<Primitive>(p);
+        std::vector<Variant> variants;
+        for (unsigned v = 0; v != variant_count; ++v)
+            if (variant_supported(primitive, static_cast<Variant>(v),
+                    info.features()))
+                variants.push_back(static_cast<Variant>(v));
+
+        std::cout << std::setw(fix) << std::left << primitive_name(primitive);
+        for (std::size_t v = 0; v != variants.size(); ++v)
+            std::cout << std::setw(fix) << std::right
+                      << variant_name(variants[v]);
+        std::cout << std::endl;
+
+        std::cout << std::fixed << std::setprecision(1);
+        for (std::size_t i = 0; i != points.size(); ++i) {
+            if (points[i].primitive != primitive)
+                continue;
+            const double *gbps = points[i].gbps;
+            unsigned best = 0;
+            for (unsigned v = 1; v != variant_count; ++v)
+                if (gbps[v] > gbps[best])
+                    best = v;
+            std::cout << std::setw(fix) << std::left
+                      << format_bytes(static_cast<double>(points[i].bytes));
+            for (std::size_t v = 0; v != variants.size(); ++v) {
+                unsigned index = static_cast<unsigned>(variants[v]);
+                std::stringstream ss;
+                ss << std::fixed << std::setprecision(1) << gbps[index]
+                   << (index == best ? "*" : " ");
+                std::cout << std::setw(fix) << std::right << ss.str();
+            }
+            std::cout << std::endl;
+        }
+        std::cout.unsetf(std::ios_base::floatfield);
+        print_dash();
+    }
+
+    TuneTable table(tune_table(tune_key(info.snapshot()), points));
+    if (cache.empty())
+        return;
+    if (save_tune_table(cache, table))
+        std::cout << "Saved to " << cache << std::endl;
+    else
+        std::cout << "Cannot write " << cache << std::endl;
+    print_dash();
+}
+
+// Load the decisions for `info` from `cache` and time the lookup
+inline bool print_tune_cache(const CpuInfo &info, const std::string &cache)
+{
+    TuneTable table;
+    bench_clock::time_point start = bench_clock::now();
+    bool found = load_tune_table(cache, tune_key(info.snapshot()), table);
+    double us = elapsed_ns(start) / 1000;
+    if (!found) {
+        std::cerr << "No autotune entry for this CPU in " << cache
+                  << std::endl;
+        return false;
+    }
+
+    print_section("Autotune Cache");
+    std::cout << cache << " loaded in " << std::fixed << std::setprecision(1)
+              << us << " us" << std::endl;
+    std::cout.unsetf(std::ios_base::floatfield);
+    print_dash();
+    print_tune_table(table);
+    print_dash();
+
+    return true;
+}
+
+inline void print_usage(const char *prog)
+{
+    std::cerr << "Usage: " << prog << " [options]" << std::endl;
+    std::cerr << "  (no option)   Report the CPU running this process"
+              << std::endl;
+    std::cerr << "  --topology    Enumerate every logical CPU" << std::endl;
+    std::cerr << "  --caches      Print the CPUs sharing each cache instance"
+              << std::endl;
+    std::cerr << "  --hybrid      Compare performance and efficiency cores"
+              << std::endl;
+    std::cerr << "  --latency     Measure the cache latency ladder"
+              << std::endl;
+    std::cerr << "  --bandwidth   Measure memory bandwidth scaling"
+              << std::endl;
+    std::cerr << "  --pingpong    Measure core-to-core cache line latency"
+              << std::endl;
+    std::cerr << "  --serial      Run one ping-pong pair at a time"
+              << std::endl;
+    std::cerr << "  --tlb         Measure page walk cost per page size"
+              << std::endl;
+    std::cerr << "  --fma         Measure FMA FLOP/s and frequency licenses"
+              << std::endl;
+    std::cerr << "  --all-cores   Run the FMA kernels on every CPU at once"
+              << std::endl;
+    std::cerr << "  --dot         Measure INT8/BF16 VNNI and AMX throughput"
+              << std::endl;
+    std::cerr << "  --tsc         Calibrate the TSC and time rdtsc variants"
+              << std::endl;
+    std::cerr << "  --vm-exits    Time CPUID, RDTSC and RDTSCP for VM exits"
+              << std::endl;
+    std::cerr << "  --mitigations Compare speculation controls with the kernel"
+              << std::endl;
+    std::cerr << "                and time syscalls, switches and faults"
+              << std::endl;
+    std::cerr << "  --monitor[=MS[,N]] Sample per-CPU clock and C0 residency"
+              << std::endl;
+    std::cerr << "                every MS ms (1000) for N intervals (10)"
+              << std::endl;
+    std::cerr << "  --resctrl=W[,P] Propose schemata reserving W L3 ways (and"
+              << std::endl;
+    std::cerr << "                P% memory bandwidth) for a critical group"
+              << std::endl;
+    std::cerr << "  --resctrl-root=DIR resctrl mount (default /sys/fs/resctrl)"
+              << std::endl;
+    std::cerr << "  --apply       Write the proposed schemata" << std::endl;
+    std::cerr << "  --max-size=N  Largest working set, e.g. 512M" << std::endl;
+    std::cerr << "  --format=F    Report as text (default), json or cbor"
+              << std::endl;
+    std::cerr << "  --dump=FILE   Save the raw leaves of every CPU (- = stdout)"
+              << std::endl;
+    std::cerr << "  --replay=FILE Decode a saved dump instead of this machine"
+              << std::endl;
+    std::cerr << "  --fleet=PATH  Group the CPU types of dump files or trees"
+              << std::endl;
+    std::cerr << "  --flags       Print -march/-mtune flags (for all --fleet)"
+              << std::endl;
+    std::cerr << "  --toolchain   Write the flags as a CMake toolchain file"
+              << std::endl;
+    std::cerr << "  --header      Write a header of constexpr cache constants"
+              << std::endl;
+    std::cerr << "  --autotune    Time memcpy/memset/CRC32C/hash variants"
+              << std::endl;
+    std::cerr << "  --tune-cache=FILE Save autotune results, or load them"
+              << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    bool topology = false;
+    bool caches = false;
+    bool hybrid = false;
+    bool latency = false;
+    bool bandwidth = false;
+    bool pingpong = false;
+    bool serial = false;
+    bool tlb = false;
+    bool fma = false;
+    bool all_cores = false;
+    bool dot = false;
+    bool tsc = false;
+    bool vm_exits = false;
+    bool mitigations = false;
+    bool monitor = false;
+    unsigned monitor_ms = 1000;
+    unsigned monitor_intervals = 10;
+    bool resctrl = false;
+    unsigned reserve_ways = 0;
+    unsigned reserve_mba = 0;
+    std::string resctrl_root("/sys/fs/resctrl");
+    bool apply = false;
+    bool flags = false;
+    bool toolchain = false;
+    bool header = false;
+    bool tune = false;
+    std::string tune_cache;
+    std::string format("text");
+    std::string dump;
+    std::string replay;
+    std::vector<std::string> fleet;
+    std::size_t max_size = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg(argv[i]);
+        if (arg == "--topology") {
+            topology = true;
+        } else if (arg == "--caches") {
+            caches = true;
+        } else if (arg == "--hybrid") {
+            hybrid = true;
+        } else if (arg == "--latency") {
+            latency = true;
+        } else if (arg == "--bandwidth") {
+            bandwidth = true;
+        } else if (arg == "--pingpong") {
+            pingpong = true;
+        } else if (arg == "--serial") {
+            serial = true;
+        } else if (arg == "--tlb") {
+            tlb = true;
+        } else if (arg == "--fma") {
+            fma = true;
+        } else if (arg == "--all-cores") {
+            all_cores = true;
+        } else if (arg == "--dot") {
+            dot = true;
+        } else if (arg == "--tsc") {
+            tsc = true;
+        } else if (arg == "--vm-exits") {
+            vm_exits = true;
+        } else if (arg == "--mitigations") {
+            mitigations = true;
+        } else if (arg == "--monitor") {
+            monitor = true;
+        } else if (arg.compare(0, 10, "--monitor=") == 0 &&
+            parse_monitor(arg.substr(10), monitor_ms, monitor_intervals)) {
+            monitor = true;
+            if (monitor_intervals == 0)
+                monitor_intervals = 10;
+        } else if (arg.compare(0, 10, "--resctrl=") == 0 &&
+            parse_reservation(arg.substr(10), reserve_ways, reserve_mba)) {
+            resctrl = true;
+        } else if (arg.compare(0, 15, "--resctrl-root=") == 0 &&
+            arg.size() > 15) {
+            resctrl_root = arg.substr(15);
+        } else if (arg == "--apply") {
+            apply = true;
+        } else if (arg == "--flags") {
+            flags = true;
+        } else if (arg == "--toolchain") {
+            toolchain = true;
+        } else if (arg == "--header") {
+            header = true;
+        } else if (arg == "--autotune") {
+            tune = true;
+        } else if (arg.compare(0, 13, "--tune-cache=") == 0 &&
+            arg.size() > 13) {
+            tune_cache = arg.substr(13);
+        } else if (arg == "--format=text" || arg == "--format=json" ||
+            arg == "--format=cbor") {
+            format = arg.substr(9);
+        } else if (arg.compare(0, 7, "--dump=") == 0 && arg.size() > 7) {
+            dump = arg.substr(7);
+        } else if (arg.compare(0, 9, "--replay=") == 0 && arg.size() > 9) {
+            replay = arg.substr(9);
+        } else if (arg.compare(0, 8, "--fleet=") == 0 && arg.size() > 8) {
+            fleet.push_back(arg.substr(8));
+        } else if (arg.compare(0, 11, "--max-size=") == 0 &&
+            parse_bytes(arg.substr(11), max_size)) {
+        } else {
+            print_usage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if (!dump.empty()) {
+        if (!save_dump(dump, capture_all_cpus())) {
+            std::cerr << "Cannot write " << dump << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!fleet.empty()) {
+        std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+        FleetSummary summary(ingest_fleet(fleet));
+        double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start)
+                        .count();
+        if (summary.hosts == 0) {
+            std::cerr << "No CPUID dump found" << std::endl;
+            return 1;
+        }
+        if (flags || toolchain) {
+            CompilerFlags result(compiler_flags(summary));
+            if (flags)
+                print_flags(result);
+            if (toolchain)
+                write_toolchain(result, std::cout);
+            return 0;
+        }
+        if (format == "json") {
+            JsonWriter writer(std::cout);
+            write_fleet(summary, writer);
+        } else if (format == "cbor") {
+            CborWriter writer(std::cout);
+            write_fleet(summary, writer);
+        } else {
+            print_fleet(summary, ms);
+        }
+        return 0;
+    }
+
+    std::vector<Snapshot> snapshots;
+    if (!replay.empty() && !load_dump(replay, snapshots)) {
+        std::cerr << "Cannot read a CPUID dump from " << replay << std::endl;
+        return 1;
+    }
+
+    if (resctrl) {
+        const CpuInfo info(
+            snapshots.empty() ? Snapshot::capture() : snapshots.front());
+        Topology topo(snapshots.empty() ? Topology::enumerate()
+                                        : Topology::replay(snapshots));
+        return print_resctrl(info, topo, resctrl_root, reserve_ways,
+                   reserve_mba, apply)
+            ? 0
+            : 1;
+    }
+
+    if (monitor)
+        return print_monitor(monitor_ms, monitor_intervals) ? 0 : 1;
+
+    if (topology || caches || hybrid || latency || bandwidth || pingpong ||
+        tlb || fma || dot || tsc || vm_exits || mitigations) {
+        Topology topo;
+        double ms = -1;
+        if (!snapshots.empty()) {
+            topo = Topology::replay(snapshots);
+        } else if (topology || caches || hybrid) {
+            std::chrono::steady_clock::time_point start =
+                std::chrono::steady_clock::now();
+            topo = Topology::enumerate();
+            ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start)
+                     .count();
+        }
+
+        if (topology)
+            print_topology(topo, ms);
+        if (caches)
+            print_cache_domains(topo);
+        if (hybrid)
+            print_hybrid(topo);
+        if (latency)
+            print_latency(max_size);
+        if (bandwidth)
+            print_bandwidth(max_size);
+        if (pingpong)
+            print_pingpong(serial);
+        if (tlb)
+            print_tlb_reach(max_size);
+        if (fma)
+            print_fma(all_cores);
+        if (dot)
+            print_dot();
+        if (tsc)
+            print_tsc();
+        if (vm_exits)
+            print_vm_exits();
+        if (mitigations)
+            print_mitigations();
+        return 0;
+    }
+
+    const CpuInfo info(
+        snapshots.empty() ? Snapshot::capture() : snapshots.front());
+    if (flags || toolchain) {
+        CompilerFlags result(compiler_flags(info));
+        if (flags)
+            print_flags(result);
+        if (toolchain)
+            write_toolchain(result, std::cout);
+        return 0;
+    }
+    if (header) {
+        write_target_header(info, std::cout);
+        return 0;
+    }
+    if (tune) {
+        print_autotune(tune_cache);
+        return 0;
+    }
+    if (!tune_cache.empty())
+        return print_tune_cache(info, tune_cache) ? 0 : 1;
+    std::uint64_t xcr0 = snapshots.empty() ? os_xcr0() : 0;
+    if (format == "json") {
+        JsonWriter writer(std::cout);
+        write_report(info, writer, xcr0);
+        return 0;
+    }
+    if (format == "cbor") {
+        CborWriter writer(std::cout);
+        write_report(info, writer, xcr0);
+        return 0;
+    }
+
     print_equal();
-    print_vendor();
-    print_brand();
+    print_vendor(info);
+    print_brand(info);
     print_dash();
 
-    print_eax<0x01>();
-    print_eax<0x02>();
-    print_eax<0x04>();
-    print_eax<0x06>();
-    print_eax<0x07>();
-    print_eax<0x16>();
-    print_eax<0x80000001>();
+    print_eax<0x01>(info);
+    print_eax<0x02>(info);
+    print_eax<0x04>(info);
+    print_eax<0x06>(info);
+    print_eax<0x07>(info);
+    print_xsave(info, snapshots.empty());
+    print_eax<0x0F>(info);
+    print_eax<0x10>(info);
+    print_eax<0x15>(info);
+    print_eax<0x16>(info);
+    print_eax<0x18>(info);
+    print_eax<0x1D>(info);
+    print_eax<0x40000000>(info);
+    print_eax<0x80000001>(info);
+    print_eax<0x80000008>(info);
+    print_eax<0x8000001E>(info);
 
     return 0;
 }
@@ -0,0 +1,157 @@
+#include <cpuid_info/affinity.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace cpuid_info
+{
+
+std::vector<int> allowed_cpus()
+{
+    std::vector<int> cpus;
+
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0)
+        return cpus;
+    for (int i = 0; i != CPU_SETSIZE; ++i)
+        if (CPU_ISSET(i, &set))
+            cpus.push_back(i);
+#endif
+
+    return cpus;
+}
+
+int current_cpu()
+{
+#if defined(__linux__)
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+bool pin_this_thread(int cpu)
+{
+    return pin_this_thread(std::vector<int>(1, cpu));
+}
+
+bool pin_this_thread(const std::vector<int> &cpus)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (std::size_t i = 0; i != cpus.size(); ++i) {
+        if (cpus[i] < 0 || cpus[i] >= CPU_SETSIZE)
+            return false;
+        CPU_SET(cpus[i], &set);
+    }
+
+    // With pid 0 only the calling thread is affected, and the kernel has
+    // migrated it by the time the call returns
+    return !cpus.empty() && sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    static_cast<void>(cpus);
+
+    return false;
+#endif
+}
+
+std::vector<NumaNode> numa_nodes()
+{
+    std::vector<int> allowed(allowed_cpus());
+    std::vector<NumaNode> nodes;
+
+    // Node numbers may be sparse, stop after a run of missing nodes
+    for (int id = 0, missing = 0; missing < 64; ++id) {
+        std::stringstream path;
+        path << "/sys/devices/system/node/node" << id << "/cpulist";
+        std::ifstream file(path.str().c_str());
+        std::string line;
+        std::vector<int> cpus;
+        if (!file || !std::getline(file, line) || !parse_cpulist(line, cpus)) {
+            ++missing;
+            continue;
+        }
+        missing = 0;
+
+        NumaNode node;
+        node.id = id;
+        for (std::size_t i = 0; i != cpus.size(); ++i)
+            if (std::find(allowed.begin(), allowed.end(), cpus[i]) !=
+                allowed.end())
+                node.cpus.push_back(cpus[i]);
+        if (!node.cpus.empty())
+            nodes.push_back(node);
+    }
+
+    if (nodes.empty() && !allowed.empty()) {
+        NumaNode node;
+        node.id = 0;
+        node.cpus = allowed;
+        nodes.push_back(node);
+    }
+
+    return nodes;
+}
+
+std::string cpulist(std::vector<int> cpus)
+{
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+
+    std::stringstream ss;
+    for (std::size_t i = 0; i != cpus.size();) {
+        std::size_t j = i;
+        while (j + 1 != cpus.size() && cpus[j + 1] == cpus[j] + 1)
+            ++j;
+        if (i != 0)
+            ss << ',';
+        ss << cpus[i];
+        if (j != i)
+            ss << '-' << cpus[j];
+        i = j + 1;
+    }
+
+    return ss.str();
+}
+
+bool parse_cpulist(const std::string &str, std::vector<int> &cpus)
+{
+    cpus.clear();
+    std::stringstream ss(str);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        range.erase(0, range.find_first_not_of(" \t\n"));
+        range.erase(range.find_last_not_of(" \t\n") + 1);
+        if (range.empty())
+            continue;
+
+        char *end = 0;
+        long lo = std::strtol(range.c_str(), &end, 10);
+        long hi = lo;
+        if (end == range.c_str())
+            return false;
+        if (*end == '-') {
+            const char *begin = end + 1;
+            hi = std::strtol(begin, &end, 10);
+            if (end == begin)
+                return false;
+        }
+        if (*end != '\0' || lo < 0 || hi < lo)
+            return false;
+        for (long i = lo; i <= hi; ++i)
+            cpus.push_back(static_cast<int>(i));
+    }
+
+    return true;
+}
+
+} // namespace cpuid_info
@@ -0,0 +1,48 @@
+#ifndef CPUID_INFO_AFFINITY_HPP
+#define CPUID_INFO_AFFINITY_HPP
+
+#include <string>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief OS numbers of the logical CPUs the process is allowed to run on
+///
+/// \details
+/// Empty if affinity is not supported on this platform.
+std::vector<int> allowed_cpus();
+
+/// \brief OS number of the CPU the calling thread runs on, or -1
+int current_cpu();
+
+/// \brief Restrict the calling thread to a single logical CPU
+///
+/// \return false if the thread could not be pinned
+bool pin_this_thread(int cpu);
+
+/// \brief Restrict the calling thread to a set of logical CPUs
+bool pin_this_thread(const std::vector<int> &cpus);
+
+/// \brief A NUMA node and the allowed CPUs attached to it
+struct NumaNode {
+    int id;
+    std::vector<int> cpus;
+};
+
+/// \brief NUMA nodes with at least one allowed CPU, from
+/// /sys/devices/system/node
+///
+/// \details
+/// Without NUMA information all allowed CPUs are reported as node 0.
+std::vector<NumaNode> numa_nodes();
+
+/// \brief Format CPU numbers in the kernel cpulist format, e.g. "0-3,8-11"
+std::string cpulist(std::vector<int> cpus);
+
+/// \brief Parse a kernel cpulist string, returns false on malformed input
+bool parse_cpulist(const std::string &str, std::vector<int> &cpus);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_AFFINITY_HPP
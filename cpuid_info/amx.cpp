@@ -0,0 +1,72 @@
+#include <cpuid_info/amx.hpp>
+#include <cpuid_info/feature.hpp>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+#if defined(__linux__)
+// From asm/prctl.h, missing from older kernel headers
+const unsigned long arch_get_xcomp_perm = 0x1022;
+const unsigned long arch_req_xcomp_perm = 0x1023;
+
+// XCR0 bit of the tile data state component
+const unsigned long xfeature_xtiledata = 18;
+#endif
+
+} // namespace
+
+AmxInfo amx_info(const Snapshot &snapshot)
+{
+    AmxInfo info;
+    info.tmul_max_k = 0;
+    info.tmul_max_n = 0;
+    if (snapshot.max_basic() < 0x1D ||
+        !Features(snapshot).has(Feature::AMX_TILE))
+        return info;
+
+    unsigned max_palette = snapshot.get(0x1D).eax;
+    for (unsigned id = 1; id <= max_palette; ++id) {
+        Register reg(snapshot.get(0x1D, id));
+        AmxPalette palette;
+        palette.id = id;
+        palette.total_tile_bytes = extract_bits(reg.eax, 15, 0);
+        palette.bytes_per_tile = extract_bits(reg.eax, 31, 16);
+        palette.bytes_per_row = extract_bits(reg.ebx, 15, 0);
+        palette.max_names = extract_bits(reg.ebx, 31, 16);
+        palette.max_rows = extract_bits(reg.ecx, 15, 0);
+        info.palettes.push_back(palette);
+    }
+
+    if (snapshot.max_basic() >= 0x1E) {
+        Register reg(snapshot.get(0x1E));
+        info.tmul_max_k = extract_bits(reg.ebx, 7, 0);
+        info.tmul_max_n = extract_bits(reg.ebx, 23, 8);
+    }
+
+    return info;
+}
+
+bool request_amx_permission()
+{
+#if defined(__linux__)
+    if (syscall(SYS_arch_prctl, arch_req_xcomp_perm, xfeature_xtiledata) != 0)
+        return false;
+    unsigned long long mask = 0;
+    if (syscall(SYS_arch_prctl, arch_get_xcomp_perm, &mask) != 0)
+        return false;
+
+    return (mask >> xfeature_xtiledata) & 1;
+#else
+    return false;
+#endif
+}
+
+} // namespace cpuid_info
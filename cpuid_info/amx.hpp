@@ -0,0 +1,45 @@
+#ifndef CPUID_INFO_AMX_HPP
+#define CPUID_INFO_AMX_HPP
+
+#include <cpuid_info/snapshot.hpp>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief A tile palette of leaf 0x1D, palette 0 is the initialized state
+/// and not listed
+struct AmxPalette {
+    unsigned id;
+    unsigned total_tile_bytes;  ///< All tile registers together
+    unsigned bytes_per_tile;
+    unsigned bytes_per_row;
+    unsigned max_names;  ///< Number of tile registers
+    unsigned max_rows;
+};
+
+/// \brief Tile geometry of leaves 0x1D and 0x1E
+struct AmxInfo {
+    std::vector<AmxPalette> palettes;
+    unsigned tmul_max_k;  ///< Rows or columns of the TMUL unit
+    unsigned tmul_max_n;  ///< Column bytes of the TMUL unit
+
+    bool empty() const { return palettes.empty(); }
+};
+
+/// \brief Decode the palettes and TMUL limits, empty without AMX-TILE
+AmxInfo amx_info(const Snapshot &snapshot);
+
+/// \brief Ask the OS to let this process use the tile data state
+///
+/// \details
+/// Linux (5.16 and later) enables the 8 KiB tile data state per process, a
+/// tile instruction without permission raises SIGILL. The request is made
+/// once with arch_prctl(ARCH_REQ_XCOMP_PERM) and applies to every thread of
+/// the process. False if the kernel refuses or does not support AMX, and
+/// on other systems.
+bool request_amx_permission();
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_AMX_HPP
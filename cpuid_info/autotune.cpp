@@ -0,0 +1,707 @@
+#include <cpuid_info/autotune.hpp>
+#include <cpuid_info/bench.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <immintrin.h>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+// Copy n < 16 bytes, or 16 <= n < 2 * 16 with two overlapping vectors
+inline void copy_small(char *d, const char *s, std::size_t n)
+{
+    if (n >= 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+        __m128i b =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + n - 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(d), a);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(d + n - 16), b);
+    } else if (n >= 8) {
+        std::uint64_t a, b;
+        std::memcpy(&a, s, 8);
+        std::memcpy(&b, s + n - 8, 8);
+        std::memcpy(d, &a, 8);
+        std::memcpy(d + n - 8, &b, 8);
+    } else if (n >= 4) {
+        std::uint32_t a, b;
+        std::memcpy(&a, s, 4);
+        std::memcpy(&b, s + n - 4, 4);
+        std::memcpy(d, &a, 4);
+        std::memcpy(d + n - 4, &b, 4);
+    } else {
+        for (std::size_t i = 0; i != n; ++i)
+            d[i] = s[i];
+    }
+}
+
+inline void fill_small(char *d, int c, std::size_t n)
+{
+    __m128i v = _mm_set1_epi8(static_cast<char>(c));
+    if (n >= 16) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(d), v);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(d + n - 16), v);
+    } else {
+        for (std::size_t i = 0; i != n; ++i)
+            d[i] = static_cast<char>(c);
+    }
+}
+
+// Copy and fill kernels of one instruction set: four vectors per
+// iteration, then one at a time, then one vector overlapping the end.
+// Sizes below two 16-byte vectors go through the small helpers.
+#define CPUID_INFO_COPY_KERNELS(Name, isa, vec, w, loadu, storeu, set1)      \
+    struct Name {                                                             \
+        __attribute__((target(isa))) static void copy(                        \
+            void *dst, const void *src, std::size_t n)                        \
+        {                                                                     \
+            char *d = static_cast<char *>(dst);                               \
+            const char *s = static_cast<const char *>(src);                   \
+            if (n < w) {                                                      \
+                if (n < 32)                                                   \
+                    copy_small(d, s, n);                                      \
+                else                                                          \
+                    for (std::size_t i = 0; i < n; i += 16)                   \
+                        copy_small(d + std::min(i, n - 16),                   \
+                            s + std::min(i, n - 16), 16);                     \
+                return;                                                       \
+            }                                                                 \
+            std::size_t i = 0;                                                \
+            for (; i + 4 * w <= n; i += 4 * w) {                              \
+                vec a = loadu(reinterpret_cast<const vec *>(s + i));          \
+                vec b = loadu(reinterpret_cast<const vec *>(s + i + w));      \
+                vec c = loadu(reinterpret_cast<const vec *>(s + i + 2 * w));  \
+                vec e = loadu(reinterpret_cast<const vec *>(s + i + 3 * w));  \
+                storeu(reinterpret_cast<vec *>(d + i), a);                    \
+                storeu(reinterpret_cast<vec *>(d + i + w), b);                \
+                storeu(reinterpret_cast<vec *>(d + i + 2 * w), c);            \
+                storeu(reinterpret_cast<vec *>(d + i + 3 * w), e);            \
+            }                                                                 \
+            for (; i + w <= n; i += w)                                        \
+                storeu(reinterpret_cast<vec *>(d + i),                        \
+                    loadu(reinterpret_cast<const vec *>(s + i)));             \
+            if (i != n)                                                       \
+                storeu(reinterpret_cast<vec *>(d + n - w),                    \
+                    loadu(reinterpret_cast<const vec *>(s + n - w)));         \
+        }                                                                     \
+                                                                              \
+        __attribute__((target(isa))) static void fill(                        \
+            void *dst, int c, std::size_t n)                                  \
+        {                                                                     \
+            char *d = static_cast<char *>(dst);                               \
+            if (n < w) {                                                      \
+                for (std::size_t i = 0; i < n; i += 16)                       \
+                    fill_small(d + (n < 16 ? 0 : std::min(i, n - 16)), c,     \
+                        std::min<std::size_t>(n, 16));                        \
+                return;                                                       \
+            }                                                                 \
+            vec v = set1(static_cast<char>(c));                               \
+            std::size_t i = 0;                                                \
+            for (; i + 4 * w <= n; i += 4 * w) {                              \
+                storeu(reinterpret_cast<vec *>(d + i), v);                    \
+                storeu(reinterpret_cast<vec *>(d + i + w), v);                \
+                storeu(reinterpret_cast<vec *>(d + i + 2 * w), v);            \
+                storeu(reinterpret_cast<vec *>(d + i + 3 * w), v);            \
+            }                                                                 \
+            for (; i + w <= n; i += w)                                        \
+                storeu(reinterpret_cast<vec *>(d + i), v);                    \
+            if (i != n)                                                       \
+                storeu(reinterpret_cast<vec *>(d + n - w), v);                \
+        }                                                                     \
+    };
+
+CPUID_INFO_COPY_KERNELS(KernelsSSE2, "sse2", __m128i, 16, _mm_loadu_si128,
+    _mm_storeu_si128, _mm_set1_epi8)
+CPUID_INFO_COPY_KERNELS(KernelsAVX2, "avx2", __m256i, 32, _mm256_loadu_si256,
+    _mm256_storeu_si256, _mm256_set1_epi8)
+CPUID_INFO_COPY_KERNELS(KernelsAVX512, "avx512f", __m512i, 64,
+    _mm512_loadu_si512, _mm512_storeu_si512, _mm512_set1_epi8)
+
+#undef CPUID_INFO_COPY_KERNELS
+
+void copy_libc(void *dst, const void *src, std::size_t n)
+{
+    std::memcpy(dst, src, n);
+}
+
+void fill_libc(void *dst, int c, std::size_t n) { std::memset(dst, c, n); }
+
+void copy_erms(void *dst, const void *src, std::size_t n)
+{
+    __asm__ volatile("rep movsb"
+                     : "+D"(dst), "+S"(src), "+c"(n)
+                     :
+                     : "memory");
+}
+
+void fill_erms(void *dst, int c, std::size_t n)
+{
+    __asm__ volatile("rep stosb" : "+D"(dst), "+c"(n) : "a"(c) : "memory");
+}
+
+// Reflected Castagnoli polynomial
+const std::uint32_t crc32c_poly = 0x82F63B78;
+
+struct Crc32cTable {
+    std::uint32_t entries[256];
+
+    Crc32cTable()
+    {
+        for (std::uint32_t i = 0; i != 256; ++i) {
+            std::uint32_t c = i;
+            for (unsigned k = 0; k != 8; ++k)
+                c = c & 1 ? (c >> 1) ^ crc32c_poly : c >> 1;
+            entries[i] = c;
+        }
+    }
+}; // struct Crc32cTable
+
+std::uint32_t crc32c_scalar(std::uint32_t crc, const void *data, std::size_t n)
+{
+    static const Crc32cTable table;
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    std::uint32_t c = ~crc;
+    for (std::size_t i = 0; i != n; ++i)
+        c = table.entries[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+
+    return ~c;
+}
+
+__attribute__((target("sse4.2"))) std::uint32_t crc32c_sse42(
+    std::uint32_t crc, const void *data, std::size_t n)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    std::uint64_t c = ~crc;
+    for (; n >= 8; n -= 8, p += 8) {
+        std::uint64_t w;
+        std::memcpy(&w, p, 8);
+        c = _mm_crc32_u64(c, w);
+    }
+    std::uint32_t c32 = static_cast<std::uint32_t>(c);
+    for (; n != 0; --n, ++p)
+        c32 = _mm_crc32_u8(c32, *p);
+
+    return ~c32;
+}
+
+// Sixteen 32-bit lanes, each updated as an xxHash32 round, over 64 byte
+// blocks; the tail and the lanes are folded in the same way by all
+// variants
+const std::uint32_t hash_prime1 = 2654435761U;
+const std::uint32_t hash_prime2 = 2246822519U;
+const unsigned hash_lanes = 16;
+
+inline std::uint32_t rotl32(std::uint32_t x, unsigned r)
+{
+    return (x << r) | (x >> (32 - r));
+}
+
+void hash_init(std::uint32_t *acc)
+{
+    for (unsigned l = 0; l != hash_lanes; ++l)
+        acc[l] = hash_prime1 * (l + 1);
+}
+
+std::uint32_t hash_finish(const std::uint32_t *acc, const unsigned char *tail,
+    std::size_t tail_size, std::size_t n)
+{
+    std::uint32_t h = static_cast<std::uint32_t>(n);
+    for (unsigned l = 0; l != hash_lanes; ++l)
+        h = rotl32(h ^ acc[l], 17) * hash_prime1;
+    for (std::size_t i = 0; i != tail_size; ++i)
+        h = rotl32(h ^ tail[i], 11) * hash_prime1;
+    h ^= h >> 15;
+    h *= hash_prime2;
+    h ^= h >> 13;
+
+    return h;
+}
+
+std::uint32_t hash_scalar(const void *data, std::size_t n)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    std::uint32_t acc[hash_lanes];
+    hash_init(acc);
+    std::size_t blocks = n / 64;
+    for (std::size_t b = 0; b != blocks; ++b, p += 64) {
+        for (unsigned l = 0; l != hash_lanes; ++l) {
+            std::uint32_t w;
+            std::memcpy(&w, p + 4 * l, 4);
+            acc[l] = rotl32(acc[l] + w * hash_prime2, 13) * hash_prime1;
+        }
+    }
+
+    return hash_finish(acc, p, n % 64, n);
+}
+
+__attribute__((target("avx2"))) std::uint32_t hash_avx2(
+    const void *data, std::size_t n)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    alignas(32) std::uint32_t acc[hash_lanes];
+    hash_init(acc);
+    __m256i a0 = _mm256_load_si256(reinterpret_cast<const __m256i *>(acc));
+    __m256i a1 = _mm256_load_si256(reinterpret_cast<const __m256i *>(acc + 8));
+    const __m256i p1 = _mm256_set1_epi32(static_cast<int>(hash_prime1));
+    const __m256i p2 = _mm256_set1_epi32(static_cast<int>(hash_prime2));
+    std::size_t blocks = n / 64;
+    for (std::size_t b = 0; b != blocks; ++b, p += 64) {
+        __m256i w0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        __m256i w1 =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 32));
+        a0 = _mm256_add_epi32(a0, _mm256_mullo_epi32(w0, p2));
+        a1 = _mm256_add_epi32(a1, _mm256_mullo_epi32(w1, p2));
+        a0 = _mm256_or_si256(
+            _mm256_slli_epi32(a0, 13), _mm256_srli_epi32(a0, 19));
+        a1 = _mm256_or_si256(
+            _mm256_slli_epi32(a1, 13), _mm256_srli_epi32(a1, 19));
+        a0 = _mm256_mullo_epi32(a0, p1);
+        a1 = _mm256_mullo_epi32(a1, p1);
+    }
+    _mm256_store_si256(reinterpret_cast<__m256i *>(acc), a0);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(acc + 8), a1);
+
+    return hash_finish(acc, p, n % 64, n);
+}
+
+__attribute__((target("avx512f"))) std::uint32_t hash_avx512(
+    const void *data, std::size_t n)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    alignas(64) std::uint32_t acc[hash_lanes];
+    hash_init(acc);
+    __m512i a = _mm512_load_si512(acc);
+    const __m512i p1 = _mm512_set1_epi32(static_cast<int>(hash_prime1));
+    const __m512i p2 = _mm512_set1_epi32(static_cast<int>(hash_prime2));
+    // The unmasked shifts and rotates merge into _mm512_undefined_epi32(),
+    // which GCC 12 flags as maybe uninitialized; zero masking every lane
+    // emits the same instructions
+    const __mmask16 lanes = 0xFFFF;
+    std::size_t blocks = n / 64;
+    for (std::size_t b = 0; b != blocks; ++b, p += 64) {
+        __m512i w = _mm512_loadu_si512(p);
+        a = _mm512_add_epi32(a, _mm512_mullo_epi32(w, p2));
+        a = _mm512_or_si512(_mm512_maskz_slli_epi32(lanes, a, 13),
+            _mm512_maskz_srli_epi32(lanes, a, 19));
+        a = _mm512_mullo_epi32(a, p1);
+    }
+    _mm512_store_si512(acc, a);
+
+    return hash_finish(acc, p, n % 64, n);
+}
+
+const std::size_t tune_min_size = 16;
+const std::size_t tune_max_size = std::size_t(4) << 20;
+
+// Runs one variant on `n` bytes a given number of times
+struct VariantLoop {
+    Primitive primitive;
+    Variant variant;
+    char *dst;
+    const char *src;
+    std::size_t n;
+
+    void operator()(unsigned long iterations) const;
+};
+
+void VariantLoop::operator()(unsigned long iterations) const
+{
+    std::uint32_t r = 0;
+    switch (primitive) {
+        case Primitive::Memcpy: {
+            CopyKernel k = copy_kernel(variant);
+            for (unsigned long i = 0; i != iterations; ++i)
+                k(dst, src, n);
+            break;
+        }
+        case Primitive::Memset: {
+            FillKernel k = fill_kernel(variant);
+            for (unsigned long i = 0; i != iterations; ++i)
+                k(dst, static_cast<int>(i & 0x7F), n);
+            break;
+        }
+        case Primitive::Crc32c: {
+            Crc32cKernel k = crc32c_kernel(variant);
+            for (unsigned long i = 0; i != iterations; ++i)
+                r = k(r, src, n);
+            break;
+        }
+        default: {
+            HashKernel k = hash_kernel(variant);
+            for (unsigned long i = 0; i != iterations; ++i)
+                r += k(src, n);
+            break;
+        }
+    }
+    do_not_optimize(r);
+}
+
+// Check the output of one call against the libc or scalar reference
+bool verify(Primitive primitive, Variant variant, char *dst, const char *src,
+    std::size_t n)
+{
+    switch (primitive) {
+        case Primitive::Memcpy:
+            std::memset(dst, 0, n);
+            copy_kernel(variant)(dst, src, n);
+            return std::memcmp(dst, src, n) == 0;
+        case Primitive::Memset:
+            fill_kernel(variant)(dst, 0x5A, n);
+            for (std::size_t i = 0; i != n; ++i)
+                if (dst[i] != 0x5A)
+                    return false;
+            return true;
+        case Primitive::Crc32c:
+            return crc32c_kernel(variant)(0, src, n) ==
+                crc32c_scalar(0, src, n);
+        default:
+            return hash_kernel(variant)(src, n) == hash_scalar(src, n);
+    }
+}
+
+bool parse_choice(const std::string &line, TuneChoice &choice)
+{
+    std::istringstream in(line);
+    std::string tag, primitive, variant;
+    if (!(in >> tag >> primitive >> choice.bytes >> variant >> choice.gbps) ||
+        tag != "choice")
+        return false;
+
+    unsigned p = 0;
+    while (p != primitive_count &&
+        primitive != primitive_name(static_cast<Primitive>(p)))
+        ++p;
+    unsigned v = 0;
+    while (v != variant_count &&
+        variant != variant_name(static_cast<Variant>(v)))
+        ++v;
+    if (p == primitive_count || v == variant_count)
+        return false;
+    choice.primitive = static_cast<Primitive>(p);
+    choice.variant = static_cast<Variant>(v);
+
+    return true;
+}
+
+std::string key_line(const TuneKey &key)
+{
+    char line[80];
+    std::snprintf(line, sizeof(line), "key %08x %08x %08x %08x %08x %08x",
+        key.words[0], key.words[1], key.words[2], key.words[3], key.words[4],
+        key.words[5]);
+
+    return line;
+}
+
+} // namespace
+
+const char *primitive_name(Primitive primitive)
+{
+    switch (primitive) {
+        case Primitive::Memcpy:
+            return "memcpy";
+        case Primitive::Memset:
+            return "memset";
+        case Primitive::Crc32c:
+            return "crc32c";
+        default:
+            return "hash";
+    }
+}
+
+const char *variant_name(Variant variant)
+{
+    switch (variant) {
+        case Variant::Libc:
+            return "libc";
+        case Variant::SSE2:
+            return "SSE2";
+        case Variant::SSE42:
+            return "SSE4.2";
+        case Variant::AVX2:
+            return "AVX2";
+        case Variant::AVX512:
+            return "AVX-512";
+        case Variant::ERMS:
+            return "ERMS";
+        default:
+            return "scalar";
+    }
+}
+
+CopyKernel copy_kernel(Variant variant)
+{
+    switch (variant) {
+        case Variant::Libc:
+            return copy_libc;
+        case Variant::SSE2:
+            return KernelsSSE2::copy;
+        case Variant::AVX2:
+            return KernelsAVX2::copy;
+        case Variant::AVX512:
+            return KernelsAVX512::copy;
+        case Variant::ERMS:
+            return copy_erms;
+        default:
+            return nullptr;
+    }
+}
+
+FillKernel fill_kernel(Variant variant)
+{
+    switch (variant) {
+        case Variant::Libc:
+            return fill_libc;
+        case Variant::SSE2:
+            return KernelsSSE2::fill;
+        case Variant::AVX2:
+            return KernelsAVX2::fill;
+        case Variant::AVX512:
+            return KernelsAVX512::fill;
+        case Variant::ERMS:
+            return fill_erms;
+        default:
+            return nullptr;
+    }
+}
+
+Crc32cKernel crc32c_kernel(Variant variant)
+{
+    switch (variant) {
+        case Variant::Scalar:
+            return crc32c_scalar;
+        case Variant::SSE42:
+            return crc32c_sse42;
+        default:
+            return nullptr;
+    }
+}
+
+HashKernel hash_kernel(Variant variant)
+{
+    switch (variant) {
+        case Variant::Scalar:
+            return hash_scalar;
+        case Variant::AVX2:
+            return hash_avx2;
+        case Variant::AVX512:
+            return hash_avx512;
+        default:
+            return nullptr;
+    }
+}
+
+bool variant_supported(
+    Primitive primitive, Variant variant, const Features &features)
+{
+    bool exists = false;
+    switch (primitive) {
+        case Primitive::Memcpy:
+            exists = copy_kernel(variant) != nullptr;
+            break;
+        case Primitive::Memset:
+            exists = fill_kernel(variant) != nullptr;
+            break;
+        case Primitive::Crc32c:
+            exists = crc32c_kernel(variant) != nullptr;
+            break;
+        default:
+            exists = hash_kernel(variant) != nullptr;
+            break;
+    }
+    if (!exists)
+        return false;
+
+    SimdLevel simd = select_simd(features);
+    switch (variant) {
+        case Variant::SSE42:
+            return features.has(Feature::SSE4_2);
+        case Variant::AVX2:
+            return simd >= SimdLevel::AVX2;
+        case Variant::AVX512:
+            return simd >= SimdLevel::AVX512;
+        default:
+            return true;
+    }
+}
+
+bool TuneKey::operator==(const TuneKey &other) const
+{
+    for (unsigned i = 0; i != 6; ++i)
+        if (words[i] != other.words[i])
+            return false;
+
+    return true;
+}
+
+TuneKey tune_key(const Snapshot &snapshot)
+{
+    Register leaf01(snapshot.get(0x01));
+    Register leaf07(snapshot.get(0x07));
+    TuneKey key = {{leaf01.eax, leaf01.ecx, leaf01.edx, leaf07.ebx,
+        leaf07.ecx, leaf07.edx}};
+
+    return key;
+}
+
+Variant TuneTable::select(Primitive primitive, std::size_t bytes) const
+{
+    const TuneChoice *last = nullptr;
+    for (std::size_t i = 0; i != choices.size(); ++i) {
+        if (choices[i].primitive != primitive)
+            continue;
+        if (choices[i].bytes >= bytes)
+            return choices[i].variant;
+        last = &choices[i];
+    }
+    if (last != nullptr)
+        return last->variant;
+
+    bool copy = primitive == Primitive::Memcpy ||
+        primitive == Primitive::Memset;
+
+    return copy ? Variant::Libc : Variant::Scalar;
+}
+
+std::vector<std::size_t> tune_sizes()
+{
+    std::vector<std::size_t> sizes;
+    for (std::size_t n = tune_min_size; n <= tune_max_size; n *= 4)
+        sizes.push_back(n);
+
+    return sizes;
+}
+
+std::vector<TunePoint> autotune(const CpuInfo &info, double ms)
+{
+    std::vector<TunePoint> points;
+    BenchBuffer src(tune_max_size);
+    BenchBuffer dst(tune_max_size);
+    if (!src.ok() || !dst.ok())
+        return points;
+    for (std::size_t i = 0; i != tune_max_size; ++i)
+        src.data()[i] = static_cast<char>(i * 7 + (i >> 9));
+
+    std::vector<std::size_t> sizes(tune_sizes());
+    for (unsigned p = 0; p != primitive_count; ++p) {
+        Primitive primitive = static_cast<Primitive>(p);
+        for (std::size_t s = 0; s != sizes.size(); ++s) {
+            std::size_t n = sizes[s];
+            TunePoint point;
+            point.primitive = primitive;
+            point.bytes = n;
+            for (unsigned v = 0; v != variant_count; ++v) {
+                Variant variant = static_cast<Variant>(v);
+                point.gbps[v] = 0;
+                if (!variant_supported(primitive, variant, info.features()) ||
+                    !verify(primitive, variant, dst.data(), src.data(), n))
+                    continue;
+
+                // Keep the best of three timings
+                VariantLoop loop = {
+                    primitive, variant, dst.data(), src.data(), n};
+                double ns = time_per_iteration(loop, ms);
+                for (unsigned r = 0; r != 2; ++r)
+                    ns = std::min(ns, time_per_iteration(loop, ms));
+                point.gbps[v] = static_cast<double>(n) / ns;
+            }
+            points.push_back(point);
+        }
+    }
+
+    return points;
+}
+
+TuneTable tune_table(const TuneKey &key, const std::vector<TunePoint> &points)
+{
+    TuneTable table;
+    table.key = key;
+    for (std::size_t i = 0; i != points.size(); ++i) {
+        unsigned best = variant_count;
+        for (unsigned v = 0; v != variant_count; ++v)
+            if (points[i].gbps[v] > 0 &&
+                (best == variant_count ||
+                    points[i].gbps[v] > points[i].gbps[best]))
+                best = v;
+        if (best == variant_count)
+            continue;
+        TuneChoice choice = {points[i].primitive, points[i].bytes,
+            static_cast<Variant>(best), points[i].gbps[best]};
+        table.choices.push_back(choice);
+    }
+
+    return table;
+}
+
+bool save_tune_table(const std::string &path, const TuneTable &table)
+{
+    // Keep the entries of other keys
+    std::vector<std::string> kept;
+    std::ifstream in(path.c_str());
+    std::string line;
+    std::string ours(key_line(table.key));
+    bool skip = false;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 4, "key ") == 0)
+            skip = line == ours;
+        if (!skip && line.compare(0, 1, "#") != 0)
+            kept.push_back(line);
+    }
+    in.close();
+
+    std::string tmp(path + ".tmp");
+    std::ofstream out(tmp.c_str());
+    if (!out)
+        return false;
+    out << "# cpuid_info autotune cache: key, then the fastest variant for "
+           "sizes up to\n# each size in bytes and its GB/s\n";
+    for (std::size_t i = 0; i != kept.size(); ++i)
+        out << kept[i] << '\n';
+    out << ours << '\n';
+    for (std::size_t i = 0; i != table.choices.size(); ++i) {
+        const TuneChoice &choice = table.choices[i];
+        out << "choice " << primitive_name(choice.primitive) << ' '
+            << choice.bytes << ' ' << variant_name(choice.variant) << ' '
+            << choice.gbps << '\n';
+    }
+    out.close();
+    if (!out)
+        return false;
+
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+bool load_tune_table(
+    const std::string &path, const TuneKey &key, TuneTable &table)
+{
+    std::ifstream in(path.c_str());
+    if (!in)
+        return false;
+
+    std::string ours(key_line(key));
+    std::string line;
+    bool found = false;
+    bool inside = false;
+    table.key = key;
+    table.choices.clear();
+    while (std::getline(in, line)) {
+        if (line.compare(0, 4, "key ") == 0) {
+            if (found)
+                break;
+            inside = found = line == ours;
+            continue;
+        }
+        TuneChoice choice;
+        if (inside && parse_choice(line, choice))
+            table.choices.push_back(choice);
+    }
+
+    return found;
+}
+
+} // namespace cpuid_info
@@ -0,0 +1,126 @@
+#ifndef CPUID_INFO_AUTOTUNE_HPP
+#define CPUID_INFO_AUTOTUNE_HPP
+
+#include <cpuid_info/cpu_info.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief Primitives with several implementations to choose from
+enum class Primitive { Memcpy, Memset, Crc32c, Hash, Count };
+
+const unsigned primitive_count = static_cast<unsigned>(Primitive::Count);
+
+const char *primitive_name(Primitive primitive);
+
+/// \brief Implementations of a primitive
+enum class Variant {
+    Libc,    ///< std::memcpy or std::memset
+    Scalar,  ///< Plain C++ with 32 or 64-bit words
+    SSE2,
+    SSE42,   ///< The SSE4.2 CRC32 instruction
+    AVX2,
+    AVX512,
+    ERMS,    ///< rep movsb or rep stosb
+    Count
+};
+
+const unsigned variant_count = static_cast<unsigned>(Variant::Count);
+
+const char *variant_name(Variant variant);
+
+typedef void (*CopyKernel)(void *dst, const void *src, std::size_t n);
+typedef void (*FillKernel)(void *dst, int c, std::size_t n);
+typedef std::uint32_t (*Crc32cKernel)(
+    std::uint32_t crc, const void *data, std::size_t n);
+typedef std::uint32_t (*HashKernel)(const void *data, std::size_t n);
+
+/// \brief The implementation of a primitive, nullptr if the variant does
+/// not exist for it
+///
+/// \details
+/// Every variant of a primitive computes the same result: CRC32C with the
+/// Castagnoli polynomial (`crc` is the previous value, zero to start), and
+/// a 32-bit hash over sixteen interleaved xxHash32 style lanes.
+CopyKernel copy_kernel(Variant variant);
+FillKernel fill_kernel(Variant variant);
+Crc32cKernel crc32c_kernel(Variant variant);
+HashKernel hash_kernel(Variant variant);
+
+/// \brief True if the variant exists for the primitive and the features
+/// allow it to run
+bool variant_supported(
+    Primitive primitive, Variant variant, const Features &features);
+
+/// \brief Identifies CPUs that tune alike: leaf 0x01 EAX, ECX, EDX and leaf
+/// 0x07 EBX, ECX, EDX (leaf 0x01 EBX is skipped, it holds the APIC ID)
+struct TuneKey {
+    unsigned words[6];
+
+    bool operator==(const TuneKey &other) const;
+};
+
+TuneKey tune_key(const Snapshot &snapshot);
+
+/// \brief Throughput of every variant at one size, zero if unsupported
+struct TunePoint {
+    Primitive primitive;
+    std::size_t bytes;
+    double gbps[variant_count];
+};
+
+/// \brief The fastest variant for sizes up to `bytes`
+struct TuneChoice {
+    Primitive primitive;
+    std::size_t bytes;
+    Variant variant;
+    double gbps;
+};
+
+/// \brief Autotuning decisions for one CPU signature
+struct TuneTable {
+    TuneKey key;
+    std::vector<TuneChoice> choices;
+
+    /// \brief The variant to use for `bytes`, the first choice covering
+    /// it or the largest one; Libc for copies and Scalar otherwise if the
+    /// table has no choice for the primitive
+    Variant select(Primitive primitive, std::size_t bytes) const;
+};
+
+/// \brief Sizes measured by `autotune()`, 16 bytes to 4 MiB
+std::vector<std::size_t> tune_sizes();
+
+/// \brief Time every supported variant of every primitive on the calling
+/// thread at each of `tune_sizes()`
+///
+/// \details
+/// Source and destination stay in the caches the size fits in, as they do
+/// when the primitive is called in a loop. Each point is the best of three
+/// runs of at least `ms` milliseconds. Variants whose result differs from
+/// the first variant's are skipped.
+std::vector<TunePoint> autotune(const CpuInfo &info, double ms = 2);
+
+/// \brief The fastest variant at each measured size
+TuneTable tune_table(const TuneKey &key, const std::vector<TunePoint> &points);
+
+/// \brief Store a table in a cache file, replacing the entries of the same
+/// key and keeping those of other CPUs
+///
+/// \details
+/// The file is written to a temporary name and renamed, so processes
+/// loading it concurrently see either the old or the new file.
+bool save_tune_table(const std::string &path, const TuneTable &table);
+
+/// \brief Load the table of `key` from a cache file, false if the file
+/// cannot be read or has no entry for the key
+bool load_tune_table(
+    const std::string &path, const TuneKey &key, TuneTable &table);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_AUTOTUNE_HPP
@@ -0,0 +1,173 @@
+#include <cpuid_info/bench.hpp>
+#include <cpuid_info/xsave.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+// Dependent additions per iteration of add_chain()
+const unsigned long add_chain_length = 100;
+
+void add_chain(unsigned long iterations)
+{
+    unsigned long x = 0;
+    unsigned long one = 1;
+    for (unsigned long i = 0; i != iterations; ++i) {
+        // Register operands, recent cores fold chains of immediate adds
+        __asm__ volatile(".rept 100\n\t"
+                         "add %1, %0\n\t"
+                         ".endr"
+                         : "+r"(x)
+                         : "r"(one));
+    }
+    do_not_optimize(x);
+}
+
+} // namespace
+
+double core_ghz(double duration_ms)
+{
+    return static_cast<double>(add_chain_length) /
+        time_per_iteration(add_chain, duration_ms);
+}
+
+const char *simd_name(SimdLevel simd)
+{
+    switch (simd) {
+        case SimdLevel::AVX512:
+            return "AVX-512";
+        case SimdLevel::AVX2:
+            return "AVX2";
+        default:
+            return "SSE2";
+    }
+}
+
+SimdLevel select_simd(const Features &features)
+{
+    Features usable(usable_features(features, os_xcr0()));
+    if (usable.has(Feature::AVX512F))
+        return SimdLevel::AVX512;
+    if (usable.has(Feature::AVX2))
+        return SimdLevel::AVX2;
+
+    return SimdLevel::SSE2;
+}
+
+BenchBuffer::BenchBuffer(std::size_t bytes, PageSize pages)
+    : data_(0), size_(bytes), mapped_(0)
+{
+#if defined(__linux__)
+    std::size_t align = pages == PageSize::Huge1G
+        ? std::size_t(1) << 30
+        : (pages == PageSize::Small ? std::size_t(4096) : std::size_t(2) << 20);
+    mapped_ = (bytes + align - 1) / align * align;
+    if (mapped_ == 0)
+        mapped_ = align;
+
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_HUGETLB
+    if (pages == PageSize::Huge2M)
+        flags |= MAP_HUGETLB | (21 << MAP_HUGE_SHIFT);
+    if (pages == PageSize::Huge1G)
+        flags |= MAP_HUGETLB | (30 << MAP_HUGE_SHIFT);
+#else
+    if (pages == PageSize::Huge2M || pages == PageSize::Huge1G)
+        return;
+#endif
+
+    void *ptr = mmap(0, mapped_, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (ptr == MAP_FAILED)
+        return;
+#ifdef MADV_HUGEPAGE
+    if (pages == PageSize::Transparent)
+        madvise(ptr, mapped_, MADV_HUGEPAGE);
+    if (pages == PageSize::Small)
+        madvise(ptr, mapped_, MADV_NOHUGEPAGE);
+#endif
+    data_ = static_cast<char *>(ptr);
+#else
+    if (pages == PageSize::Huge2M || pages == PageSize::Huge1G)
+        return;
+    mapped_ = bytes;
+    data_ = static_cast<char *>(std::malloc(bytes == 0 ? 1 : bytes));
+#endif
+
+    // Fault every page in now rather than inside a timed loop
+    if (data_ != 0)
+        std::memset(data_, 0, mapped_);
+}
+
+BenchBuffer::~BenchBuffer()
+{
+#if defined(__linux__)
+    if (data_ != 0)
+        munmap(data_, mapped_);
+#else
+    std::free(data_);
+#endif
+}
+
+std::string format_bytes(double bytes)
+{
+    const char *suffix[] = {"", "K", "M", "G", "T"};
+    int i = 0;
+    while (bytes >= 1024 && i != 4) {
+        bytes /= 1024;
+        ++i;
+    }
+
+    // Three significant digits without switching to scientific notation
+    double scale = bytes < 10 ? 100 : (bytes < 100 ? 10 : 1);
+    std::stringstream ss;
+    ss << std::floor(bytes * scale + 0.5) / scale << suffix[i];
+
+    return ss.str();
+}
+
+bool parse_bytes(const std::string &str, std::size_t &bytes)
+{
+    char *end = 0;
+    double value = std::strtod(str.c_str(), &end);
+    if (end == str.c_str() || value < 0)
+        return false;
+
+    switch (*end) {
+        case '\0':
+            break;
+        case 'k':
+        case 'K':
+            value *= 1024.0;
+            ++end;
+            break;
+        case 'm':
+        case 'M':
+            value *= 1024.0 * 1024.0;
+            ++end;
+            break;
+        case 'g':
+        case 'G':
+            value *= 1024.0 * 1024.0 * 1024.0;
+            ++end;
+            break;
+        default:
+            return false;
+    }
+    if (*end != '\0')
+        return false;
+    bytes = static_cast<std::size_t>(value);
+
+    return true;
+}
+
+} // namespace cpuid_info
@@ -0,0 +1,107 @@
+#ifndef CPUID_INFO_BENCH_HPP
+#define CPUID_INFO_BENCH_HPP
+
+#include <cpuid_info/feature.hpp>
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace cpuid_info
+{
+
+typedef std::chrono::steady_clock bench_clock;
+
+/// \brief Nanoseconds elapsed since `start`
+inline double elapsed_ns(bench_clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(bench_clock::now() - start)
+        .count();
+}
+
+/// \brief Keep the compiler from optimizing away a computed value
+template <typename T>
+inline void do_not_optimize(const T &value)
+{
+    __asm__ volatile("" : : "r"(&value) : "memory");
+}
+
+/// \brief Nanoseconds per iteration of `f`
+///
+/// \details
+/// `f(iterations)` runs the measured operation `iterations` times. The
+/// count doubles from one until a run takes at least `ms` milliseconds,
+/// so clock resolution and call overhead do not matter, and that run is
+/// the result. `f` keeps its results alive with do_not_optimize().
+template <typename F>
+double time_per_iteration(F f, double ms)
+{
+    unsigned long iterations = 1;
+    while (true) {
+        bench_clock::time_point start = bench_clock::now();
+        f(iterations);
+        double ns = elapsed_ns(start);
+        if (ns >= ms * 1e6)
+            return ns / static_cast<double>(iterations);
+        iterations *= 2;
+    }
+}
+
+/// \brief Estimate the current core clock of the calling thread in GHz
+///
+/// \details
+/// Times a chain of dependent integer additions, each of which retires in
+/// exactly one core cycle on every x86 core, so the result reflects the
+/// actual clock rather than the nominal or TSC frequency.
+double core_ghz(double duration_ms = 10);
+
+/// \brief Vector instruction set used by the benchmark kernels
+enum class SimdLevel { SSE2, AVX2, AVX512 };
+
+const char *simd_name(SimdLevel simd);
+
+/// \brief The widest SIMD level supported by the features of leaves 0x01
+/// and 0x07 and enabled by the OS in XCR0 of the calling thread's CPU
+SimdLevel select_simd(const Features &features);
+
+/// \brief Page size backing a BenchBuffer
+enum class PageSize {
+    Small,        ///< 4 KiB pages, transparent huge pages disabled
+    Transparent,  ///< Transparent huge pages requested with madvise
+    Huge2M,       ///< Explicit 2 MiB hugetlb pages
+    Huge1G        ///< Explicit 1 GiB hugetlb pages
+};
+
+/// \brief A page aligned, pre-faulted benchmark buffer
+///
+/// \details
+/// On Linux the buffer is mapped with mmap so the page size can be chosen.
+/// Explicit huge pages need pages reserved in /proc/sys/vm/nr_hugepages (or
+/// the 1 GiB pool), `ok()` is false if the mapping failed.
+class BenchBuffer
+{
+    public:
+    BenchBuffer(std::size_t bytes, PageSize pages = PageSize::Transparent);
+    ~BenchBuffer();
+
+    bool ok() const { return data_ != 0; }
+    char *data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+    private:
+    char *data_;
+    std::size_t size_;
+    std::size_t mapped_;
+
+    BenchBuffer(const BenchBuffer &);
+    BenchBuffer &operator=(const BenchBuffer &);
+}; // class BenchBuffer
+
+/// \brief Format a byte count with a K/M/G suffix, e.g. "48K", "1.5M"
+std::string format_bytes(double bytes);
+
+/// \brief Parse a byte count with an optional K/M/G suffix
+bool parse_bytes(const std::string &str, std::size_t &bytes);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_BENCH_HPP
@@ -0,0 +1,324 @@
+#include <cpuid_info/affinity.hpp>
+#include <cpuid_info/bench_bandwidth.hpp>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <immintrin.h>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+// Kernels of one instruction set, each processes n doubles with n a
+// multiple of 4 vectors
+#define CPUID_INFO_BANDWIDTH_KERNELS(Name, isa, vec, w, load, store, stream,  \
+    set1, zero, add, mul)                                                     \
+    struct Name {                                                             \
+        __attribute__((target(isa))) static double read(                      \
+            const double *a, std::size_t n)                                   \
+        {                                                                     \
+            vec s0 = zero();                                                  \
+            vec s1 = zero();                                                  \
+            vec s2 = zero();                                                  \
+            vec s3 = zero();                                                  \
+            for (std::size_t i = 0; i != n; i += 4 * w) {                     \
+                s0 = add(s0, load(a + i));                                    \
+                s1 = add(s1, load(a + i + w));                                \
+                s2 = add(s2, load(a + i + 2 * w));                            \
+                s3 = add(s3, load(a + i + 3 * w));                            \
+            }                                                                 \
+            alignas(64) double tmp[w];                                        \
+            store(tmp, add(add(s0, s1), add(s2, s3)));                        \
+            double sum = 0;                                                   \
+            for (std::size_t i = 0; i != w; ++i)                              \
+                sum += tmp[i];                                                \
+                                                                              \
+            return sum;                                                       \
+        }                                                                     \
+                                                                              \
+        __attribute__((target(isa))) static void write(                       \
+            double *a, std::size_t n)                                         \
+        {                                                                     \
+            vec s = set1(1.0);                                                \
+            for (std::size_t i = 0; i != n; i += w)                           \
+                store(a + i, s);                                              \
+        }                                                                     \
+                                                                              \
+        __attribute__((target(isa))) static void copy(                        \
+            double *a, const double *b, std::size_t n)                        \
+        {                                                                     \
+            for (std::size_t i = 0; i != n; i += w)                           \
+                store(a + i, load(b + i));                                    \
+        }                                                                     \
+                                                                              \
+        __attribute__((target(isa))) static void triad(                       \
+            double *a, const double *b, const double *c, std::size_t n)       \
+        {                                                                     \
+            vec s = set1(3.0);                                                \
+            for (std::size_t i = 0; i != n; i += w)                           \
+                store(a + i, add(load(b + i), mul(s, load(c + i))));          \
+        }                                                                     \
+                                                                              \
+        __attribute__((target(isa))) static void write_nt(                    \
+            double *a, std::size_t n)                                         \
+        {                                                                     \
+            vec s = set1(1.0);                                                \
+            for (std::size_t i = 0; i != n; i += w)                           \
+                stream(a + i, s);                                             \
+            _mm_sfence();                                                     \
+        }                                                                     \
+                                                                              \
+        __attribute__((target(isa))) static void copy_nt(                     \
+            double *a, const double *b, std::size_t n)                        \
+        {                                                                     \
+            for (std::size_t i = 0; i != n; i += w)                           \
+                stream(a + i, load(b + i));                                   \
+            _mm_sfence();                                                     \
+        }                                                                     \
+    };
+
+CPUID_INFO_BANDWIDTH_KERNELS(KernelsSSE2, "sse2", __m128d, 2, _mm_load_pd,
+    _mm_store_pd, _mm_stream_pd, _mm_set1_pd, _mm_setzero_pd, _mm_add_pd,
+    _mm_mul_pd)
+CPUID_INFO_BANDWIDTH_KERNELS(KernelsAVX2, "avx2", __m256d, 4, _mm256_load_pd,
+    _mm256_store_pd, _mm256_stream_pd, _mm256_set1_pd, _mm256_setzero_pd,
+    _mm256_add_pd, _mm256_mul_pd)
+CPUID_INFO_BANDWIDTH_KERNELS(KernelsAVX512, "avx512f", __m512d, 8,
+    _mm512_load_pd, _mm512_store_pd, _mm512_stream_pd, _mm512_set1_pd,
+    _mm512_setzero_pd, _mm512_add_pd, _mm512_mul_pd)
+
+#undef CPUID_INFO_BANDWIDTH_KERNELS
+
+struct KernelSet {
+    double (*read)(const double *, std::size_t);
+    void (*write)(double *, std::size_t);
+    void (*copy)(double *, const double *, std::size_t);
+    void (*triad)(double *, const double *, const double *, std::size_t);
+    void (*write_nt)(double *, std::size_t);
+    void (*copy_nt)(double *, const double *, std::size_t);
+};
+
+template <typename K>
+KernelSet kernel_set()
+{
+    KernelSet set = {
+        K::read, K::write, K::copy, K::triad, K::write_nt, K::copy_nt};
+
+    return set;
+}
+
+// Bytes moved per element, as counted by STREAM
+const double kernel_bytes[bandwidth_kernel_count] = {8, 8, 16, 24, 8, 16};
+
+// Threads wait for the generation to change, run one kernel and count
+// themselves done
+struct Control {
+    std::atomic<unsigned> ready;
+    std::atomic<unsigned> generation;
+    std::atomic<unsigned> done;
+    std::atomic<bool> failed;
+    std::atomic<bool> unpinned;
+};
+
+inline void spin_until_changed(const std::atomic<unsigned> &value, unsigned old)
+{
+    while (value.load(std::memory_order_acquire) == old)
+        std::this_thread::yield();
+}
+
+void worker(int cpu, const KernelSet &kernels, std::size_t bytes,
+    unsigned rounds, Control &control)
+{
+    // An unpinned thread would measure some other CPU's share
+    if (!pin_this_thread(cpu)) {
+        control.unpinned.store(true);
+        control.failed.store(true);
+    }
+    BenchBuffer a(bytes);
+    BenchBuffer b(bytes);
+    BenchBuffer c(bytes);
+    if (!a.ok() || !b.ok() || !c.ok())
+        control.failed.store(true);
+
+    double *pa = reinterpret_cast<double *>(a.data());
+    double *pb = reinterpret_cast<double *>(b.data());
+    double *pc = reinterpret_cast<double *>(c.data());
+    std::size_t n = bytes / sizeof(double);
+    double sink = 0;
+
+    unsigned generation = control.generation.load();
+    control.ready.fetch_add(1);
+    for (unsigned r = 0; r != rounds; ++r) {
+        spin_until_changed(control.generation, generation);
+        generation = control.generation.load(std::memory_order_acquire);
+        if (!control.failed.load()) {
+            switch (static_cast<BandwidthKernel>(
+                r % bandwidth_kernel_count)) {
+                case BandwidthKernel::Read:
+                    sink += kernels.read(pa, n);
+                    break;
+                case BandwidthKernel::Write:
+                    kernels.write(pa, n);
+                    break;
+                case BandwidthKernel::Copy:
+                    kernels.copy(pa, pb, n);
+                    break;
+                case BandwidthKernel::Triad:
+                    kernels.triad(pa, pb, pc, n);
+                    break;
+                case BandwidthKernel::WriteNT:
+                    kernels.write_nt(pa, n);
+                    break;
+                default:
+                    kernels.copy_nt(pa, pb, n);
+                    break;
+            }
+        }
+        control.done.fetch_add(1, std::memory_order_acq_rel);
+    }
+    do_not_optimize(sink);
+}
+
+BandwidthSample measure_sample(const std::vector<int> &cpus, unsigned threads,
+    const KernelSet &kernels, std::size_t bytes, unsigned reps)
+{
+    BandwidthSample sample;
+    sample.threads = threads;
+    std::fill(sample.gbps, sample.gbps + bandwidth_kernel_count, 0.0);
+    sample.pinned = true;
+
+    Control control;
+    control.ready.store(0);
+    control.generation.store(0);
+    control.done.store(0);
+    control.failed.store(false);
+    control.unpinned.store(false);
+
+    // Repetitions are interleaved across kernels, round r runs kernel
+    // r % count
+    unsigned rounds = reps * bandwidth_kernel_count;
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t != threads; ++t) {
+        workers.push_back(std::thread(worker, cpus[t], std::cref(kernels),
+            bytes, rounds, std::ref(control)));
+    }
+    while (control.ready.load() != threads)
+        std::this_thread::yield();
+
+    std::size_t n = bytes / sizeof(double);
+    for (unsigned r = 0; r != rounds; ++r) {
+        bench_clock::time_point start = bench_clock::now();
+        control.generation.fetch_add(1, std::memory_order_acq_rel);
+        unsigned expected = threads * (r + 1);
+        while (control.done.load(std::memory_order_acquire) != expected)
+            std::this_thread::yield();
+        double ns = elapsed_ns(start);
+
+        unsigned k = r % bandwidth_kernel_count;
+        double gbps = kernel_bytes[k] * static_cast<double>(n) * threads / ns;
+        sample.gbps[k] = std::max(sample.gbps[k], gbps);
+    }
+
+    for (std::size_t t = 0; t != workers.size(); ++t)
+        workers[t].join();
+    if (control.failed.load())
+        std::fill(sample.gbps, sample.gbps + bandwidth_kernel_count, 0.0);
+    sample.pinned = !control.unpinned.load();
+
+    return sample;
+}
+
+} // namespace
+
+const char *bandwidth_kernel_name(BandwidthKernel kernel)
+{
+    switch (kernel) {
+        case BandwidthKernel::Read:
+            return "Read";
+        case BandwidthKernel::Write:
+            return "Write";
+        case BandwidthKernel::Copy:
+            return "Copy";
+        case BandwidthKernel::Triad:
+            return "Triad";
+        case BandwidthKernel::WriteNT:
+            return "Write NT";
+        case BandwidthKernel::CopyNT:
+            return "Copy NT";
+        default:
+            return "Unknown";
+    }
+}
+
+std::vector<unsigned> scaling_steps(unsigned n)
+{
+    std::vector<unsigned> steps;
+    for (unsigned t = 1; t < n; t *= 2) {
+        steps.push_back(t);
+        if (t >= 2 && t + t / 2 < n)
+            steps.push_back(t + t / 2);
+    }
+    if (n != 0)
+        steps.push_back(n);
+
+    return steps;
+}
+
+BandwidthScaling measure_bandwidth(const std::vector<int> &cpus,
+    const std::vector<unsigned> &steps, SimdLevel simd, std::size_t bytes,
+    unsigned reps)
+{
+    KernelSet kernels;
+    switch (simd) {
+        case SimdLevel::AVX512:
+            kernels = kernel_set<KernelsAVX512>();
+            break;
+        case SimdLevel::AVX2:
+            kernels = kernel_set<KernelsAVX2>();
+            break;
+        default:
+            kernels = kernel_set<KernelsSSE2>();
+            break;
+    }
+
+    BandwidthScaling scaling;
+    scaling.cpus = cpus;
+    for (std::size_t i = 0; i != steps.size(); ++i) {
+        if (steps[i] == 0 || steps[i] > cpus.size())
+            continue;
+
+        // Whole 4-vector blocks of the widest kernel
+        std::size_t per_thread = std::max<std::size_t>(
+            bytes / steps[i] / 256 * 256, std::size_t(4) << 20);
+        scaling.samples.push_back(
+            measure_sample(cpus, steps[i], kernels, per_thread, reps));
+    }
+
+    return scaling;
+}
+
+unsigned saturation_threads(const BandwidthScaling &scaling,
+    BandwidthKernel kernel, double fraction)
+{
+    double peak = peak_gbps(scaling, kernel);
+    unsigned k = static_cast<unsigned>(kernel);
+    for (std::size_t i = 0; i != scaling.samples.size(); ++i)
+        if (scaling.samples[i].gbps[k] >= peak * fraction)
+            return scaling.samples[i].threads;
+
+    return 0;
+}
+
+double peak_gbps(const BandwidthScaling &scaling, BandwidthKernel kernel)
+{
+    unsigned k = static_cast<unsigned>(kernel);
+    double peak = 0;
+    for (std::size_t i = 0; i != scaling.samples.size(); ++i)
+        peak = std::max(peak, scaling.samples[i].gbps[k]);
+
+    return peak;
+}
+
+} // namespace cpuid_info
@@ -0,0 +1,67 @@
+#ifndef CPUID_INFO_BENCH_BANDWIDTH_HPP
+#define CPUID_INFO_BENCH_BANDWIDTH_HPP
+
+#include <cpuid_info/bench.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief STREAM style kernels, bytes counted as in STREAM
+enum class BandwidthKernel {
+    Read,     ///< sum += a[i], 8 bytes per element
+    Write,    ///< a[i] = s, 8 bytes per element
+    Copy,     ///< a[i] = b[i], 16 bytes per element
+    Triad,    ///< a[i] = b[i] + s * c[i], 24 bytes per element
+    WriteNT,  ///< Write with non-temporal stores
+    CopyNT,   ///< Copy with non-temporal stores
+    Count
+};
+
+const unsigned bandwidth_kernel_count =
+    static_cast<unsigned>(BandwidthKernel::Count);
+
+const char *bandwidth_kernel_name(BandwidthKernel kernel);
+
+/// \brief Best bandwidth of each kernel with a given number of threads
+struct BandwidthSample {
+    unsigned threads;
+    double gbps[bandwidth_kernel_count];
+    bool pinned;  ///< false if a thread could not be pinned, nothing measured
+};
+
+/// \brief Bandwidth as threads are added in the order of `cpus`
+struct BandwidthScaling {
+    std::vector<int> cpus;
+    std::vector<BandwidthSample> samples;
+};
+
+/// \brief Thread counts 1, 2, 3, 4, 6, 8, 12, ... up to and including `n`
+std::vector<unsigned> scaling_steps(unsigned n);
+
+/// \brief Measure every kernel with the first `t` CPUs of `cpus`, for each
+/// `t` in `steps`
+///
+/// \details
+/// Each thread is pinned to its CPU and allocates its own arrays there, so
+/// pages are placed on the thread's NUMA node by first touch. If a thread
+/// cannot be pinned no kernel runs and the sample reads zero. The threads
+/// share `bytes` per array between them, but each array is at least 4 MiB.
+/// Threads start each repetition together and the best of `reps` wall
+/// clock times is reported.
+BandwidthScaling measure_bandwidth(const std::vector<int> &cpus,
+    const std::vector<unsigned> &steps, SimdLevel simd, std::size_t bytes,
+    unsigned reps = 3);
+
+/// \brief The smallest thread count reaching `fraction` of the peak
+/// bandwidth of a kernel
+unsigned saturation_threads(const BandwidthScaling &scaling,
+    BandwidthKernel kernel, double fraction = 0.95);
+
+/// \brief The peak bandwidth of a kernel over all thread counts
+double peak_gbps(const BandwidthScaling &scaling, BandwidthKernel kernel);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_BENCH_BANDWIDTH_HPP
@@ -0,0 +1,225 @@
+#include <cpuid_info/amx.hpp>
+#include <cpuid_info/bench_dot.hpp>
+#include <cpuid_info/xsave.hpp>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+#define CPUID_INFO_DOT_ZERO(i)                                                \
+    "vpxor %%xmm" #i ", %%xmm" #i ", %%xmm" #i "\n\t"
+
+// VEX encoded zeroing clears the upper ymm and zmm bits too
+#define CPUID_INFO_DOT_ZERO_ALL                                               \
+    CPUID_INFO_DOT_ZERO(0) CPUID_INFO_DOT_ZERO(1) CPUID_INFO_DOT_ZERO(2)      \
+    CPUID_INFO_DOT_ZERO(3) CPUID_INFO_DOT_ZERO(4) CPUID_INFO_DOT_ZERO(5)      \
+    CPUID_INFO_DOT_ZERO(6) CPUID_INFO_DOT_ZERO(7) CPUID_INFO_DOT_ZERO(8)      \
+    CPUID_INFO_DOT_ZERO(9) CPUID_INFO_DOT_ZERO(10) CPUID_INFO_DOT_ZERO(11)    \
+    CPUID_INFO_DOT_ZERO(12) CPUID_INFO_DOT_ZERO(13)
+
+// Accumulator i += dot(reg12, reg13)
+#define CPUID_INFO_DOT(op, r, i) op " %%" r "13, %%" r "12, %%" r #i "\n\t"
+
+#define CPUID_INFO_DOT_BLOCK(op, r)                                           \
+    CPUID_INFO_DOT(op, r, 0) CPUID_INFO_DOT(op, r, 1)                         \
+    CPUID_INFO_DOT(op, r, 2) CPUID_INFO_DOT(op, r, 3)                         \
+    CPUID_INFO_DOT(op, r, 4) CPUID_INFO_DOT(op, r, 5)                         \
+    CPUID_INFO_DOT(op, r, 6) CPUID_INFO_DOT(op, r, 7)                         \
+    CPUID_INFO_DOT(op, r, 8) CPUID_INFO_DOT(op, r, 9)                         \
+    CPUID_INFO_DOT(op, r, 10) CPUID_INFO_DOT(op, r, 11)
+
+// n iterations of 48 instructions
+#define CPUID_INFO_DOT_VECTOR(name, op, r)                                    \
+    void name(unsigned long n)                                                \
+    {                                                                         \
+        __asm__ volatile(CPUID_INFO_DOT_ZERO_ALL                              \
+                         "1:\n\t"                                             \
+                         ".rept 4\n\t" CPUID_INFO_DOT_BLOCK(op, r)            \
+                         ".endr\n\t"                                          \
+                         "dec %0\n\t"                                         \
+                         "jnz 1b\n\t"                                         \
+                         "vzeroupper"                                         \
+                         : "+r"(n)                                            \
+                         :                                                    \
+                         : "cc", "xmm0", "xmm1", "xmm2", "xmm3", "xmm4",      \
+                         "xmm5", "xmm6", "xmm7", "xmm8", "xmm9", "xmm10",     \
+                         "xmm11", "xmm12", "xmm13");                          \
+    }
+
+// Braces are escaped, they select assembler dialects in extended asm
+CPUID_INFO_DOT_VECTOR(avx_vnni, "%{vex%} vpdpbusd", "ymm")
+CPUID_INFO_DOT_VECTOR(avx512_vnni, "vpdpbusd", "zmm")
+CPUID_INFO_DOT_VECTOR(avx512_bf16, "vdpbf16ps", "zmm")
+
+// Tiles 0-3 accumulate, 4 and 5 are the inputs
+#define CPUID_INFO_DOT_TILES(op)                                              \
+    op " %%tmm5, %%tmm4, %%tmm0\n\t" op " %%tmm5, %%tmm4, %%tmm1\n\t"         \
+    op " %%tmm5, %%tmm4, %%tmm2\n\t" op " %%tmm5, %%tmm4, %%tmm3\n\t"
+
+// The LDTILECFG operand of palette 1
+struct TileConfig {
+    unsigned char palette;
+    unsigned char start_row;
+    unsigned char reserved[14];
+    unsigned short colsb[16];
+    unsigned char rows[16];
+};
+
+static_assert(sizeof(TileConfig) == 64, "TileConfig is not 64 bytes");
+
+// Rows and row bytes of every tile, the largest palette 1 allows on the
+// first AMX cores
+const unsigned tile_rows = 16;
+const unsigned tile_colsb = 64;
+
+// n iterations of 16 instructions
+#define CPUID_INFO_DOT_AMX(name, op)                                          \
+    void name(unsigned long n)                                                \
+    {                                                                         \
+        TileConfig config = TileConfig();                                     \
+        config.palette = 1;                                                   \
+        for (unsigned t = 0; t != 6; ++t) {                                   \
+            config.colsb[t] = tile_colsb;                                     \
+            config.rows[t] = tile_rows;                                       \
+        }                                                                     \
+        __asm__ volatile("ldtilecfg %1\n\t"                                   \
+                         "tilezero %%tmm0\n\t"                                \
+                         "tilezero %%tmm1\n\t"                                \
+                         "tilezero %%tmm2\n\t"                                \
+                         "tilezero %%tmm3\n\t"                                \
+                         "tilezero %%tmm4\n\t"                                \
+                         "tilezero %%tmm5\n\t"                                \
+                         "1:\n\t"                                             \
+                         ".rept 4\n\t" CPUID_INFO_DOT_TILES(op)               \
+                         ".endr\n\t"                                          \
+                         "dec %0\n\t"                                         \
+                         "jnz 1b\n\t"                                         \
+                         "tilerelease"                                        \
+                         : "+r"(n)                                            \
+                         : "m"(config)                                        \
+                         : "cc");                                             \
+    }
+
+CPUID_INFO_DOT_AMX(amx_int8, "tdpbssd")
+CPUID_INFO_DOT_AMX(amx_bf16, "tdpbf16ps")
+
+#undef CPUID_INFO_DOT_AMX
+#undef CPUID_INFO_DOT_TILES
+#undef CPUID_INFO_DOT_VECTOR
+#undef CPUID_INFO_DOT_BLOCK
+#undef CPUID_INFO_DOT
+#undef CPUID_INFO_DOT_ZERO_ALL
+#undef CPUID_INFO_DOT_ZERO
+
+struct KernelInfo {
+    void (*run)(unsigned long);
+    double macs;  ///< Multiply-adds per iteration
+};
+
+KernelInfo kernel_info(DotKernel kernel)
+{
+    // Products per instruction: bytes per vector for INT8, half of them
+    // for BF16; rows x columns x K for tiles
+    const double amx_int8_macs = tile_rows * (tile_colsb / 4) * tile_colsb;
+    KernelInfo info = {avx_vnni, 48 * 32};
+    switch (kernel) {
+        case DotKernel::Avx512Vnni:
+            info.run = avx512_vnni;
+            info.macs = 48 * 64;
+            break;
+        case DotKernel::Avx512Bf16:
+            info.run = avx512_bf16;
+            info.macs = 48 * 32;
+            break;
+        case DotKernel::AmxInt8:
+            info.run = amx_int8;
+            info.macs = 16 * amx_int8_macs;
+            break;
+        case DotKernel::AmxBf16:
+            info.run = amx_bf16;
+            info.macs = 16 * amx_int8_macs / 2;
+            break;
+        default:
+            break;
+    }
+
+    return info;
+}
+
+} // namespace
+
+const char *dot_kernel_name(DotKernel kernel)
+{
+    switch (kernel) {
+        case DotKernel::AvxVnni:
+            return "AVX-VNNI";
+        case DotKernel::Avx512Vnni:
+            return "AVX512-VNNI";
+        case DotKernel::Avx512Bf16:
+            return "AVX512-BF16";
+        case DotKernel::AmxInt8:
+            return "AMX-INT8";
+        case DotKernel::AmxBf16:
+            return "AMX-BF16";
+        default:
+            return "Unknown";
+    }
+}
+
+const char *dot_type_name(DotType type)
+{
+    return type == DotType::Int8 ? "INT8" : "BF16";
+}
+
+DotType dot_kernel_type(DotKernel kernel)
+{
+    return kernel == DotKernel::Avx512Bf16 || kernel == DotKernel::AmxBf16
+        ? DotType::Bf16
+        : DotType::Int8;
+}
+
+bool dot_kernel_supported(DotKernel kernel, const Features &features)
+{
+    SimdLevel simd = select_simd(features);
+    Features usable(usable_features(features, os_xcr0()));
+    switch (kernel) {
+        case DotKernel::AvxVnni:
+            return simd != SimdLevel::SSE2 && features.has(Feature::AVX_VNNI);
+        case DotKernel::Avx512Vnni:
+            return simd == SimdLevel::AVX512 &&
+                features.has(Feature::AVX512VNNI);
+        case DotKernel::Avx512Bf16:
+            return simd == SimdLevel::AVX512 &&
+                features.has(Feature::AVX512BF16);
+        case DotKernel::AmxInt8:
+            return usable.has(Feature::AMX_TILE) &&
+                usable.has(Feature::AMX_INT8);
+        case DotKernel::AmxBf16:
+            return usable.has(Feature::AMX_TILE) &&
+                usable.has(Feature::AMX_BF16);
+        default:
+            return false;
+    }
+}
+
+DotSample measure_dot(DotKernel kernel, double ms)
+{
+    DotSample sample;
+    sample.kernel = kernel;
+    sample.ok = true;
+    sample.gops = 0;
+    if (kernel == DotKernel::AmxInt8 || kernel == DotKernel::AmxBf16) {
+        sample.ok = request_amx_permission();
+        if (!sample.ok)
+            return sample;
+    }
+
+    KernelInfo info(kernel_info(kernel));
+    sample.gops = 2 * info.macs / time_per_iteration(info.run, ms);
+
+    return sample;
+}
+
+} // namespace cpuid_info
@@ -0,0 +1,55 @@
+#ifndef CPUID_INFO_BENCH_DOT_HPP
+#define CPUID_INFO_BENCH_DOT_HPP
+
+#include <cpuid_info/bench.hpp>
+
+namespace cpuid_info
+{
+
+/// \brief Low precision dot product instructions
+enum class DotKernel {
+    AvxVnni,     ///< {vex} vpdpbusd on ymm, u8 x s8 into s32
+    Avx512Vnni,  ///< vpdpbusd on zmm
+    Avx512Bf16,  ///< vdpbf16ps on zmm, bf16 pairs into fp32
+    AmxInt8,     ///< tdpbssd on 16 x 64 byte tiles
+    AmxBf16,     ///< tdpbf16ps on 16 x 64 byte tiles
+    Count
+};
+
+const unsigned dot_kernel_count = static_cast<unsigned>(DotKernel::Count);
+
+const char *dot_kernel_name(DotKernel kernel);
+
+/// \brief Element type of the inputs of a kernel
+enum class DotType { Int8, Bf16 };
+
+const char *dot_type_name(DotType type);
+
+DotType dot_kernel_type(DotKernel kernel);
+
+/// \brief True if the features allow the kernel to run
+///
+/// \details
+/// AMX kernels also need the permission of the OS, which `measure_dot()`
+/// requests.
+bool dot_kernel_supported(DotKernel kernel, const Features &features);
+
+struct DotSample {
+    DotKernel kernel;
+    bool ok;      ///< False if AMX is not enabled by the OS
+    double gops;  ///< Multiplies and adds per second, in billions
+};
+
+/// \brief Time the kernel on the calling thread for at least `ms`
+/// milliseconds
+///
+/// \details
+/// Like the FMA kernels the operands stay in registers: twelve independent
+/// vector accumulators, or four accumulator tiles sharing two input tiles,
+/// so the result is the peak throughput of the instruction rather than of
+/// the caches feeding it. A multiply and add count as two operations.
+DotSample measure_dot(DotKernel kernel, double ms = 100);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_BENCH_DOT_HPP
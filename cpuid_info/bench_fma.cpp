@@ -0,0 +1,391 @@
+#include <cpuid_info/affinity.hpp>
+#include <cpuid_info/bench_fma.hpp>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+// FMAs per loop iteration of the kernels, four blocks of twelve
+const unsigned long fma_per_iteration = 48;
+
+#define CPUID_INFO_FMA_ZERO(i)                                                \
+    "vxorpd %%xmm" #i ", %%xmm" #i ", %%xmm" #i "\n\t"
+
+// VEX encoded zeroing clears the upper ymm and zmm bits too
+#define CPUID_INFO_FMA_ZERO_ALL                                               \
+    CPUID_INFO_FMA_ZERO(0) CPUID_INFO_FMA_ZERO(1) CPUID_INFO_FMA_ZERO(2)      \
+    CPUID_INFO_FMA_ZERO(3) CPUID_INFO_FMA_ZERO(4) CPUID_INFO_FMA_ZERO(5)      \
+    CPUID_INFO_FMA_ZERO(6) CPUID_INFO_FMA_ZERO(7) CPUID_INFO_FMA_ZERO(8)      \
+    CPUID_INFO_FMA_ZERO(9) CPUID_INFO_FMA_ZERO(10) CPUID_INFO_FMA_ZERO(11)    \
+    CPUID_INFO_FMA_ZERO(12) CPUID_INFO_FMA_ZERO(13)
+
+// Accumulator i += reg12 * reg13
+#define CPUID_INFO_FMA(op, r, i) op " %%" r "13, %%" r "12, %%" r #i "\n\t"
+
+// The same, followed by one addition of the dependent chain
+#define CPUID_INFO_FMA_ADD(op, r, i) CPUID_INFO_FMA(op, r, i) "add %2, %1\n\t"
+
+#define CPUID_INFO_FMA_BLOCK(F, op, r)                                        \
+    F(op, r, 0) F(op, r, 1) F(op, r, 2) F(op, r, 3) F(op, r, 4) F(op, r, 5)   \
+    F(op, r, 6) F(op, r, 7) F(op, r, 8) F(op, r, 9) F(op, r, 10)              \
+    F(op, r, 11)
+
+#define CPUID_INFO_FMA_CLOBBERS                                               \
+    "cc", "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5", "xmm6", "xmm7",     \
+        "xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13"
+
+// Kernels of one width. The operands stay in registers (zeros, which every
+// FMA unit handles at full speed) so the loops run at the same speed at any
+// optimization level. `peak` runs n iterations of 48 independent FMAs,
+// `mixed` interleaves them with 48 dependent additions and returns the sum.
+#define CPUID_INFO_FMA_KERNELS(Name, op, r)                                   \
+    struct Name {                                                             \
+        static void peak(unsigned long n)                                     \
+        {                                                                     \
+            __asm__ volatile(CPUID_INFO_FMA_ZERO_ALL                          \
+                             "1:\n\t"                                         \
+                             ".rept 4\n\t"                                    \
+                             CPUID_INFO_FMA_BLOCK(CPUID_INFO_FMA, op, r)      \
+                             ".endr\n\t"                                      \
+                             "dec %0\n\t"                                     \
+                             "jnz 1b\n\t"                                     \
+                             "vzeroupper"                                     \
+                             : "+r"(n)                                        \
+                             :                                                \
+                             : CPUID_INFO_FMA_CLOBBERS);                      \
+        }                                                                     \
+                                                                              \
+        static unsigned long mixed(unsigned long n)                           \
+        {                                                                     \
+            unsigned long x = 0;                                              \
+            unsigned long one = 1;                                            \
+            __asm__ volatile(CPUID_INFO_FMA_ZERO_ALL                          \
+                             "1:\n\t"                                         \
+                             ".rept 4\n\t"                                    \
+                             CPUID_INFO_FMA_BLOCK(CPUID_INFO_FMA_ADD, op, r)  \
+                             ".endr\n\t"                                      \
+                             "dec %0\n\t"                                     \
+                             "jnz 1b\n\t"                                     \
+                             "vzeroupper"                                     \
+                             : "+r"(n), "+r"(x)                               \
+                             : "r"(one)                                       \
+                             : CPUID_INFO_FMA_CLOBBERS);                      \
+                                                                              \
+            return x;                                                         \
+        }                                                                     \
+    };
+
+CPUID_INFO_FMA_KERNELS(KernelsScalar, "vfmadd231sd", "xmm")
+CPUID_INFO_FMA_KERNELS(KernelsVec256, "vfmadd231pd", "ymm")
+CPUID_INFO_FMA_KERNELS(KernelsVec512, "vfmadd231pd", "zmm")
+
+#undef CPUID_INFO_FMA_KERNELS
+#undef CPUID_INFO_FMA_CLOBBERS
+#undef CPUID_INFO_FMA_BLOCK
+#undef CPUID_INFO_FMA_ADD
+#undef CPUID_INFO_FMA
+#undef CPUID_INFO_FMA_ZERO_ALL
+#undef CPUID_INFO_FMA_ZERO
+
+struct KernelSet {
+    void (*peak)(unsigned long);
+    unsigned long (*mixed)(unsigned long);
+};
+
+template <typename K>
+KernelSet kernel_set()
+{
+    KernelSet set = {K::peak, K::mixed};
+
+    return set;
+}
+
+KernelSet fma_kernels(FmaWidth width)
+{
+    switch (width) {
+        case FmaWidth::Vec512:
+            return kernel_set<KernelsVec512>();
+        case FmaWidth::Vec256:
+            return kernel_set<KernelsVec256>();
+        default:
+            return kernel_set<KernelsScalar>();
+    }
+}
+
+// Workers wait for Warm, run until Measure without counting, then count
+// iterations until Stop
+enum class Phase { Wait, Warm, Measure, Stop };
+
+struct Control {
+    std::atomic<unsigned> ready;
+    std::atomic<int> phase;
+    std::atomic<bool> unpinned;
+};
+
+inline Phase load_phase(const Control &control)
+{
+    return static_cast<Phase>(control.phase.load(std::memory_order_acquire));
+}
+
+inline void set_phase(Control &control, Phase phase)
+{
+    control.phase.store(static_cast<int>(phase), std::memory_order_release);
+}
+
+// Iterations between checks of the phase, about 10 us of throughput code
+const unsigned long slice_iterations = 1000;
+
+// Stores FMAs, or dependent additions with `mixed`, per nanosecond
+void worker(int cpu, FmaWidth width, bool mixed, Control &control,
+    double &per_ns)
+{
+    // Runs anyway so the phases advance, the caller discards the result
+    if (!pin_this_thread(cpu))
+        control.unpinned.store(true);
+    KernelSet kernels(fma_kernels(width));
+    control.ready.fetch_add(1);
+    while (load_phase(control) == Phase::Wait)
+        std::this_thread::yield();
+    while (load_phase(control) == Phase::Warm)
+        kernels.peak(slice_iterations);
+
+    unsigned long slices = 0;
+    unsigned long sink = 0;
+    bench_clock::time_point start = bench_clock::now();
+    while (load_phase(control) == Phase::Measure) {
+        if (mixed)
+            sink += kernels.mixed(slice_iterations);
+        else
+            kernels.peak(slice_iterations);
+        ++slices;
+    }
+    double ns = elapsed_ns(start);
+    do_not_optimize(sink);
+
+    per_ns = static_cast<double>(slices * slice_iterations *
+                 fma_per_iteration) / ns;
+}
+
+// Operations per nanosecond of each thread, `pinned` is false if a thread
+// could not be pinned
+std::vector<double> run_workers(const std::vector<int> &cpus, FmaWidth width,
+    bool mixed, double ms, bool &pinned)
+{
+    std::vector<double> per_ns(cpus.size(), 0.0);
+    Control control;
+    control.ready.store(0);
+    control.unpinned.store(false);
+    set_phase(control, Phase::Wait);
+
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t != cpus.size(); ++t) {
+        workers.push_back(std::thread(worker, cpus[t], width, mixed,
+            std::ref(control), std::ref(per_ns[t])));
+    }
+    while (control.ready.load() != cpus.size())
+        std::this_thread::yield();
+
+    // Long enough to take the license and finish the transition
+    set_phase(control, Phase::Warm);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    set_phase(control, Phase::Measure);
+    std::this_thread::sleep_for(
+        std::chrono::microseconds(static_cast<long>(ms * 1000)));
+    set_phase(control, Phase::Stop);
+
+    for (std::size_t t = 0; t != workers.size(); ++t)
+        workers[t].join();
+    pinned = !control.unpinned.load();
+
+    return per_ns;
+}
+
+// Clock sample of one short run of the mixed kernel
+struct ClockSample {
+    double t_ns;  ///< Since the start of the phase
+    double ghz;
+};
+
+// Iterations per clock sample, about five thousand cycles
+const unsigned long sample_iterations = 100;
+
+// Median clock of every 50 us bin of a phase
+std::vector<double> run_phase(const KernelSet &kernels, double ms)
+{
+    std::vector<ClockSample> samples;
+    samples.reserve(static_cast<std::size_t>(ms * 4000));
+    unsigned long sink = 0;
+    bench_clock::time_point phase_start = bench_clock::now();
+    double end_ns = ms * 1e6;
+    double t_ns = 0;
+    while (t_ns < end_ns) {
+        sink += kernels.mixed(sample_iterations);
+        double now_ns = elapsed_ns(phase_start);
+        ClockSample sample = {t_ns, static_cast<double>(sample_iterations *
+                                        fma_per_iteration) / (now_ns - t_ns)};
+        samples.push_back(sample);
+        t_ns = now_ns;
+    }
+    do_not_optimize(sink);
+
+    const double bin_ns = 50e3;
+    std::vector<double> bins;
+    std::vector<double> ghz;
+    std::size_t i = 0;
+    while (i != samples.size()) {
+        double bin_end = (static_cast<double>(bins.size()) + 1) * bin_ns;
+        ghz.clear();
+        for (; i != samples.size() && samples[i].t_ns < bin_end; ++i)
+            ghz.push_back(samples[i].ghz);
+        if (ghz.empty()) {
+            bins.push_back(bins.empty() ? 0.0 : bins.back());
+            continue;
+        }
+        std::nth_element(ghz.begin(), ghz.begin() + ghz.size() / 2, ghz.end());
+        bins.push_back(ghz[ghz.size() / 2]);
+    }
+
+    return bins;
+}
+
+double median(std::vector<double> values)
+{
+    if (values.empty())
+        return 0;
+    std::nth_element(
+        values.begin(), values.begin() + values.size() / 2, values.end());
+
+    return values[values.size() / 2];
+}
+
+// Settled clock of a phase, the median of its second half, and the time it
+// took to get there: the first three bins whose median is within 3%
+void settle(const std::vector<double> &bins, double &ghz, double &us)
+{
+    std::size_t half = bins.size() / 2;
+    ghz = median(std::vector<double>(bins.begin() + half, bins.end()));
+    std::size_t settled = half;
+    for (std::size_t i = 0; i + 3 <= half; ++i) {
+        double window = median(
+            std::vector<double>(bins.begin() + i, bins.begin() + i + 3));
+        if (window >= ghz * 0.97 && window <= ghz * 1.03) {
+            settled = i;
+            break;
+        }
+    }
+    us = static_cast<double>(settled) * 50;
+}
+
+} // namespace
+
+const char *fma_width_name(FmaWidth width)
+{
+    switch (width) {
+        case FmaWidth::Scalar:
+            return "Scalar";
+        case FmaWidth::Vec256:
+            return "AVX2";
+        case FmaWidth::Vec512:
+            return "AVX-512";
+        default:
+            return "Unknown";
+    }
+}
+
+unsigned fma_width_lanes(FmaWidth width)
+{
+    switch (width) {
+        case FmaWidth::Vec256:
+            return 4;
+        case FmaWidth::Vec512:
+            return 8;
+        default:
+            return 1;
+    }
+}
+
+bool fma_width_supported(FmaWidth width, const Features &features)
+{
+    // Every width is VEX or EVEX encoded, which needs the OS to save ymm
+    SimdLevel simd = select_simd(features);
+    if (!features.has(Feature::FMA) || simd == SimdLevel::SSE2)
+        return false;
+
+    return width != FmaWidth::Vec512 || simd == SimdLevel::AVX512;
+}
+
+FmaSample measure_fma(const std::vector<int> &cpus, FmaWidth width, double ms)
+{
+    FmaSample sample;
+    sample.width = width;
+    sample.threads = static_cast<unsigned>(cpus.size());
+    sample.gflops = 0;
+    sample.ghz = 0;
+    sample.pinned = true;
+    if (cpus.empty())
+        return sample;
+
+    std::vector<double> fma(
+        run_workers(cpus, width, false, ms, sample.pinned));
+    if (!sample.pinned)
+        return sample;
+    std::vector<double> adds(
+        run_workers(cpus, width, true, ms, sample.pinned));
+    if (!sample.pinned)
+        return sample;
+    double flops_per_fma = 2.0 * fma_width_lanes(width);
+    for (std::size_t t = 0; t != cpus.size(); ++t) {
+        sample.gflops += fma[t] * flops_per_fma;
+        sample.ghz += adds[t];
+    }
+    sample.ghz /= static_cast<double>(cpus.size());
+
+    return sample;
+}
+
+LicenseTransition measure_license_transition(FmaWidth width, double phase_ms)
+{
+    KernelSet light(fma_kernels(FmaWidth::Scalar));
+    KernelSet heavy(fma_kernels(width));
+    std::vector<double> before(run_phase(light, phase_ms));
+    std::vector<double> during(run_phase(heavy, phase_ms));
+    std::vector<double> after(run_phase(light, phase_ms));
+
+    LicenseTransition transition;
+    transition.width = width;
+    double ignored = 0;
+    double exit_ghz = 0;
+    settle(before, transition.base_ghz, ignored);
+    settle(during, transition.heavy_ghz, transition.enter_us);
+    settle(after, exit_ghz, transition.exit_us);
+
+    return transition;
+}
+
+WideVerdict wide_vector_verdict(
+    const FmaSample &vec256, const FmaSample &vec512)
+{
+    WideVerdict verdict;
+    verdict.speedup = vec256.gflops > 0 ? vec512.gflops / vec256.gflops : 0;
+    verdict.clock_ratio = vec256.ghz > 0 ? vec512.ghz / vec256.ghz : 0;
+
+    // Solve (1 - v) / c + v / s = 1 for v
+    double s = verdict.speedup;
+    double c = verdict.clock_ratio;
+    if (s <= 1 || c <= 0)
+        verdict.break_even = 1;
+    else if (c >= 1)
+        verdict.break_even = 0;
+    else
+        verdict.break_even = std::min(1.0, (1 / c - 1) / (1 / c - 1 / s));
+    verdict.net_win = verdict.break_even < 0.5;
+
+    return verdict;
+}
+
+} // namespace cpuid_info
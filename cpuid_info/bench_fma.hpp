@@ -0,0 +1,99 @@
+#ifndef CPUID_INFO_BENCH_FMA_HPP
+#define CPUID_INFO_BENCH_FMA_HPP
+
+#include <cpuid_info/bench.hpp>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief Operand width of the double precision FMA kernels
+enum class FmaWidth {
+    Scalar,  ///< vfmadd231sd, one lane
+    Vec256,  ///< vfmadd231pd on ymm registers, four lanes
+    Vec512,  ///< vfmadd231pd on zmm registers, eight lanes
+    Count
+};
+
+const unsigned fma_width_count = static_cast<unsigned>(FmaWidth::Count);
+
+const char *fma_width_name(FmaWidth width);
+
+/// \brief Doubles per FMA instruction
+unsigned fma_width_lanes(FmaWidth width);
+
+/// \brief True if the CPU and OS support the FMA instructions of a width
+bool fma_width_supported(FmaWidth width, const Features &features);
+
+/// \brief Throughput and clock of one width, run on every CPU at once
+struct FmaSample {
+    FmaWidth width;
+    unsigned threads;
+    double gflops;  ///< Sum over all threads
+    double ghz;     ///< Average effective clock of the threads
+    bool pinned;    ///< false if a thread could not be pinned, both zero
+};
+
+/// \brief Run the FMA kernel of `width` on each of `cpus` at once for `ms`
+/// milliseconds after a warm-up
+///
+/// \details
+/// The throughput kernel keeps twelve independent accumulators, enough to
+/// fill two FMA ports of latency four with room to spare. The clock is
+/// measured in a second run that interleaves the same FMAs with a chain of
+/// dependent integer additions: the chain is the critical path, one cycle
+/// per addition, as long as the core issues at least one FMA per cycle, so
+/// the FMA density is at least half the peak and the core runs under the
+/// same frequency license. Threads that cannot be pinned may share a core,
+/// which would skew both the sum and the clock, so nothing is reported.
+FmaSample measure_fma(
+    const std::vector<int> &cpus, FmaWidth width, double ms = 200);
+
+/// \brief Time the calling thread takes to enter and leave the frequency
+/// license of a width
+struct LicenseTransition {
+    FmaWidth width;
+    double base_ghz;   ///< Settled clock of scalar code before the burst
+    double heavy_ghz;  ///< Settled clock during the burst
+    double enter_us;   ///< Until the clock settles after the burst starts
+    double exit_us;    ///< Until the clock settles after the burst stops
+};
+
+/// \brief Run scalar, `width` and scalar FMA code for `phase_ms` each and
+/// sample the effective clock every few hundred cycles
+///
+/// \details
+/// Samples are grouped into 50 us bins, each bin taking the median sample
+/// so interrupts do not count as slow bins. A phase has settled at the
+/// first three bins whose median is within 3% of the median of its second
+/// half. Entering a license includes the period during which the core
+/// throttles wide instructions while the voltage rises. Pin the calling
+/// thread first; under a hypervisor the host's own clock changes add
+/// noise.
+LicenseTransition measure_license_transition(
+    FmaWidth width, double phase_ms = 20);
+
+/// \brief Whether 512-bit code pays for the clock it costs
+struct WideVerdict {
+    double speedup;      ///< 512-bit over 256-bit FLOP/s
+    double clock_ratio;  ///< 512-bit over 256-bit clock
+
+    /// \brief Share of run time vector loops need for 512-bit code to be
+    /// faster overall, one if it never is
+    double break_even;
+
+    bool net_win;  ///< Break even below half of the run time
+};
+
+/// \brief Compare samples taken with the same threads
+///
+/// \details
+/// Code spending a share v of its time in 256-bit vector loops runs the
+/// rest of the time at the lower clock once its loops use 512 bits: it
+/// gains if (1 - v) / clock_ratio + v / speedup is below one.
+WideVerdict wide_vector_verdict(
+    const FmaSample &vec256, const FmaSample &vec512);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_BENCH_FMA_HPP
@@ -0,0 +1,183 @@
+#include <cpuid_info/affinity.hpp>
+#include <cpuid_info/bench.hpp>
+#include <cpuid_info/bench_kernel.hpp>
+#include <thread>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+#if defined(__linux__)
+void getppid_loop(unsigned long iterations)
+{
+    long sum = 0;
+    for (unsigned long i = 0; i != iterations; ++i)
+        sum += ::syscall(SYS_getppid);
+    do_not_optimize(sum);
+}
+
+void close_pipe(int fds[2])
+{
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+// Both ends of two pipes, closed on destruction
+struct PipePair {
+    int ping[2];
+    int pong[2];
+    bool ok;
+
+    PipePair() : ok(false)
+    {
+        if (::pipe(ping) != 0)
+            return;
+        if (::pipe(pong) != 0) {
+            close_pipe(ping);
+            return;
+        }
+        ok = true;
+    }
+
+    ~PipePair()
+    {
+        if (ok) {
+            close_pipe(ping);
+            close_pipe(pong);
+        }
+    }
+};
+
+// A zero byte stops the echo thread
+void stop_echo(const PipePair *pipes)
+{
+    char c = 0;
+    if (::write(pipes->ping[1], &c, 1) != 1)
+        return;
+}
+
+// Echo every byte back until a zero arrives, also if pinning failed so the
+// driving thread does not block
+void echo(const PipePair *pipes, int cpu, bool *pinned)
+{
+    *pinned = pin_this_thread(cpu);
+    char c = 1;
+    while (::read(pipes->ping[0], &c, 1) == 1 && c != 0)
+        if (::write(pipes->pong[1], &c, 1) != 1)
+            break;
+}
+
+bool round_trip(const PipePair *pipes)
+{
+    char c = 1;
+    return ::write(pipes->ping[1], &c, 1) == 1 &&
+        ::read(pipes->pong[0], &c, 1) == 1;
+}
+
+// Send bytes and wait for each to come back for at least `ms`
+void drive(const PipePair *pipes, int cpu, double ms, double *ns_per_switch)
+{
+    *ns_per_switch = 0;
+    bool ok = pin_this_thread(cpu);
+
+    // Let the echo thread block on its read first
+    for (unsigned i = 0; ok && i != 100; ++i)
+        ok = round_trip(pipes);
+
+    unsigned long rounds = 0;
+    bench_clock::time_point start = bench_clock::now();
+    double ns = 0;
+    while (ok && ns < ms * 1e6) {
+        for (unsigned i = 0; ok && i != 256; ++i)
+            ok = round_trip(pipes);
+        rounds += 256;
+        ns = elapsed_ns(start);
+    }
+    stop_echo(pipes);
+
+    // Each round trip switches to the echo thread and back
+    if (ok)
+        *ns_per_switch = ns / static_cast<double>(2 * rounds);
+}
+#endif
+
+} // namespace
+
+double measure_syscall_ns(double ms)
+{
+#if defined(__linux__)
+    return time_per_iteration(getppid_loop, ms);
+#else
+    static_cast<void>(ms);
+
+    return 0;
+#endif
+}
+
+double measure_context_switch_ns(int cpu, double ms)
+{
+#if defined(__linux__)
+    PipePair pipes;
+    if (!pipes.ok)
+        return 0;
+
+    double ns = 0;
+    bool pinned = false;
+    std::thread echo_thread(echo, &pipes, cpu, &pinned);
+    std::thread drive_thread(drive, &pipes, cpu, ms, &ns);
+    drive_thread.join();
+    echo_thread.join();
+
+    // Threads on different CPUs measure wakeup latency, not a switch
+    return pinned ? ns : 0;
+#else
+    static_cast<void>(cpu);
+    static_cast<void>(ms);
+
+    return 0;
+#endif
+}
+
+double measure_page_fault_ns(std::size_t bytes)
+{
+#if defined(__linux__)
+    const std::size_t page = 4096;
+    std::size_t pages = bytes / page;
+    if (pages == 0)
+        return 0;
+
+    double best = 0;
+    for (unsigned run = 0; run != 3; ++run) {
+        void *addr = ::mmap(nullptr, pages * page, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (addr == MAP_FAILED)
+            return 0;
+        ::madvise(addr, pages * page, MADV_NOHUGEPAGE);
+
+        volatile char *data = static_cast<char *>(addr);
+        bench_clock::time_point start = bench_clock::now();
+        for (std::size_t i = 0; i != pages; ++i)
+            data[i * page] = 1;
+        double ns = elapsed_ns(start) / static_cast<double>(pages);
+        ::munmap(addr, pages * page);
+        if (best == 0 || ns < best)
+            best = ns;
+    }
+
+    return best;
+#else
+    static_cast<void>(bytes);
+
+    return 0;
+#endif
+}
+
+} // namespace cpuid_info
@@ -0,0 +1,40 @@
+#ifndef CPUID_INFO_BENCH_KERNEL_HPP
+#define CPUID_INFO_BENCH_KERNEL_HPP
+
+#include <cstddef>
+
+namespace cpuid_info
+{
+
+/// \brief Round trip of a system call that does no work (getppid) on the
+/// calling thread, in nanoseconds
+///
+/// \details
+/// Entry and exit carry most of the cost of speculation mitigations: page
+/// table isolation switches CR3, retpolines, IBRS and return stack
+/// stuffing slow down every kernel entry, VERW clears buffers on every
+/// exit. Zero on systems other than Linux.
+double measure_syscall_ns(double ms = 20);
+
+/// \brief One switch between two threads pinned to `cpu` that wake each
+/// other through a pair of pipes, in nanoseconds
+///
+/// \details
+/// Includes the pipe read and write of each switch, as lmbench's lat_ctx
+/// does, and the IBPB the kernel issues between tasks that opted into
+/// protection. Zero if the threads cannot be pinned or on systems other
+/// than Linux.
+double measure_context_switch_ns(int cpu, double ms = 50);
+
+/// \brief First touch of a 4 KiB anonymous page, in nanoseconds
+///
+/// \details
+/// Maps `bytes` with transparent huge pages disabled and writes one byte
+/// per page, so each page takes a minor fault, an allocation and zeroing.
+/// Best of three mappings. Zero if the mapping fails or on systems other
+/// than Linux.
+double measure_page_fault_ns(std::size_t bytes = 64 << 20);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_BENCH_KERNEL_HPP
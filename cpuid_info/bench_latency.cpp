@@ -0,0 +1,237 @@
+#include <cpuid_info/bench.hpp>
+#include <cpuid_info/bench_latency.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+// Link n nodes, one per stride of buf, into one random cycle, returns its
+// start. With a stride larger than a line each node sits on a random line
+// of its stride.
+char *build_chain(char *buf, std::size_t n, std::size_t stride,
+    std::size_t line_size, std::mt19937_64 &rng)
+{
+    std::vector<std::size_t> order(n);
+    for (std::size_t i = 0; i != n; ++i)
+        order[i] = i;
+
+    // Sattolo's algorithm yields a single cycle over all lines
+    for (std::size_t i = n - 1; i > 0; --i) {
+        std::uniform_int_distribution<std::size_t> dist(0, i - 1);
+        std::swap(order[i], order[dist(rng)]);
+    }
+
+    std::vector<std::size_t> offset(n, 0);
+    if (stride > line_size) {
+        std::uniform_int_distribution<std::size_t> dist(
+            0, stride / line_size - 1);
+        for (std::size_t i = 0; i != n; ++i)
+            offset[i] = dist(rng) * line_size;
+    }
+
+    for (std::size_t i = 0; i != n; ++i) {
+        std::size_t j = order[(i + 1) % n];
+        char *from = buf + order[i] * stride + offset[order[i]];
+        char *to = buf + j * stride + offset[j];
+        *reinterpret_cast<char **>(from) = to;
+    }
+
+    return buf + order[0] * stride + offset[order[0]];
+}
+
+double chase(char *start, std::size_t loads)
+{
+    char *p = start;
+    bench_clock::time_point begin = bench_clock::now();
+    for (std::size_t i = 0; i != loads; i += 8) {
+        p = *reinterpret_cast<char **>(p);
+        p = *reinterpret_cast<char **>(p);
+        p = *reinterpret_cast<char **>(p);
+        p = *reinterpret_cast<char **>(p);
+        p = *reinterpret_cast<char **>(p);
+        p = *reinterpret_cast<char **>(p);
+        p = *reinterpret_cast<char **>(p);
+        p = *reinterpret_cast<char **>(p);
+    }
+    double ns = elapsed_ns(begin);
+    do_not_optimize(p);
+
+    return ns;
+}
+
+// Warm up for two passes, then size each timed run to about 10 ms from a
+// short trial and keep the fastest of three runs, which filters out
+// interrupts and preemption
+double ns_per_load(char *start, std::size_t n)
+{
+    chase(start, (2 * n + 7) / 8 * 8);
+    std::size_t loads = 1 << 16;
+    double ns = chase(start, loads);
+    loads = static_cast<std::size_t>(
+        static_cast<double>(loads) * 10e6 / std::max(ns, 1.0));
+    loads = std::max<std::size_t>(loads, 1 << 16) / 8 * 8;
+    ns = chase(start, loads);
+    ns = std::min(ns, chase(start, loads));
+    ns = std::min(ns, chase(start, loads));
+
+    return ns / static_cast<double>(loads);
+}
+
+} // namespace
+
+LatencyLadder measure_latency(std::size_t max_bytes, std::size_t line_size)
+{
+    LatencyLadder ladder;
+    ladder.ghz = core_ghz();
+
+    if (line_size < sizeof(char *))
+        line_size = sizeof(char *);
+    BenchBuffer buf(max_bytes + line_size);
+    if (!buf.ok())
+        return ladder;
+    std::mt19937_64 rng(0x5EED);
+
+    for (double size = 4096; size <= static_cast<double>(max_bytes) + 1;
+         size *= std::pow(2.0, 0.25)) {
+        std::size_t n = static_cast<std::size_t>(size) / line_size;
+        if (n < 2)
+            continue;
+        char *start = build_chain(buf.data(), n, line_size, line_size, rng);
+
+        LatencyPoint point;
+        point.bytes = n * line_size;
+        point.ns = ns_per_load(start, n);
+        point.cycles = point.ns * ladder.ghz;
+        ladder.points.push_back(point);
+    }
+
+    ladder.knees = find_knees(ladder.points);
+
+    return ladder;
+}
+
+std::vector<LatencyPoint> measure_tlb_reach(
+    PageSize pages, std::size_t max_bytes, double ghz)
+{
+    const std::size_t stride = 4096;
+
+    std::vector<LatencyPoint> points;
+    BenchBuffer buf(max_bytes, pages);
+    if (!buf.ok())
+        return points;
+    std::mt19937_64 rng(0x5EED);
+
+    for (double size = 16 * 1024; size <= static_cast<double>(max_bytes) + 1;
+         size *= std::sqrt(2.0)) {
+        std::size_t n = static_cast<std::size_t>(size) / stride;
+        char *start = build_chain(buf.data(), n, stride, 64, rng);
+
+        LatencyPoint point;
+        point.bytes = n * stride;
+        point.ns = ns_per_load(start, n);
+        point.cycles = point.ns * ghz;
+        points.push_back(point);
+    }
+
+    return points;
+}
+
+std::vector<std::size_t> find_knees(
+    const std::vector<LatencyPoint> &points, double rise)
+{
+    // Steps below this ratio are noise within a plateau
+    const double step = 1.08;
+
+    std::vector<std::size_t> knees;
+    std::size_t i = 1;
+    while (i < points.size()) {
+        if (points[i].ns < points[i - 1].ns * step) {
+            ++i;
+            continue;
+        }
+        std::size_t first = i - 1;
+        while (i < points.size() && points[i].ns >= points[i - 1].ns * step)
+            ++i;
+
+        // The rise must persist past the run, a single slow sample is noise
+        double after = points[i - 1].ns;
+        for (std::size_t j = i; j != i + 2 && j < points.size(); ++j)
+            after = std::min(after, points[j].ns);
+        if (after < points[first].ns * rise)
+            continue;
+
+        // First size past the midpoint latency, then interpolate between
+        // it and the size before on a log scale
+        double mid = std::sqrt(points[first].ns * after);
+        std::size_t k = first + 1;
+        while (k + 1 < i && points[k].ns < mid)
+            ++k;
+        double lo = points[k - 1].ns;
+        double hi = points[k].ns;
+        double t = hi > lo ? std::min(1.0, (mid - lo) / (hi - lo)) : 1;
+        double bytes = static_cast<double>(points[k - 1].bytes) *
+            std::pow(static_cast<double>(points[k].bytes) /
+                    static_cast<double>(points[k - 1].bytes),
+                t);
+        knees.push_back(static_cast<std::size_t>(bytes));
+    }
+
+    return knees;
+}
+
+std::vector<LatencyCheck> check_caches(const std::vector<CacheParam> &caches,
+    const std::vector<std::size_t> &knees, std::size_t max_bytes)
+{
+    // 1.5x for the conflict misses of random chains, which pull knees
+    // below the reported size, and one 2^(1/4) step of the ladder
+    const double tolerance = 1.5 * std::pow(2.0, 0.25);
+
+    std::vector<LatencyCheck> checks;
+    std::size_t next = 0;
+    for (std::size_t i = 0; i != caches.size(); ++i) {
+        if (caches[i].type() == "Instruction")
+            continue;
+
+        LatencyCheck check;
+        check.level = caches[i].level();
+        check.reported = caches[i].size();
+        check.measured = 0;
+        check.in_range = check.reported <= max_bytes;
+        check.agree = false;
+        if (!check.in_range) {
+            checks.push_back(check);
+            continue;
+        }
+
+        // The remaining knee closest to the reported size on a log scale,
+        // extra knees (e.g. TLB reach) are skipped over
+        double best = 0;
+        std::size_t match = knees.size();
+        for (std::size_t k = next; k != knees.size(); ++k) {
+            double dist = std::fabs(std::log(static_cast<double>(knees[k]) /
+                static_cast<double>(check.reported)));
+            if (match == knees.size() || dist < best) {
+                best = dist;
+                match = k;
+            }
+        }
+        if (match != knees.size()) {
+            check.measured = knees[match];
+            next = match + 1;
+        }
+        double measured = static_cast<double>(check.measured);
+        double reported = static_cast<double>(check.reported);
+        check.agree = measured * tolerance >= reported &&
+            measured <= reported * tolerance;
+        checks.push_back(check);
+    }
+
+    return checks;
+}
+
+} // namespace cpuid_info
@@ -0,0 +1,86 @@
+#ifndef CPUID_INFO_BENCH_LATENCY_HPP
+#define CPUID_INFO_BENCH_LATENCY_HPP
+
+#include <cpuid_info/bench.hpp>
+#include <cpuid_info/cache_param.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief Average load-to-use latency of one working set size
+struct LatencyPoint {
+    std::size_t bytes;
+    double ns;
+    double cycles;
+};
+
+/// \brief A reported cache compared with the knee measured for it
+struct LatencyCheck {
+    unsigned level;
+    std::size_t reported;  ///< Size from CacheParam, in bytes
+    std::size_t measured;  ///< Working set at the knee, zero if none
+    bool in_range;         ///< Reported size within the ladder, else not
+                           ///< measured
+    bool agree;            ///< Measured within 1.5x and one ladder step
+};
+
+struct LatencyLadder {
+    double ghz;  ///< Core clock used to convert ns to cycles
+    std::vector<LatencyPoint> points;
+    std::vector<std::size_t> knees;
+};
+
+/// \brief Measure load-to-use latency with a randomized pointer chasing
+/// chain over working sets from 4 KiB to `max_bytes`
+///
+/// \details
+/// Each working set is a single random cycle through all its cache lines
+/// (Sattolo's algorithm), so neither the hardware prefetchers nor out of
+/// order execution can overlap the loads. Sizes grow by steps of 2^(1/4).
+LatencyLadder measure_latency(
+    std::size_t max_bytes, std::size_t line_size = 64);
+
+/// \brief Working set sizes at which the latency rises sharply
+///
+/// \details
+/// A knee is a run of consecutive increases that together raise the
+/// latency by at least `rise`, and the next two sizes after the run must
+/// stay that slow. Its size is where the latency crosses the geometric
+/// midpoint of the rise, interpolated on a log scale: the last size before
+/// the run underestimates the cache, whose hit rate only falls off
+/// gradually once random lines start to conflict.
+std::vector<std::size_t> find_knees(
+    const std::vector<LatencyPoint> &points, double rise = 1.5);
+
+/// \brief Match the knees in order to the data and unified caches, each
+/// cache takes the closest knee above the one matched by the previous level
+///
+/// \details
+/// Caches larger than `max_bytes`, the largest working set of the ladder,
+/// are not measured and match no knee. A cache agrees if the knee is
+/// within a factor of 1.5 times one ladder step (about 1.8) of its
+/// reported size, so a hypervisor reporting twice the real size is
+/// flagged. Random chains lose hits to conflicts before a cache is full,
+/// so knees tend to fall below the reported size, most on caches with few
+/// ways.
+std::vector<LatencyCheck> check_caches(const std::vector<CacheParam> &caches,
+    const std::vector<std::size_t> &knees, std::size_t max_bytes);
+
+/// \brief Measure the cost of address translation over working sets from
+/// 16 KiB to `max_bytes` backed by `pages`
+///
+/// \details
+/// The chain visits one cache line in every 4 KiB of the working set, at a
+/// random offset within the 4 KiB so the lines spread over all cache sets.
+/// The lines themselves occupy 1/64 of the working set and mostly hit in
+/// the caches, so the latency rises once the touched pages outgrow the TLB
+/// reach of the page size. Sizes grow by steps of 2^(1/2). Empty if the
+/// buffer cannot be mapped, e.g. without reserved hugetlb pages.
+std::vector<LatencyPoint> measure_tlb_reach(
+    PageSize pages, std::size_t max_bytes, double ghz);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_BENCH_LATENCY_HPP
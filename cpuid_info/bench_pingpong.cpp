@@ -0,0 +1,291 @@
+#include <cpuid_info/affinity.hpp>
+#include <cpuid_info/bench.hpp>
+#include <cpuid_info/bench_pingpong.hpp>
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <thread>
+#include <immintrin.h>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+// Lines are two cache lines apart so that the adjacent line prefetcher
+// does not couple neighbouring pairs
+const std::size_t line_stride = 128;
+
+const unsigned batches = 3;
+
+// Rounds of a schedule, partner[round][i] is the index paired with index i
+// in that round, or -1 if i sits the round out
+typedef std::vector<std::vector<int> > Schedule;
+
+// Circle method, index 0 stays in place while the others rotate. An odd
+// number of CPUs gets a dummy player and its opponent sits out.
+Schedule tournament(std::size_t n)
+{
+    std::size_t m = n + n % 2;
+    std::vector<int> circle(m);
+    for (std::size_t i = 0; i != m; ++i)
+        circle[i] = i < n ? static_cast<int>(i) : -1;
+
+    Schedule schedule;
+    for (std::size_t r = 0; r + 1 < m; ++r) {
+        std::vector<int> partner(n, -1);
+        for (std::size_t i = 0; i != m / 2; ++i) {
+            int a = circle[i];
+            int b = circle[m - 1 - i];
+            if (a >= 0 && b >= 0) {
+                partner[a] = b;
+                partner[b] = a;
+            }
+        }
+        schedule.push_back(partner);
+        std::rotate(circle.begin() + 1, circle.end() - 1, circle.end());
+    }
+
+    return schedule;
+}
+
+// Sense reversing barrier, spinning rather than sleeping so that all
+// threads leave it within a few hundred nanoseconds of each other
+class SpinBarrier
+{
+    public:
+    explicit SpinBarrier(unsigned n) : n_(n)
+    {
+        waiting_.store(0);
+        generation_.store(0);
+    }
+
+    void wait()
+    {
+        unsigned generation = generation_.load(std::memory_order_acquire);
+        if (waiting_.fetch_add(1, std::memory_order_acq_rel) + 1 == n_) {
+            waiting_.store(0, std::memory_order_relaxed);
+            generation_.fetch_add(1, std::memory_order_acq_rel);
+            return;
+        }
+
+        for (unsigned spins = 0;
+             generation_.load(std::memory_order_acquire) == generation;
+             ++spins) {
+            if (spins < 4096)
+                _mm_pause();
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    private:
+    unsigned n_;
+    std::atomic<unsigned> waiting_;
+    std::atomic<unsigned> generation_;
+}; // class SpinBarrier
+
+// The lower index of a pair starts each round trip and times it, the
+// higher index echoes. Both run batches * round_trips round trips.
+double ping(std::atomic<unsigned> &line, unsigned round_trips)
+{
+    double best = 0;
+    unsigned value = 0;
+    for (unsigned b = 0; b != batches; ++b) {
+        bench_clock::time_point start = bench_clock::now();
+        for (unsigned k = 0; k != round_trips; ++k) {
+            line.store(++value, std::memory_order_release);
+            ++value;
+            while (line.load(std::memory_order_acquire) != value)
+                _mm_pause();
+        }
+        double ns = elapsed_ns(start) / round_trips;
+        if (b == 0 || ns < best)
+            best = ns;
+    }
+
+    return best;
+}
+
+void pong(std::atomic<unsigned> &line, unsigned round_trips)
+{
+    unsigned value = 0;
+    for (unsigned k = 0; k != batches * round_trips; ++k) {
+        ++value;
+        while (line.load(std::memory_order_acquire) != value)
+            _mm_pause();
+        line.store(++value, std::memory_order_release);
+    }
+}
+
+// A thread that cannot be pinned still takes part in every round so the
+// barrier is not left waiting, its pairs are discarded afterwards
+void worker(std::size_t index, int cpu, const Schedule &schedule,
+    unsigned round_trips, char *lines, SpinBarrier &barrier,
+    std::vector<double> &ns, char *pinned)
+{
+    *pinned = pin_this_thread(cpu);
+    std::size_t n = schedule.empty() ? 0 : schedule[0].size();
+
+    barrier.wait();
+    for (std::size_t r = 0; r != schedule.size(); ++r) {
+        int partner = schedule[r][index];
+        std::size_t first = partner >= 0 ?
+            std::min(index, static_cast<std::size_t>(partner)) :
+            index;
+        std::atomic<unsigned> *line = reinterpret_cast<std::atomic<unsigned> *>(
+            lines + first * line_stride);
+
+        // The initiator resets its line before the round starts
+        if (partner >= 0 && index == first)
+            line->store(0, std::memory_order_relaxed);
+        barrier.wait();
+
+        if (partner >= 0) {
+            if (index == first)
+                ns[index * n + partner] = ping(*line, round_trips);
+            else
+                pong(*line, round_trips);
+        }
+        barrier.wait();
+    }
+}
+
+} // namespace
+
+const char *pair_class_name(PairClass cls)
+{
+    switch (cls) {
+        case PairClass::SmtSibling:
+            return "SMT sibling";
+        case PairClass::SameCache:
+            return "Same LLC";
+        case PairClass::SamePackage:
+            return "Cross LLC";
+        case PairClass::CrossPackage:
+            return "Cross package";
+        default:
+            return "Unknown";
+    }
+}
+
+PairClass classify_pair(const Topology &topo,
+    const std::vector<CacheDomain> &llc, int cpu_a, int cpu_b)
+{
+    const LogicalCpu *a = topo.find(cpu_a);
+    const LogicalCpu *b = topo.find(cpu_b);
+    if (a == nullptr || b == nullptr || a->package != b->package)
+        return PairClass::CrossPackage;
+    if (a->die == b->die && a->core == b->core)
+        return PairClass::SmtSibling;
+
+    for (std::size_t i = 0; i != llc.size(); ++i) {
+        const std::vector<int> &cpus = llc[i].cpus;
+        if (std::find(cpus.begin(), cpus.end(), cpu_a) != cpus.end())
+            return std::find(cpus.begin(), cpus.end(), cpu_b) != cpus.end() ?
+                PairClass::SameCache :
+                PairClass::SamePackage;
+    }
+
+    return PairClass::SamePackage;
+}
+
+PingPongMatrix measure_pingpong(const std::vector<int> &cpus,
+    unsigned round_trips, bool concurrent)
+{
+    PingPongMatrix matrix;
+    matrix.cpus = cpus;
+    std::size_t n = cpus.size();
+    matrix.ns.assign(n * n, 0.0);
+    matrix.pinned.assign(n, false);
+    if (n < 2 || round_trips == 0)
+        return matrix;
+
+    BenchBuffer buffer(n * line_stride, PageSize::Small);
+    if (!buffer.ok())
+        return matrix;
+    matrix.pinned.assign(n, true);
+    char *lines = buffer.data();
+    for (std::size_t i = 0; i != n; ++i)
+        new (lines + i * line_stride) std::atomic<unsigned>(0);
+
+    if (!concurrent) {
+        // A schedule of one round for two threads, started for each pair
+        Schedule pair(1, std::vector<int>(2));
+        pair[0][0] = 1;
+        pair[0][1] = 0;
+        for (std::size_t i = 0; i != n; ++i) {
+            for (std::size_t j = i + 1; j != n; ++j) {
+                SpinBarrier barrier(2);
+                std::vector<double> ns(4, 0.0);
+                char pinned[2] = {0, 0};
+                std::thread a(worker, 0, cpus[i], std::cref(pair),
+                    round_trips, lines, std::ref(barrier), std::ref(ns),
+                    pinned);
+                std::thread b(worker, 1, cpus[j], std::cref(pair),
+                    round_trips, lines, std::ref(barrier), std::ref(ns),
+                    pinned + 1);
+                a.join();
+                b.join();
+                matrix.pinned[i] = matrix.pinned[i] && pinned[0];
+                matrix.pinned[j] = matrix.pinned[j] && pinned[1];
+                matrix.ns[i * n + j] = ns[1];
+            }
+        }
+    } else {
+        Schedule schedule(tournament(n));
+        SpinBarrier barrier(static_cast<unsigned>(n));
+        std::vector<char> pinned(n, 0);
+        std::vector<std::thread> workers;
+        for (std::size_t i = 0; i != n; ++i) {
+            workers.push_back(std::thread(worker, i, cpus[i],
+                std::cref(schedule), round_trips, lines, std::ref(barrier),
+                std::ref(matrix.ns), &pinned[i]));
+        }
+        for (std::size_t i = 0; i != n; ++i) {
+            workers[i].join();
+            matrix.pinned[i] = pinned[i] != 0;
+        }
+    }
+
+    // Only the initiator of each pair wrote its cell, mirror it
+    for (std::size_t i = 0; i != n; ++i) {
+        for (std::size_t j = i + 1; j != n; ++j) {
+            if (!matrix.measured(i, j))
+                matrix.ns[i * n + j] = 0;
+            matrix.ns[j * n + i] = matrix.ns[i * n + j];
+        }
+    }
+
+    return matrix;
+}
+
+PairSummary summarize_pairs(const PingPongMatrix &matrix,
+    const Topology &topo, const std::vector<CacheDomain> &llc,
+    PairClass cls)
+{
+    PairSummary summary = {0, 0.0, 0.0, 0.0};
+    std::size_t n = matrix.cpus.size();
+    for (std::size_t i = 0; i != n; ++i) {
+        for (std::size_t j = i + 1; j != n; ++j) {
+            if (!matrix.measured(i, j) ||
+                classify_pair(topo, llc, matrix.cpus[i], matrix.cpus[j]) !=
+                    cls)
+                continue;
+
+            double ns = matrix.at(i, j);
+            if (summary.pairs == 0 || ns < summary.min_ns)
+                summary.min_ns = ns;
+            summary.max_ns = std::max(summary.max_ns, ns);
+            summary.avg_ns += ns;
+            ++summary.pairs;
+        }
+    }
+    if (summary.pairs != 0)
+        summary.avg_ns /= summary.pairs;
+
+    return summary;
+}
+
+} // namespace cpuid_info
@@ -0,0 +1,78 @@
+#ifndef CPUID_INFO_BENCH_PINGPONG_HPP
+#define CPUID_INFO_BENCH_PINGPONG_HPP
+
+#include <cpuid_info/cache_domain.hpp>
+#include <cpuid_info/topology.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief How close two logical CPUs are in the topology
+enum class PairClass {
+    SmtSibling,    ///< Same core
+    SameCache,     ///< Same last level cache (L3 or CCX)
+    SamePackage,   ///< Same package, different last level cache
+    CrossPackage,  ///< Different packages
+    Count
+};
+
+const unsigned pair_class_count = static_cast<unsigned>(PairClass::Count);
+
+const char *pair_class_name(PairClass cls);
+
+PairClass classify_pair(const Topology &topo,
+    const std::vector<CacheDomain> &llc, int cpu_a, int cpu_b);
+
+/// \brief Round trip latency of a contended cache line between every pair
+/// of CPUs
+struct PingPongMatrix {
+    std::vector<int> cpus;
+
+    /// \brief Row major, zero on the diagonal and for pairs not measured
+    std::vector<double> ns;
+
+    /// \brief Per CPU, false if a thread could not be pinned to it; its
+    /// pairs are not measured
+    std::vector<bool> pinned;
+
+    double at(std::size_t i, std::size_t j) const
+    {
+        return ns[i * cpus.size() + j];
+    }
+
+    bool measured(std::size_t i, std::size_t j) const
+    {
+        return i != j && pinned[i] && pinned[j];
+    }
+};
+
+/// \brief Bounce a cache line `round_trips` times between every pair of
+/// `cpus`, best of three batches
+///
+/// \details
+/// With `concurrent` one thread is pinned to each CPU and the pairs are
+/// scheduled as a round robin tournament, so each of the n - 1 rounds runs
+/// n / 2 disjoint pairs at once, each pair on its own cache line. Otherwise
+/// pairs run one at a time, which avoids interconnect contention at the
+/// cost of n (n - 1) / 2 rounds, and only the two threads of the pair
+/// being timed exist, so no idle thread spins on an SMT sibling.
+PingPongMatrix measure_pingpong(const std::vector<int> &cpus,
+    unsigned round_trips = 1000, bool concurrent = true);
+
+/// \brief Latency statistics of all pairs of one class
+struct PairSummary {
+    unsigned pairs;
+    double min_ns;
+    double avg_ns;
+    double max_ns;
+};
+
+PairSummary summarize_pairs(const PingPongMatrix &matrix,
+    const Topology &topo, const std::vector<CacheDomain> &llc,
+    PairClass cls);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_BENCH_PINGPONG_HPP
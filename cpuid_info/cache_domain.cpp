@@ -0,0 +1,82 @@
+#include <cpuid_info/affinity.hpp>
+#include <cpuid_info/cache_domain.hpp>
+#include <cpuid_info/cpu_info.hpp>
+#include <cstddef>
+#include <map>
+#include <utility>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+inline int type_order(const std::string &type)
+{
+    return type == "Data" ? 0 : (type == "Instruction" ? 1 : 2);
+}
+
+} // namespace
+
+std::string CacheDomain::cpulist() const { return cpuid_info::cpulist(cpus); }
+
+std::vector<CacheDomain> cache_domains(const Topology &topo)
+{
+    typedef std::pair<std::pair<unsigned, int>, unsigned> Key;
+    std::map<Key, CacheDomain> domains;
+
+    for (std::size_t i = 0; i != topo.cpus().size(); ++i) {
+        const LogicalCpu &cpu = topo.cpus()[i];
+        CpuInfo info(cpu.snapshot);
+        const std::vector<CacheParam> &caches = info.caches();
+        for (std::size_t j = 0; j != caches.size(); ++j) {
+            const CacheParam &cache = caches[j];
+            unsigned shift = ceil_log2(cache.max_proc_sharing());
+            unsigned id = shift >= 32 ? 0 : cpu.apic_id >> shift;
+            Key key(
+                std::make_pair(cache.level(), type_order(cache.type())), id);
+
+            std::map<Key, CacheDomain>::iterator iter = domains.find(key);
+            if (iter == domains.end()) {
+                CacheDomain domain;
+                domain.level = cache.level();
+                domain.type = cache.type();
+                domain.id = id;
+                domain.size = cache.size();
+                iter = domains.insert(std::make_pair(key, domain)).first;
+            }
+            iter->second.cpus.push_back(cpu.os_id);
+        }
+    }
+
+    std::vector<CacheDomain> result;
+    for (std::map<Key, CacheDomain>::const_iterator iter = domains.begin();
+         iter != domains.end(); ++iter)
+        result.push_back(iter->second);
+
+    return result;
+}
+
+std::vector<CacheDomain> cache_domains(const Topology &topo, unsigned level)
+{
+    std::vector<CacheDomain> all(cache_domains(topo));
+    std::vector<CacheDomain> result;
+    for (std::size_t i = 0; i != all.size(); ++i)
+        if (all[i].level == level && all[i].type != "Instruction")
+            result.push_back(all[i]);
+
+    return result;
+}
+
+std::vector<CacheDomain> last_level_cache_domains(const Topology &topo)
+{
+    std::vector<CacheDomain> all(cache_domains(topo));
+    unsigned level = 0;
+    for (std::size_t i = 0; i != all.size(); ++i)
+        if (all[i].level > level)
+            level = all[i].level;
+
+    return cache_domains(topo, level);
+}
+
+} // namespace cpuid_info
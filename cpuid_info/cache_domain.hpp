@@ -0,0 +1,39 @@
+#ifndef CPUID_INFO_CACHE_DOMAIN_HPP
+#define CPUID_INFO_CACHE_DOMAIN_HPP
+
+#include <cpuid_info/topology.hpp>
+#include <string>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief One cache instance and the logical CPUs sharing it
+struct CacheDomain {
+    unsigned level;
+    std::string type;
+    unsigned id;            ///< APIC ID with the sharing bits shifted out
+    unsigned size;          ///< Size in bytes
+    std::vector<int> cpus;  ///< OS numbers of the CPUs sharing the cache
+
+    /// \brief The CPUs in the kernel cpulist format, e.g. "0-7,64-71"
+    std::string cpulist() const;
+};
+
+/// \brief Cache instances of all levels, ordered by level, type and ID
+///
+/// \details
+/// The sharing field of leaf 0x04 (or 0x8000001D on AMD) of each CPU gives
+/// the number of APIC IDs reserved for the CPUs sharing a cache. CPUs whose
+/// APIC IDs agree above those bits share the same cache instance.
+std::vector<CacheDomain> cache_domains(const Topology &topo);
+
+/// \brief Cache instances of one level, data and unified caches only
+std::vector<CacheDomain> cache_domains(const Topology &topo, unsigned level);
+
+/// \brief Instances of the highest cache level, e.g. one per L3 or CCX
+std::vector<CacheDomain> last_level_cache_domains(const Topology &topo);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_CACHE_DOMAIN_HPP
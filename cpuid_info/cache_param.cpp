@@ -0,0 +1,153 @@
+#include <cpuid_info/cache_param.hpp>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+// Encode a cache in the leaf 0x04 layout, `ways` is 0xFF if fully
+// associative and 0 if unknown
+void add_cache(std::vector<CacheParam> &caches, unsigned type, unsigned level,
+    unsigned size, unsigned ways, unsigned line_size, unsigned sharing,
+    unsigned cores)
+{
+    if (size == 0 || line_size == 0)
+        return;
+
+    Register reg;
+    reg.eax = type | (level << 5) | (1U << 8) |
+        ((sharing - 1) & 0xFFF) << 14 | ((cores - 1) & 0x3F) << 26;
+    reg.ebx = line_size - 1;
+    reg.ecx = 0;
+    reg.edx = 0;
+    if (ways == 0) {
+        caches.push_back(CacheParam(reg, size));
+        return;
+    }
+
+    bool fully = ways == 0xFF;
+    if (fully)
+        ways = size / line_size;
+    unsigned sets = size / (ways * line_size);
+    if (sets == 0)
+        return;
+
+    reg.eax |= fully ? 1U << 9 : 0;
+    reg.ebx |= (ways - 1) << 22;
+    reg.ecx = sets - 1;
+    caches.push_back(CacheParam(reg));
+}
+
+// Ways of an L2 or L3 in leaf 0x80000006, code 0x9 defers to the matching
+// cache of leaf 0x8000001D and is 0 without it
+unsigned legacy_ways(const Snapshot &snapshot, unsigned code, unsigned level)
+{
+    if (code != 0x9)
+        return amd_associativity(code);
+    if (snapshot.max_extended() < 0x8000001D)
+        return 0;
+
+    for (unsigned ecx = 0x00; snapshot.contains(0x8000001D, ecx); ++ecx) {
+        Register reg(snapshot.get(0x8000001D, ecx));
+        unsigned type = extract_bits(reg.eax, 4, 0);
+        if (type == 0)
+            break;
+        if (type == 3 && extract_bits(reg.eax, 7, 5) == level)
+            return extract_bits(reg.ebx, 31, 22) + 1;
+    }
+
+    return 0;
+}
+
+} // namespace
+
+CacheParam::CacheParam(const Register &reg)
+    : level_(0)
+    , max_proc_sharing_(0)
+    , max_proc_physical_(0)
+    , line_size_(0)
+    , partitions_(0)
+    , ways_(0)
+    , sets_(0)
+    , size_(0)
+    , self_initializing_(false)
+    , fully_associative_(false)
+    , wbinvd_(false)
+    , inclusiveness_(false)
+    , complex_indexing_(false)
+{
+    switch (extract_bits(reg.eax, 4, 0)) {
+        case 1:
+            type_ = "Data";
+            break;
+        case 2:
+            type_ = "Instruction";
+            break;
+        case 3:
+            type_ = "Unified";
+            break;
+        default:
+            type_ = "Null";
+            return;
+    }
+
+    level_ = extract_bits(reg.eax, 7, 5);
+    self_initializing_ = test_bit(reg.eax, 8);
+    fully_associative_ = test_bit(reg.eax, 9);
+    max_proc_sharing_ = extract_bits(reg.eax, 25, 14) + 1;
+    max_proc_physical_ = extract_bits(reg.eax, 31, 26) + 1;
+
+    line_size_ = extract_bits(reg.ebx, 11, 0) + 1;
+    partitions_ = extract_bits(reg.ebx, 21, 12) + 1;
+    ways_ = extract_bits(reg.ebx, 31, 22) + 1;
+    sets_ = reg.ecx + 1;
+    size_ = line_size_ * partitions_ * ways_ * sets_;
+
+    wbinvd_ = test_bit(reg.edx, 0);
+    inclusiveness_ = test_bit(reg.edx, 1);
+    complex_indexing_ = test_bit(reg.edx, 2);
+}
+
+CacheParam::CacheParam(const Register &reg, unsigned size) : CacheParam(reg)
+{
+    ways_ = 0;
+    sets_ = 0;
+    size_ = size;
+}
+
+std::vector<CacheParam> legacy_amd_caches(const Snapshot &snapshot)
+{
+    std::vector<CacheParam> caches;
+    unsigned max = snapshot.max_extended();
+    if (max < 0x80000005)
+        return caches;
+
+    unsigned threads = 1;
+    if (max >= 0x80000008)
+        threads = extract_bits(snapshot.get(0x80000008).ecx, 7, 0) + 1;
+
+    // L1 data in ECX, L1 instruction in EDX: size in KiB, associativity as
+    // a plain count (0xFF if fully associative) and line size
+    Register l1(snapshot.get(0x80000005));
+    add_cache(caches, 1, 1, extract_byte(l1.ecx, 3) * 1024,
+        extract_byte(l1.ecx, 2), extract_byte(l1.ecx, 0), 1, threads);
+    add_cache(caches, 2, 1, extract_byte(l1.edx, 3) * 1024,
+        extract_byte(l1.edx, 2), extract_byte(l1.edx, 0), 1, threads);
+
+    // L2 in ECX with the size in KiB, L3 in EDX in units of 512 KiB, both
+    // with the encoded associativity
+    if (max >= 0x80000006) {
+        Register l23(snapshot.get(0x80000006));
+        add_cache(caches, 3, 2, extract_bits(l23.ecx, 31, 16) * 1024,
+            legacy_ways(snapshot, extract_bits(l23.ecx, 15, 12), 2),
+            extract_byte(l23.ecx, 0), 1, threads);
+        add_cache(caches, 3, 3, extract_bits(l23.edx, 31, 18) * 512 * 1024,
+            legacy_ways(snapshot, extract_bits(l23.edx, 15, 12), 3),
+            extract_byte(l23.edx, 0), threads, threads);
+    }
+
+    return caches;
+}
+
+} // namespace cpuid_info
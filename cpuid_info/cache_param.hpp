@@ -0,0 +1,69 @@
+#ifndef CPUID_INFO_CACHE_PARAM_HPP
+#define CPUID_INFO_CACHE_PARAM_HPP
+
+#include <cpuid_info/cpuid.hpp>
+#include <cpuid_info/snapshot.hpp>
+#include <string>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief Deterministic cache parameters decoded from one subleaf of leaf
+/// 0x04, or of leaf 0x8000001D which has the same layout on AMD
+class CacheParam
+{
+    public:
+    CacheParam(const Register &reg);
+
+    /// \brief A cache of `size` bytes whose ways and sets are not reported,
+    /// both read as zero
+    CacheParam(const Register &reg, unsigned size);
+
+    const std::string &type() const { return type_; }
+    unsigned level() const { return level_; }
+    unsigned max_proc_sharing() const { return max_proc_sharing_; }
+    unsigned max_proc_physical() const { return max_proc_physical_; }
+    unsigned line_size() const { return line_size_; }
+    unsigned partitions() const { return partitions_; }
+    unsigned ways() const { return ways_; }
+    unsigned sets() const { return sets_; }
+    unsigned size() const { return size_; }
+    bool self_initializing() const { return self_initializing_; }
+    bool fully_associative() const { return fully_associative_; }
+    bool wbinvd() const { return wbinvd_; }
+    bool inclusiveness() const { return inclusiveness_; }
+    bool complex_indexing() const { return complex_indexing_; }
+
+    private:
+    std::string type_;
+    unsigned level_;
+    unsigned max_proc_sharing_;
+    unsigned max_proc_physical_;
+    unsigned line_size_;
+    unsigned partitions_;
+    unsigned ways_;
+    unsigned sets_;
+    unsigned size_;
+    bool self_initializing_;
+    bool fully_associative_;
+    bool wbinvd_;
+    bool inclusiveness_;
+    bool complex_indexing_;
+}; // class CacheParam
+
+/// \brief Caches of the legacy AMD leaves 0x80000005 (L1) and 0x80000006
+/// (L2, L3), for AMD CPUs without leaf 0x8000001D
+///
+/// \details
+/// The leaves give size, associativity and line size only. L1 and L2 are
+/// reported as private to a core and L3 as shared by all logical CPUs of
+/// the package (leaf 0x80000008), which holds for every AMD CPU without
+/// TOPOEXT. Zen CPUs report the L3 associativity as 0x9, "see leaf
+/// 0x8000001D"; the ways are then taken from that leaf if it was captured
+/// and are zero otherwise, the size is kept either way.
+std::vector<CacheParam> legacy_amd_caches(const Snapshot &snapshot);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_CACHE_PARAM_HPP
@@ -0,0 +1,228 @@
+#include <cpuid_info/compiler_flags.hpp>
+#include <cpuid_info/uarch.hpp>
+#include <cstddef>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+const Feature v2_features[] = {Feature::CMPXCHG16B, Feature::LAHF_LM,
+    Feature::POPCNT, Feature::SSE3, Feature::SSE4_1, Feature::SSE4_2,
+    Feature::SSSE3};
+
+// LZCNT is the ABM bit of leaf 0x80000001
+const Feature v3_features[] = {Feature::AVX, Feature::AVX2, Feature::BMI1,
+    Feature::BMI2, Feature::F16C, Feature::FMA, Feature::ABM, Feature::MOVBE,
+    Feature::OSXSAVE};
+
+const Feature v4_features[] = {Feature::AVX512F, Feature::AVX512BW,
+    Feature::AVX512CD, Feature::AVX512DQ, Feature::AVX512VL};
+
+struct Extension {
+    Feature feature;
+
+    // The option also enables this feature, e.g. -mvaes enables AVX and
+    // every AVX-512 option enables AVX512F
+    Feature base;
+    const char *option;
+};
+
+// Instructions the levels leave out, in GCC/Clang option spelling
+const Extension extension_table[] = {
+    {Feature::PCLMULQDQ, Feature::PCLMULQDQ, "-mpclmul"},
+    {Feature::AESNI, Feature::AESNI, "-maes"},
+    {Feature::XSAVE, Feature::XSAVE, "-mxsave"},
+    {Feature::RDRAND, Feature::RDRAND, "-mrdrnd"},
+    {Feature::FSGSBASE, Feature::FSGSBASE, "-mfsgsbase"},
+    {Feature::RDSEED, Feature::RDSEED, "-mrdseed"},
+    {Feature::ADX, Feature::ADX, "-madx"},
+    {Feature::CLFLUSHOPT, Feature::CLFLUSHOPT, "-mclflushopt"},
+    {Feature::CLWB, Feature::CLWB, "-mclwb"},
+    {Feature::SHA, Feature::SHA, "-msha"},
+    {Feature::PKU, Feature::PKU, "-mpku"},
+    {Feature::WAITPKG, Feature::WAITPKG, "-mwaitpkg"},
+    {Feature::GFNI, Feature::GFNI, "-mgfni"},
+    {Feature::VAES, Feature::AVX, "-mvaes"},
+    {Feature::VPCLMULQDQ, Feature::AVX, "-mvpclmulqdq"},
+    {Feature::RDPID, Feature::RDPID, "-mrdpid"},
+    {Feature::CLDEMOTE, Feature::CLDEMOTE, "-mcldemote"},
+    {Feature::MOVDIRI, Feature::MOVDIRI, "-mmovdiri"},
+    {Feature::MOVDIR64B, Feature::MOVDIR64B, "-mmovdir64b"},
+    {Feature::SERIALIZE, Feature::SERIALIZE, "-mserialize"},
+    {Feature::AVX512F, Feature::AVX512F, "-mavx512f"},
+    {Feature::AVX512CD, Feature::AVX512F, "-mavx512cd"},
+    {Feature::AVX512IFMA52, Feature::AVX512F, "-mavx512ifma"},
+    {Feature::AVX512VBMI, Feature::AVX512F, "-mavx512vbmi"},
+    {Feature::AVX512VBMI2, Feature::AVX512F, "-mavx512vbmi2"},
+    {Feature::AVX512VNNI, Feature::AVX512F, "-mavx512vnni"},
+    {Feature::AVX512BITALG, Feature::AVX512F, "-mavx512bitalg"},
+    {Feature::AVX512VPOPCNTDQ, Feature::AVX512F, "-mavx512vpopcntdq"},
+    {Feature::AVX512VP2INTERSECT, Feature::AVX512F,
+        "-mavx512vp2intersect"},
+    {Feature::AVX512FP16, Feature::AVX512F, "-mavx512fp16"},
+    {Feature::AMX_TILE, Feature::AMX_TILE, "-mamx-tile"},
+    {Feature::AMX_INT8, Feature::AMX_TILE, "-mamx-int8"},
+    {Feature::AMX_BF16, Feature::AMX_TILE, "-mamx-bf16"},
+    {Feature::AVX_VNNI, Feature::AVX2, "-mavxvnni"},
+    {Feature::AVX512BF16, Feature::AVX512F, "-mavx512bf16"},
+    {Feature::SSE4A, Feature::SSE4A, "-msse4a"},
+    {Feature::AMD_3DNOWPREFETCH, Feature::AMD_3DNOWPREFETCH,
+        "-mprfchw"},
+};
+
+const std::size_t extension_count = sizeof(extension_table) /
+    sizeof(Extension);
+
+Features make_features(const Feature *list, std::size_t n)
+{
+    Features features;
+    for (std::size_t i = 0; i != n; ++i)
+        features.set(list[i]);
+
+    return features;
+}
+
+// `hosts[i]` weighs `cpus[i]` when picking the tuning
+CompilerFlags make_flags(const std::vector<CpuInfo> &cpus,
+    const std::vector<unsigned long long> &hosts)
+{
+    CompilerFlags flags;
+    flags.vector_width = 512;
+    for (std::size_t i = 0; i != cpus.size(); ++i)
+        flags.common = i == 0 ? cpus[i].features()
+                              : flags.common & cpus[i].features();
+
+    flags.level = isa_level(flags.common);
+    flags.march = isa_level_name(flags.level);
+    Features implied(isa_level_features(flags.level));
+    for (std::size_t i = 0; i != extension_count; ++i) {
+        Feature f = extension_table[i].feature;
+        if (flags.common.has(f) && !implied.has(f) &&
+            flags.common.has(extension_table[i].base))
+            flags.extensions.push_back(extension_table[i].option);
+    }
+
+    // Tune for the microarchitecture with most hosts, in table order on a
+    // tie, and narrow the vectors to what every CPU runs at full clock
+    std::vector<const Microarch *> uarchs;
+    std::vector<unsigned long long> counts;
+    for (std::size_t i = 0; i != cpus.size(); ++i) {
+        const Microarch *m = identify_microarch(cpus[i]);
+        unsigned width = m != nullptr ? m->vector_width : 256;
+        if (width < flags.vector_width)
+            flags.vector_width = width;
+        std::size_t j = 0;
+        while (j != uarchs.size() && uarchs[j] != m)
+            ++j;
+        if (j == uarchs.size()) {
+            uarchs.push_back(m);
+            counts.push_back(0);
+        }
+        counts[j] += hosts[i];
+    }
+    flags.mtune = "generic";
+    unsigned long long most = 0;
+    for (std::size_t j = 0; j != uarchs.size(); ++j) {
+        if (counts[j] > most) {
+            most = counts[j];
+            if (uarchs[j] != nullptr)
+                flags.mtune = uarchs[j]->march;
+            else
+                flags.mtune = "generic";
+        }
+    }
+
+    if (!flags.common.has(Feature::AVX512F) || cpus.empty())
+        flags.vector_width = 0;
+    else if (flags.vector_width < 256)
+        flags.vector_width = 256;
+
+    return flags;
+}
+
+} // namespace
+
+const char *isa_level_name(IsaLevel level)
+{
+    switch (level) {
+        case IsaLevel::V2:
+            return "x86-64-v2";
+        case IsaLevel::V3:
+            return "x86-64-v3";
+        case IsaLevel::V4:
+            return "x86-64-v4";
+        default:
+            return "x86-64";
+    }
+}
+
+Features isa_level_features(IsaLevel level)
+{
+    Features features;
+    if (level >= IsaLevel::V2)
+        features |= make_features(v2_features,
+            sizeof(v2_features) / sizeof(Feature));
+    if (level >= IsaLevel::V3)
+        features |= make_features(v3_features,
+            sizeof(v3_features) / sizeof(Feature));
+    if (level >= IsaLevel::V4)
+        features |= make_features(v4_features,
+            sizeof(v4_features) / sizeof(Feature));
+
+    return features;
+}
+
+IsaLevel isa_level(const Features &features)
+{
+    if (features.contains(isa_level_features(IsaLevel::V4)))
+        return IsaLevel::V4;
+    if (features.contains(isa_level_features(IsaLevel::V3)))
+        return IsaLevel::V3;
+    if (features.contains(isa_level_features(IsaLevel::V2)))
+        return IsaLevel::V2;
+
+    return IsaLevel::Baseline;
+}
+
+std::string CompilerFlags::str() const
+{
+    std::string s("-march=" + march + " -mtune=" + mtune);
+    if (vector_width != 0)
+        s += " -mprefer-vector-width=" + std::to_string(vector_width);
+    for (std::size_t i = 0; i != extensions.size(); ++i)
+        s += " " + extensions[i];
+
+    return s;
+}
+
+CompilerFlags compiler_flags(const CpuInfo &info)
+{
+    return make_flags(std::vector<CpuInfo>(1, info),
+        std::vector<unsigned long long>(1, 1));
+}
+
+CompilerFlags compiler_flags(const FleetSummary &fleet)
+{
+    std::vector<CpuInfo> cpus;
+    std::vector<unsigned long long> hosts;
+    for (std::size_t i = 0; i != fleet.groups.size(); ++i) {
+        cpus.push_back(CpuInfo(fleet.groups[i].snapshot));
+        hosts.push_back(fleet.groups[i].hosts);
+    }
+
+    return make_flags(cpus, hosts);
+}
+
+void write_toolchain(const CompilerFlags &flags, std::ostream &out)
+{
+    out << "# Generated by cpuid_info --toolchain\n";
+    out << "set(CPUID_INFO_ISA_LEVEL \"" << isa_level_name(flags.level)
+        << "\")\n";
+    out << "set(CPUID_INFO_MTUNE \"" << flags.mtune << "\")\n";
+    out << "set(CMAKE_C_FLAGS_INIT \"" << flags.str() << "\")\n";
+    out << "set(CMAKE_CXX_FLAGS_INIT \"" << flags.str() << "\")\n";
+}
+
+} // namespace cpuid_info
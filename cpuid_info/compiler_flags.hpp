@@ -0,0 +1,66 @@
+#ifndef CPUID_INFO_COMPILER_FLAGS_HPP
+#define CPUID_INFO_COMPILER_FLAGS_HPP
+
+#include <cpuid_info/cpu_info.hpp>
+#include <cpuid_info/feature.hpp>
+#include <cpuid_info/fleet.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief x86-64 psABI microarchitecture levels
+enum class IsaLevel { Baseline, V2, V3, V4 };
+
+/// \brief The `-march` name of a level, "x86-64" to "x86-64-v4"
+const char *isa_level_name(IsaLevel level);
+
+/// \brief Features a level requires
+Features isa_level_features(IsaLevel level);
+
+/// \brief Highest level whose features are all set
+IsaLevel isa_level(const Features &features);
+
+/// \brief GCC/Clang code generation flags for a set of CPU types
+///
+/// \details
+/// `march` is the x86-64 level every CPU meets and `extensions` enables the
+/// remaining common instructions one by one, so the flags never assume more
+/// than the CPUs report, e.g. when a hypervisor hides AVX-512 from a core
+/// whose `-march` name would imply it. The microarchitecture only picks the
+/// tuning and the preferred vector width.
+struct CompilerFlags {
+    IsaLevel level;
+    std::string march;
+
+    /// \brief Microarchitecture of most hosts, "generic" if unknown
+    std::string mtune;
+
+    /// \brief `-mprefer-vector-width`, zero if the CPUs lack AVX-512
+    unsigned vector_width;
+
+    /// \brief `-m` options for common features above the level
+    std::vector<std::string> extensions;
+
+    /// \brief Features common to all CPUs
+    Features common;
+
+    /// \brief All options separated by spaces
+    std::string str() const;
+};
+
+/// \brief Flags for the CPU a snapshot was captured on
+CompilerFlags compiler_flags(const CpuInfo &info);
+
+/// \brief Flags for binaries that run on every CPU type of a fleet, tuned
+/// for the type with most hosts
+CompilerFlags compiler_flags(const FleetSummary &fleet);
+
+/// \brief Write a CMake toolchain file setting the C and C++ flags
+void write_toolchain(const CompilerFlags &flags, std::ostream &out);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_COMPILER_FLAGS_HPP
@@ -0,0 +1,293 @@
+#include <cpuid_info/cpu_info.hpp>
+#include <cstddef>
+#include <cstring>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+CpuInfo decoded_this_cpu()
+{
+    CpuInfo info;
+    info.decode();
+
+    return info;
+}
+
+} // namespace
+
+Vendor vendor_of(const Snapshot &snapshot)
+{
+    Register reg(snapshot.get(0x00));
+
+    // "AuthenticAMD", "HygonGenuine" and "GenuineIntel" in EBX, EDX, ECX
+    if (reg.ebx == 0x756E6547 && reg.edx == 0x49656E69 && reg.ecx == 0x6C65746E)
+        return Vendor::Intel;
+    if (reg.ebx == 0x68747541 && reg.edx == 0x69746E65 && reg.ecx == 0x444D4163)
+        return Vendor::AMD;
+    if (reg.ebx == 0x6F677948 && reg.edx == 0x6E65476E && reg.ecx == 0x656E6975)
+        return Vendor::Hygon;
+
+    return Vendor::Other;
+}
+
+CpuInfo::CpuInfo()
+    : snapshot_(Snapshot::capture())
+    , vendor_decoded_(false)
+    , brand_decoded_(false)
+    , caches_decoded_(false)
+    , frequency_decoded_(false)
+    , core_count_decoded_(false)
+    , tlbs_decoded_(false)
+    , tlb_leaf_(0)
+    , features_decoded_(false)
+{
+}
+
+CpuInfo::CpuInfo(const Snapshot &snapshot)
+    : snapshot_(snapshot)
+    , vendor_decoded_(false)
+    , brand_decoded_(false)
+    , caches_decoded_(false)
+    , frequency_decoded_(false)
+    , core_count_decoded_(false)
+    , tlbs_decoded_(false)
+    , tlb_leaf_(0)
+    , features_decoded_(false)
+{
+}
+
+const std::string &CpuInfo::vendor() const
+{
+    if (vendor_decoded_)
+        return vendor_;
+
+    Register reg(snapshot_.get(0x00));
+    char str[sizeof(unsigned) * 3 + 1] = {'\0'};
+    std::memcpy(str + sizeof(unsigned) * 0, &reg.ebx, sizeof(unsigned));
+    std::memcpy(str + sizeof(unsigned) * 1, &reg.edx, sizeof(unsigned));
+    std::memcpy(str + sizeof(unsigned) * 2, &reg.ecx, sizeof(unsigned));
+    vendor_ = str;
+    vendor_decoded_ = true;
+
+    return vendor_;
+}
+
+const std::string &CpuInfo::brand() const
+{
+    if (brand_decoded_)
+        return brand_;
+
+    brand_decoded_ = true;
+    if (snapshot_.max_extended() < 0x80000004)
+        return brand_;
+
+    Register reg2(snapshot_.get(0x80000002));
+    Register reg3(snapshot_.get(0x80000003));
+    Register reg4(snapshot_.get(0x80000004));
+    const std::size_t reg_size = sizeof(unsigned) * 4;
+    char str[reg_size * 3 + 1] = {'\0'};
+    std::memcpy(str + reg_size * 0, &reg2, reg_size);
+    std::memcpy(str + reg_size * 1, &reg3, reg_size);
+    std::memcpy(str + reg_size * 2, &reg4, reg_size);
+    brand_ = str;
+
+    return brand_;
+}
+
+Signature CpuInfo::signature() const
+{
+    unsigned eax = snapshot_.get(0x01).eax;
+    Signature sig;
+    sig.family = extract_bits(eax, 11, 8);
+    sig.model = extract_bits(eax, 7, 4);
+    sig.stepping = extract_bits(eax, 3, 0);
+    if (sig.family == 0x6 || sig.family == 0xF)
+        sig.model |= extract_bits(eax, 19, 16) << 4;
+    if (sig.family == 0xF)
+        sig.family += extract_bits(eax, 27, 20);
+
+    return sig;
+}
+
+const std::vector<CacheParam> &CpuInfo::caches() const
+{
+    if (caches_decoded_)
+        return caches_;
+
+    caches_decoded_ = true;
+    unsigned eax = cache_leaf();
+    if (eax == 0)
+        return caches_;
+    if (eax == 0x80000005) {
+        caches_ = legacy_amd_caches(snapshot_);
+        return caches_;
+    }
+
+    for (unsigned ecx = 0x00; snapshot_.contains(eax, ecx); ++ecx) {
+        Register reg(snapshot_.get(eax, ecx));
+        if (extract_bits(reg.eax, 4, 0) == 0)
+            break;
+        caches_.push_back(CacheParam(reg));
+    }
+
+    return caches_;
+}
+
+unsigned CpuInfo::cache_leaf() const
+{
+    if (snapshot_.max_basic() >= 0x04 &&
+        extract_bits(snapshot_.get(0x04).eax, 4, 0) != 0)
+        return 0x04;
+
+    // AMD reports the same layout in leaf 0x8000001D when TOPOEXT is set
+    if (snapshot_.max_extended() >= 0x8000001D &&
+        test_bit(snapshot_.get(0x80000001).ecx, 22) &&
+        extract_bits(snapshot_.get(0x8000001D).eax, 4, 0) != 0)
+        return 0x8000001D;
+
+    // Older AMD CPUs only report sizes in the legacy leaves
+    Vendor vendor = vendor_id();
+    if ((vendor == Vendor::AMD || vendor == Vendor::Hygon) &&
+        !legacy_amd_caches(snapshot_).empty())
+        return 0x80000005;
+
+    return 0;
+}
+
+const Frequency &CpuInfo::frequency() const
+{
+    if (frequency_decoded_)
+        return frequency_;
+
+    Register reg(snapshot_.get(0x16));
+    frequency_.base = reg.eax & 0xFFFF;
+    frequency_.max = reg.ebx & 0xFFFF;
+    frequency_.bus = reg.ecx & 0xFFFF;
+    frequency_decoded_ = true;
+
+    return frequency_;
+}
+
+const CoreCount &CpuInfo::core_count() const
+{
+    if (core_count_decoded_)
+        return core_count_;
+
+    core_count_decoded_ = true;
+    core_count_.threads_per_core = 1;
+    core_count_.threads_per_package = 1;
+
+    Vendor vendor = vendor_id();
+    bool amd = vendor == Vendor::AMD || vendor == Vendor::Hygon;
+    unsigned leaf = 0;
+    if (snapshot_.max_basic() >= 0x1F && snapshot_.get(0x1F).ebx != 0)
+        leaf = 0x1F;
+    else if (snapshot_.max_basic() >= 0x0B && snapshot_.get(0x0B).ebx != 0)
+        leaf = 0x0B;
+
+    core_count_.leaf = leaf;
+    if (leaf != 0) {
+        // EBX of the SMT level counts the threads of a core, EBX of the
+        // last level the threads of the package
+        for (unsigned ecx = 0; snapshot_.contains(leaf, ecx); ++ecx) {
+            Register reg(snapshot_.get(leaf, ecx));
+            unsigned type = extract_bits(reg.ecx, 15, 8);
+            if (type == 0)
+                break;
+            if (type == 1)
+                core_count_.threads_per_core = extract_bits(reg.ebx, 15, 0);
+            core_count_.threads_per_package = extract_bits(reg.ebx, 15, 0);
+        }
+    } else if (amd && snapshot_.max_extended() >= 0x80000008) {
+        core_count_.leaf = 0x80000008;
+        core_count_.threads_per_package =
+            extract_bits(snapshot_.get(0x80000008).ecx, 7, 0) + 1;
+        if (snapshot_.max_extended() >= 0x8000001E &&
+            features().has(Feature::TOPOEXT))
+            core_count_.threads_per_core =
+                extract_bits(snapshot_.get(0x8000001E).ebx, 15, 8) + 1;
+    } else {
+        core_count_.leaf = 0x04;
+        Register leaf01(snapshot_.get(0x01));
+        if (test_bit(leaf01.edx, 28))
+            core_count_.threads_per_package = extract_bits(leaf01.ebx, 23, 16);
+        if (snapshot_.max_basic() >= 0x04) {
+            unsigned cores = extract_bits(snapshot_.get(0x04).eax, 31, 26) + 1;
+            if (core_count_.threads_per_package > cores)
+                core_count_.threads_per_core =
+                    core_count_.threads_per_package / cores;
+        }
+    }
+
+    if (core_count_.threads_per_core == 0)
+        core_count_.threads_per_core = 1;
+    if (core_count_.threads_per_package < core_count_.threads_per_core)
+        core_count_.threads_per_package = core_count_.threads_per_core;
+    core_count_.cores_per_package =
+        core_count_.threads_per_package / core_count_.threads_per_core;
+
+    return core_count_;
+}
+
+const std::vector<TlbParam> &CpuInfo::tlbs() const
+{
+    if (tlbs_decoded_)
+        return tlbs_;
+
+    tlbs_decoded_ = true;
+    tlbs_ = leaf18_tlbs(snapshot_);
+    tlb_leaf_ = 0x18;
+    if (tlbs_.empty() && snapshot_.max_basic() >= 0x02) {
+        tlbs_ = leaf2_tlbs(snapshot_.get(0x02));
+        tlb_leaf_ = 0x02;
+    }
+    if (tlbs_.empty()) {
+        tlbs_ = amd_tlbs(snapshot_);
+        tlb_leaf_ = 0x80000005;
+    }
+    if (tlbs_.empty())
+        tlb_leaf_ = 0;
+
+    return tlbs_;
+}
+
+unsigned CpuInfo::tlb_leaf() const
+{
+    tlbs();
+
+    return tlb_leaf_;
+}
+
+const Features &CpuInfo::features() const
+{
+    if (features_decoded_)
+        return features_;
+
+    features_ = Features(snapshot_);
+    features_decoded_ = true;
+
+    return features_;
+}
+
+void CpuInfo::decode() const
+{
+    vendor();
+    brand();
+    caches();
+    frequency();
+    core_count();
+    tlbs();
+    features();
+}
+
+const CpuInfo &this_cpu()
+{
+    static const CpuInfo info(decoded_this_cpu());
+
+    return info;
+}
+
+} // namespace cpuid_info
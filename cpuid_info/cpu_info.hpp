@@ -0,0 +1,131 @@
+#ifndef CPUID_INFO_CPU_INFO_HPP
+#define CPUID_INFO_CPU_INFO_HPP
+
+#include <cpuid_info/cache_param.hpp>
+#include <cpuid_info/feature.hpp>
+#include <cpuid_info/snapshot.hpp>
+#include <cpuid_info/tlb.hpp>
+#include <string>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief Processor frequency information from leaf 0x16, in MHz
+struct Frequency {
+    unsigned base;
+    unsigned max;
+    unsigned bus;
+};
+
+/// \brief Logical CPU counts of one package as reported by the CPU
+///
+/// \details
+/// From leaf 0x1F/0x0B, else from 0x80000008 and 0x8000001E on AMD, else
+/// from leaves 0x01 and 0x04. These are the counts the package is built
+/// for, use Topology for the CPUs actually online.
+struct CoreCount {
+    unsigned threads_per_core;
+    unsigned cores_per_package;
+    unsigned threads_per_package;
+    unsigned leaf;  ///< 0x1F, 0x0B, 0x80000008 or 0x04 (with 0x01)
+};
+
+/// \brief Display family, model and stepping from leaf 0x01 EAX
+///
+/// \details
+/// The extended family is added to family 0xF, and the extended model
+/// prefixes the model of families 0x6 and 0xF, as the vendors document.
+struct Signature {
+    unsigned family;
+    unsigned model;
+    unsigned stepping;
+};
+
+enum class Vendor { Intel, AMD, Hygon, Other };
+
+/// \brief Identify the vendor from leaf 0x00 of a snapshot
+Vendor vendor_of(const Snapshot &snapshot);
+
+/// \brief Decoded view of a Snapshot
+///
+/// \details
+/// All decoding is done on first access and cached, no CPUID instruction is
+/// executed after construction. The lazy accessors are not safe to call
+/// concurrently on the same object before they have been called once, share
+/// a fully decoded object (e.g. `this_cpu()`) between threads instead.
+class CpuInfo
+{
+    public:
+    /// \brief Capture and decode the calling thread's CPU
+    CpuInfo();
+
+    explicit CpuInfo(const Snapshot &snapshot);
+
+    const Snapshot &snapshot() const { return snapshot_; }
+
+    const std::string &vendor() const;
+    Vendor vendor_id() const { return vendor_of(snapshot_); }
+    const std::string &brand() const;
+    Signature signature() const;
+    const std::vector<CacheParam> &caches() const;
+
+    /// \brief The leaf `caches()` are decoded from: 0x04, 0x8000001D, or
+    /// 0x80000005 for the legacy AMD leaves, zero if none is supported
+    unsigned cache_leaf() const;
+    const Frequency &frequency() const;
+    const CoreCount &core_count() const;
+
+    /// \brief TLBs from leaf 0x18, else from the leaf 0x02 descriptors,
+    /// else from the AMD leaves 0x80000005/0x80000006/0x80000019
+    const std::vector<TlbParam> &tlbs() const;
+
+    /// \brief The leaf `tlbs()` are decoded from, 0x18, 0x02 or 0x80000005,
+    /// or zero if none reports a TLB
+    unsigned tlb_leaf() const;
+
+    /// \brief Feature flags of leaves 0x01, 0x07 and 0x80000001
+    const Features &features() const;
+
+    /// \brief Decode everything now instead of on first access
+    void decode() const;
+
+    private:
+    Snapshot snapshot_;
+
+    mutable bool vendor_decoded_;
+    mutable bool brand_decoded_;
+    mutable bool caches_decoded_;
+    mutable bool frequency_decoded_;
+    mutable bool core_count_decoded_;
+    mutable bool tlbs_decoded_;
+    mutable unsigned tlb_leaf_;
+    mutable bool features_decoded_;
+    mutable std::string vendor_;
+    mutable std::string brand_;
+    mutable std::vector<CacheParam> caches_;
+    mutable Frequency frequency_;
+    mutable CoreCount core_count_;
+    mutable std::vector<TlbParam> tlbs_;
+    mutable Features features_;
+}; // class CpuInfo
+
+/// \brief The process wide, fully decoded information of the CPU running
+/// the first caller
+const CpuInfo &this_cpu();
+
+/// \brief Test a feature of `this_cpu()`
+///
+/// \details
+/// The feature set is copied once into a function local static, each call
+/// is then a guard check, a shift and a mask.
+inline bool has(Feature f)
+{
+    static const Features features(this_cpu().features());
+
+    return features.has(f);
+}
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_CPU_INFO_HPP
@@ -0,0 +1,79 @@
+#ifndef CPUID_INFO_CPUID_HPP
+#define CPUID_INFO_CPUID_HPP
+
+#ifdef _MSC
+#include <intrin.h>
+#endif
+
+namespace cpuid_info
+{
+
+struct Register {
+    unsigned eax;
+    unsigned ebx;
+    unsigned ecx;
+    unsigned edx;
+};
+
+/// \brief Execute the CPUID instruction on the calling thread's CPU
+inline Register cpuid(unsigned eax, unsigned ecx)
+{
+    Register reg;
+
+#ifdef _MSC
+    __cpuidex(reinterpret_cast<int *>(&reg), static_cast<int>(eax),
+        static_cast<int>(ecx));
+#else
+    unsigned ebx = 0;
+    unsigned edx = 0;
+    __asm__ volatile("cpuid\n"
+                     : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                     : "a"(eax), "c"(ecx));
+    reg.eax = eax;
+    reg.ebx = ebx;
+    reg.ecx = ecx;
+    reg.edx = edx;
+#endif
+
+    return reg;
+}
+
+inline unsigned extract_bits(unsigned r, int hi, int lo)
+{
+    return (r << (31 - hi)) >> (31 - hi + lo);
+}
+
+inline unsigned extract_byte(unsigned r, int b)
+{
+    return (r & (0xFFU << (b * 8))) >> (b * 8);
+}
+
+inline bool test_bit(unsigned r, int b) { return r & (0x01U << b); }
+
+/// \brief Ways of the 4-bit associativity field of the AMD leaves
+/// 0x80000006 and 0x80000019
+///
+/// \details
+/// Returns 0xFF for fully associative and 0 for disabled, reserved, or 0x9
+/// which defers to leaf 0x8000001D.
+inline unsigned amd_associativity(unsigned code)
+{
+    static const unsigned ways[16] = {
+        0, 1, 2, 3, 4, 6, 8, 0, 16, 0, 32, 48, 64, 96, 128, 0xFF};
+
+    return ways[code & 0xF];
+}
+
+/// \brief Number of bits needed to represent `x` distinct IDs
+inline unsigned ceil_log2(unsigned x)
+{
+    unsigned n = 0;
+    while (n < 32 && (1U << n) < x)
+        ++n;
+
+    return n;
+}
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_CPUID_HPP
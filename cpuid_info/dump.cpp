@@ -0,0 +1,181 @@
+#include <cpuid_info/affinity.hpp>
+#include <cpuid_info/dump.hpp>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+// Parse "0x" followed by up to 8 hex digits
+bool parse_hex(const char *&p, const char *end, unsigned &value)
+{
+    if (end - p < 3 || p[0] != '0' || (p[1] != 'x' && p[1] != 'X'))
+        return false;
+    p += 2;
+
+    value = 0;
+    const char *first = p;
+    for (; p != end && p - first != 8; ++p) {
+        char c = *p;
+        unsigned digit;
+        if (c >= '0' && c <= '9')
+            digit = static_cast<unsigned>(c - '0');
+        else if (c >= 'a' && c <= 'f')
+            digit = static_cast<unsigned>(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F')
+            digit = static_cast<unsigned>(c - 'A' + 10);
+        else
+            break;
+        value = value << 4 | digit;
+    }
+
+    return p != first;
+}
+
+// Skip one `c` and any spaces around it
+bool skip(const char *&p, const char *end, char c)
+{
+    while (p != end && *p == ' ')
+        ++p;
+    if (p == end || *p != c)
+        return c == ' ';
+    ++p;
+    while (p != end && *p == ' ')
+        ++p;
+
+    return true;
+}
+
+// Parse "name0x..." after optional spaces
+bool parse_register(
+    const char *&p, const char *end, const char *name, unsigned &value)
+{
+    while (p != end && *p == ' ')
+        ++p;
+    std::size_t n = std::strlen(name);
+    if (static_cast<std::size_t>(end - p) < n || std::memcmp(p, name, n) != 0)
+        return false;
+    p += n;
+
+    return parse_hex(p, end, value);
+}
+
+} // namespace
+
+std::vector<Snapshot> capture_all_cpus()
+{
+    std::vector<Snapshot> snapshots;
+    std::vector<int> cpus(allowed_cpus());
+    for (std::size_t i = 0; i != cpus.size(); ++i)
+        if (pin_this_thread(cpus[i]))
+            snapshots.push_back(Snapshot::capture());
+    if (!cpus.empty())
+        pin_this_thread(cpus);
+    if (snapshots.empty())
+        snapshots.push_back(Snapshot::capture());
+
+    return snapshots;
+}
+
+void write_dump(std::ostream &out, const std::vector<Snapshot> &snapshots)
+{
+    char line[96];
+    for (std::size_t i = 0; i != snapshots.size(); ++i) {
+        out << "CPU " << i << ":\n";
+        const std::vector<Leaf> &leaves = snapshots[i].leaves();
+        for (std::size_t j = 0; j != leaves.size(); ++j) {
+            const Leaf &leaf = leaves[j];
+            std::snprintf(line, sizeof(line),
+                "   0x%08x 0x%02x: eax=0x%08x ebx=0x%08x ecx=0x%08x "
+                "edx=0x%08x\n",
+                leaf.eax, leaf.ecx, leaf.reg.eax, leaf.reg.ebx, leaf.reg.ecx,
+                leaf.reg.edx);
+            out << line;
+        }
+    }
+}
+
+bool parse_dump(
+    const char *data, std::size_t size, std::vector<Snapshot> &snapshots)
+{
+    snapshots.clear();
+    bool found = false;
+    const char *end = data + size;
+    for (const char *p = data; p < end;) {
+        const char *eol = static_cast<const char *>(
+            std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+        if (eol == nullptr)
+            eol = end;
+
+        while (p != eol && (*p == ' ' || *p == '\t'))
+            ++p;
+        unsigned eax = 0;
+        unsigned ecx = 0;
+        Register reg;
+        if (eol - p >= 4 && std::memcmp(p, "CPU ", 4) == 0) {
+            snapshots.push_back(Snapshot());
+        } else if (parse_hex(p, eol, eax) && skip(p, eol, ' ') &&
+            parse_hex(p, eol, ecx) && skip(p, eol, ':') &&
+            parse_register(p, eol, "eax=", reg.eax) &&
+            parse_register(p, eol, "ebx=", reg.ebx) &&
+            parse_register(p, eol, "ecx=", reg.ecx) &&
+            parse_register(p, eol, "edx=", reg.edx)) {
+            if (snapshots.empty())
+                snapshots.push_back(Snapshot());
+            snapshots.back().insert(eax, ecx, reg);
+            found = true;
+        }
+        p = eol + 1;
+    }
+
+    // CPU headers without any leaf
+    for (std::size_t i = snapshots.size(); i != 0; --i)
+        if (snapshots[i - 1].leaves().empty())
+            snapshots.erase(snapshots.begin() + (i - 1));
+
+    return found;
+}
+
+bool read_dump(std::istream &in, std::vector<Snapshot> &snapshots)
+{
+    std::string data((std::istreambuf_iterator<char>(in)),
+        std::istreambuf_iterator<char>());
+
+    return parse_dump(data.data(), data.size(), snapshots);
+}
+
+bool save_dump(const std::string &path, const std::vector<Snapshot> &snapshots)
+{
+    if (path == "-") {
+        write_dump(std::cout, snapshots);
+        return std::cout.good();
+    }
+
+    std::ofstream out(path.c_str());
+    if (!out)
+        return false;
+    write_dump(out, snapshots);
+
+    return out.good();
+}
+
+bool load_dump(const std::string &path, std::vector<Snapshot> &snapshots)
+{
+    if (path == "-")
+        return read_dump(std::cin, snapshots);
+
+    std::ifstream in(path.c_str());
+    if (!in)
+        return false;
+
+    return read_dump(in, snapshots);
+}
+
+} // namespace cpuid_info
@@ -0,0 +1,49 @@
+#ifndef CPUID_INFO_DUMP_HPP
+#define CPUID_INFO_DUMP_HPP
+
+#include <cpuid_info/snapshot.hpp>
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief A full snapshot of every logical CPU the process may run on, in
+/// the order of `allowed_cpus()`
+///
+/// \details
+/// The calling thread is pinned to each CPU in turn and its affinity is
+/// restored afterwards. Without affinity support only the calling thread's
+/// CPU is captured.
+std::vector<Snapshot> capture_all_cpus();
+
+/// \brief Write snapshots in the raw format of `cpuid -r`
+///
+/// \details
+/// Each snapshot starts with a "CPU n:" line followed by one line per leaf,
+/// e.g. "   0x00000000 0x00: eax=0x00000020 ebx=0x756e6547 ...".
+void write_dump(std::ostream &out, const std::vector<Snapshot> &snapshots);
+
+/// \brief Read snapshots written by `write_dump()` or `cpuid -r`
+///
+/// \details
+/// Lines that are not a CPU header or a leaf are ignored, leaves before the
+/// first header form one snapshot. Returns false if no leaf was read.
+bool read_dump(std::istream &in, std::vector<Snapshot> &snapshots);
+
+/// \brief Read snapshots from a dump held in memory, e.g. a mapped file
+bool parse_dump(
+    const char *data, std::size_t size, std::vector<Snapshot> &snapshots);
+
+/// \brief Write a dump file, "-" writes to stdout
+bool save_dump(
+    const std::string &path, const std::vector<Snapshot> &snapshots);
+
+bool load_dump(const std::string &path, std::vector<Snapshot> &snapshots);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_DUMP_HPP
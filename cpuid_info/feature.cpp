@@ -0,0 +1,34 @@
+#include <cpuid_info/feature.hpp>
+
+namespace cpuid_info
+{
+
+Features::Features(const Snapshot &snapshot) : words_()
+{
+    // The table is ordered by leaf, look up each leaf only once
+    unsigned eax = 0;
+    unsigned ecx = 0;
+    Register reg(snapshot.get(eax, ecx));
+    for (unsigned i = 0; i != feature_count; ++i) {
+        const FeatureInfo &info = feature_table[i];
+        if (info.eax != eax || info.ecx != ecx) {
+            eax = info.eax;
+            ecx = info.ecx;
+            reg = snapshot.get(eax, ecx);
+        }
+        if (test_bit(register_value(reg, info.reg), info.bit))
+            set(static_cast<Feature>(i));
+    }
+}
+
+unsigned Features::count() const
+{
+    unsigned n = 0;
+    for (unsigned i = 0; i != word_count; ++i)
+        for (std::uint64_t w = words_[i]; w != 0; w &= w - 1)
+            ++n;
+
+    return n;
+}
+
+} // namespace cpuid_info
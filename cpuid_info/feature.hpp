@@ -0,0 +1,391 @@
+#ifndef CPUID_INFO_FEATURE_HPP
+#define CPUID_INFO_FEATURE_HPP
+
+#include <cpuid_info/snapshot.hpp>
+#include <cstdint>
+
+/// \brief The feature flag table, X(id, name, eax, ecx, reg, bit)
+///
+/// \details
+/// Both the `Feature` enumeration and the name table are generated from this
+/// list, keep it ordered by leaf, register and bit.
+#define CPUID_INFO_FEATURES(X)                                                 \
+    X(SSE3, "SSE3", 0x01, 0x00, ECX, 0)                                        \
+    X(PCLMULQDQ, "PCLMULQDQ", 0x01, 0x00, ECX, 1)                              \
+    X(DTES64, "DTES64", 0x01, 0x00, ECX, 2)                                    \
+    X(MONITOR, "MONITOR", 0x01, 0x00, ECX, 3)                                  \
+    X(DS_CPL, "DS-CPL", 0x01, 0x00, ECX, 4)                                    \
+    X(VMX, "VMX", 0x01, 0x00, ECX, 5)                                          \
+    X(SMX, "SMX", 0x01, 0x00, ECX, 6)                                          \
+    X(EIST, "EIST", 0x01, 0x00, ECX, 7)                                        \
+    X(TM2, "TM2", 0x01, 0x00, ECX, 8)                                          \
+    X(SSSE3, "SSSE3", 0x01, 0x00, ECX, 9)                                      \
+    X(CNXT_ID, "CNXT-ID", 0x01, 0x00, ECX, 10)                                 \
+    X(SDBG, "SDBG", 0x01, 0x00, ECX, 11)                                       \
+    X(FMA, "FMA", 0x01, 0x00, ECX, 12)                                         \
+    X(CMPXCHG16B, "CMPXCHG16B", 0x01, 0x00, ECX, 13)                           \
+    X(XTPR, "xTPR", 0x01, 0x00, ECX, 14)                                       \
+    X(PDCM, "PDCM", 0x01, 0x00, ECX, 15)                                       \
+    X(PCID, "PCID", 0x01, 0x00, ECX, 17)                                       \
+    X(DCA, "DCA", 0x01, 0x00, ECX, 18)                                         \
+    X(SSE4_1, "SSE4.1", 0x01, 0x00, ECX, 19)                                   \
+    X(SSE4_2, "SSE4.2", 0x01, 0x00, ECX, 20)                                   \
+    X(X2APIC, "x2APIC", 0x01, 0x00, ECX, 21)                                   \
+    X(MOVBE, "MOVBE", 0x01, 0x00, ECX, 22)                                     \
+    X(POPCNT, "POPCNT", 0x01, 0x00, ECX, 23)                                   \
+    X(TSC_DEADLINE, "TSC-Deadline", 0x01, 0x00, ECX, 24)                       \
+    X(AESNI, "AESNI", 0x01, 0x00, ECX, 25)                                     \
+    X(XSAVE, "XSAVE", 0x01, 0x00, ECX, 26)                                     \
+    X(OSXSAVE, "OSXSAVE", 0x01, 0x00, ECX, 27)                                 \
+    X(AVX, "AVX", 0x01, 0x00, ECX, 28)                                         \
+    X(F16C, "F16C", 0x01, 0x00, ECX, 29)                                       \
+    X(RDRAND, "RDRAND", 0x01, 0x00, ECX, 30)                                   \
+    X(HYPERVISOR, "Hypervisor", 0x01, 0x00, ECX, 31)                           \
+    X(FPU, "FPU", 0x01, 0x00, EDX, 0)                                          \
+    X(VME, "VME", 0x01, 0x00, EDX, 1)                                          \
+    X(DE, "DE", 0x01, 0x00, EDX, 2)                                            \
+    X(PSE, "PSE", 0x01, 0x00, EDX, 3)                                          \
+    X(TSC, "TSC", 0x01, 0x00, EDX, 4)                                          \
+    X(MSR, "MSR", 0x01, 0x00, EDX, 5)                                          \
+    X(PAE, "PAE", 0x01, 0x00, EDX, 6)                                          \
+    X(MCE, "MCE", 0x01, 0x00, EDX, 7)                                          \
+    X(CX8, "CX8", 0x01, 0x00, EDX, 8)                                          \
+    X(APIC, "APIC", 0x01, 0x00, EDX, 9)                                        \
+    X(SEP, "SEP", 0x01, 0x00, EDX, 11)                                         \
+    X(MTRR, "MTRR", 0x01, 0x00, EDX, 12)                                       \
+    X(PGE, "PGE", 0x01, 0x00, EDX, 13)                                         \
+    X(MCA, "MCA", 0x01, 0x00, EDX, 14)                                         \
+    X(CMOV, "CMOV", 0x01, 0x00, EDX, 15)                                       \
+    X(PAT, "PAT", 0x01, 0x00, EDX, 16)                                         \
+    X(PSE_36, "PSE-36", 0x01, 0x00, EDX, 17)                                   \
+    X(PSN, "PSN", 0x01, 0x00, EDX, 18)                                         \
+    X(CLFSH, "CLFSH", 0x01, 0x00, EDX, 19)                                     \
+    X(DS, "DS", 0x01, 0x00, EDX, 21)                                           \
+    X(ACPI, "ACPI", 0x01, 0x00, EDX, 22)                                       \
+    X(MMX, "MMX", 0x01, 0x00, EDX, 23)                                         \
+    X(FXSR, "FXSR", 0x01, 0x00, EDX, 24)                                       \
+    X(SSE, "SSE", 0x01, 0x00, EDX, 25)                                         \
+    X(SSE2, "SSE2", 0x01, 0x00, EDX, 26)                                       \
+    X(SS, "SS", 0x01, 0x00, EDX, 27)                                           \
+    X(HTT, "HTT", 0x01, 0x00, EDX, 28)                                         \
+    X(TM, "TM", 0x01, 0x00, EDX, 29)                                           \
+    X(IA64, "IA64", 0x01, 0x00, EDX, 30)                                       \
+    X(PBE, "PBE", 0x01, 0x00, EDX, 31)                                         \
+    X(FSGSBASE, "FSGSBASE", 0x07, 0x00, EBX, 0)                                \
+    X(IA32_TSC_ADJUST, "IA32_TSC_ADJUST", 0x07, 0x00, EBX, 1)                  \
+    X(SGX, "SGX", 0x07, 0x00, EBX, 2)                                          \
+    X(BMI1, "BMI1", 0x07, 0x00, EBX, 3)                                        \
+    X(HLE, "HLE", 0x07, 0x00, EBX, 4)                                          \
+    X(AVX2, "AVX2", 0x07, 0x00, EBX, 5)                                        \
+    X(SMEP, "SMEP", 0x07, 0x00, EBX, 7)                                        \
+    X(BMI2, "BMI2", 0x07, 0x00, EBX, 8)                                        \
+    X(ERMS, "ERMS", 0x07, 0x00, EBX, 9)                                        \
+    X(INVPCID, "INVPCID", 0x07, 0x00, EBX, 10)                                 \
+    X(RTM, "RTM", 0x07, 0x00, EBX, 11)                                         \
+    X(PQM, "PQM", 0x07, 0x00, EBX, 12)                                         \
+    X(FPU_CS_DS, "FPU_CS_DS", 0x07, 0x00, EBX, 13)                             \
+    X(MPX, "MPX", 0x07, 0x00, EBX, 14)                                         \
+    X(PQE, "PQE", 0x07, 0x00, EBX, 15)                                         \
+    X(AVX512F, "AVX512F", 0x07, 0x00, EBX, 16)                                 \
+    X(AVX512DQ, "AVX512DQ", 0x07, 0x00, EBX, 17)                               \
+    X(RDSEED, "RDSEED", 0x07, 0x00, EBX, 18)                                   \
+    X(ADX, "ADX", 0x07, 0x00, EBX, 19)                                         \
+    X(SMAP, "SMAP", 0x07, 0x00, EBX, 20)                                       \
+    X(AVX512IFMA52, "AVX512IFMA52", 0x07, 0x00, EBX, 21)                       \
+    X(PCOMMIT, "PCOMMIT", 0x07, 0x00, EBX, 22)                                 \
+    X(CLFLUSHOPT, "CLFLUSHOPT", 0x07, 0x00, EBX, 23)                           \
+    X(CLWB, "CLWB", 0x07, 0x00, EBX, 24)                                       \
+    X(INTEL_TRACE, "INTEL_TRACE", 0x07, 0x00, EBX, 25)                         \
+    X(AVX512PF, "AVX512PF", 0x07, 0x00, EBX, 26)                               \
+    X(AVX512ER, "AVX512ER", 0x07, 0x00, EBX, 27)                               \
+    X(AVX512CD, "AVX512CD", 0x07, 0x00, EBX, 28)                               \
+    X(SHA, "SHA", 0x07, 0x00, EBX, 29)                                         \
+    X(AVX512BW, "AVX512BW", 0x07, 0x00, EBX, 30)                               \
+    X(AVX512VL, "AVX512VL", 0x07, 0x00, EBX, 31)                               \
+    X(PREFETCHHWT1, "PREFETCHHWT1", 0x07, 0x00, ECX, 0)                        \
+    X(AVX512VBMI, "AVX512VBMI", 0x07, 0x00, ECX, 1)                            \
+    X(UMIP, "UMIP", 0x07, 0x00, ECX, 2)                                        \
+    X(PKU, "PKU", 0x07, 0x00, ECX, 3)                                          \
+    X(OSPKE, "OSPKE", 0x07, 0x00, ECX, 4)                                      \
+    X(WAITPKG, "WAITPKG", 0x07, 0x00, ECX, 5)                                  \
+    X(AVX512VBMI2, "AVX512VBMI2", 0x07, 0x00, ECX, 6)                          \
+    X(GFNI, "GFNI", 0x07, 0x00, ECX, 8)                                        \
+    X(VAES, "VAES", 0x07, 0x00, ECX, 9)                                        \
+    X(VPCLMULQDQ, "VPCLMULQDQ", 0x07, 0x00, ECX, 10)                           \
+    X(AVX512VNNI, "AVX512VNNI", 0x07, 0x00, ECX, 11)                           \
+    X(AVX512BITALG, "AVX512BITALG", 0x07, 0x00, ECX, 12)                       \
+    X(AVX512VPOPCNTDQ, "AVX512VPOPCNTDQ", 0x07, 0x00, ECX, 14)                 \
+    X(LA57, "LA57", 0x07, 0x00, ECX, 16)                                       \
+    X(RDPID, "RDPID", 0x07, 0x00, ECX, 22)                                     \
+    X(CLDEMOTE, "CLDEMOTE", 0x07, 0x00, ECX, 25)                               \
+    X(MOVDIRI, "MOVDIRI", 0x07, 0x00, ECX, 27)                                 \
+    X(MOVDIR64B, "MOVDIR64B", 0x07, 0x00, ECX, 28)                             \
+    X(FSRM, "FSRM", 0x07, 0x00, EDX, 4)                                        \
+    X(AVX512VP2INTERSECT, "AVX512VP2INTERSECT", 0x07, 0x00, EDX, 8)            \
+    X(MD_CLEAR, "MD_CLEAR", 0x07, 0x00, EDX, 10)                               \
+    X(SERIALIZE, "SERIALIZE", 0x07, 0x00, EDX, 14)                             \
+    X(HYBRID, "HYBRID", 0x07, 0x00, EDX, 15)                                   \
+    X(AMX_BF16, "AMX-BF16", 0x07, 0x00, EDX, 22)                               \
+    X(AVX512FP16, "AVX512FP16", 0x07, 0x00, EDX, 23)                           \
+    X(AMX_TILE, "AMX-TILE", 0x07, 0x00, EDX, 24)                               \
+    X(AMX_INT8, "AMX-INT8", 0x07, 0x00, EDX, 25)                               \
+    X(SPEC_CTRL, "IBRS_IBPB", 0x07, 0x00, EDX, 26)                             \
+    X(STIBP, "STIBP", 0x07, 0x00, EDX, 27)                                     \
+    X(L1D_FLUSH, "L1D_FLUSH", 0x07, 0x00, EDX, 28)                             \
+    X(ARCH_CAPABILITIES, "ARCH_CAP", 0x07, 0x00, EDX, 29)                      \
+    X(CORE_CAPABILITIES, "CORE_CAP", 0x07, 0x00, EDX, 30)                      \
+    X(SSBD, "SSBD", 0x07, 0x00, EDX, 31)                                       \
+    X(SHA512, "SHA512", 0x07, 0x01, EAX, 0)                                    \
+    X(SM3, "SM3", 0x07, 0x01, EAX, 1)                                          \
+    X(SM4, "SM4", 0x07, 0x01, EAX, 2)                                          \
+    X(AVX_VNNI, "AVX-VNNI", 0x07, 0x01, EAX, 4)                                \
+    X(AVX512BF16, "AVX512BF16", 0x07, 0x01, EAX, 5)                            \
+    X(CMPCCXADD, "CMPCCXADD", 0x07, 0x01, EAX, 7)                              \
+    X(FZRM, "FZRM", 0x07, 0x01, EAX, 10)                                       \
+    X(FSRS, "FSRS", 0x07, 0x01, EAX, 11)                                       \
+    X(FSRC, "FSRC", 0x07, 0x01, EAX, 12)                                       \
+    X(AMX_FP16, "AMX-FP16", 0x07, 0x01, EAX, 21)                               \
+    X(AVX_IFMA, "AVX-IFMA", 0x07, 0x01, EAX, 23)                               \
+    X(LAM, "LAM", 0x07, 0x01, EAX, 26)                                         \
+    X(AVX_VNNI_INT8, "AVX-VNNI-INT8", 0x07, 0x01, EDX, 4)                      \
+    X(AVX_NE_CONVERT, "AVX-NE-CONVERT", 0x07, 0x01, EDX, 5)                    \
+    X(AMX_COMPLEX, "AMX-COMPLEX", 0x07, 0x01, EDX, 8)                          \
+    X(AVX_VNNI_INT16, "AVX-VNNI-INT16", 0x07, 0x01, EDX, 10)                   \
+    X(PREFETCHI, "PREFETCHI", 0x07, 0x01, EDX, 14)                             \
+    X(AVX10, "AVX10", 0x07, 0x01, EDX, 19)                                     \
+    X(PSFD, "PSFD", 0x07, 0x02, EDX, 0)                                        \
+    X(IPRED_CTRL, "IPRED_CTRL", 0x07, 0x02, EDX, 1)                            \
+    X(RRSBA_CTRL, "RRSBA_CTRL", 0x07, 0x02, EDX, 2)                            \
+    X(DDPD_U, "DDPD_U", 0x07, 0x02, EDX, 3)                                    \
+    X(BHI_CTRL, "BHI_CTRL", 0x07, 0x02, EDX, 4)                                \
+    X(MCDT_NO, "MCDT_NO", 0x07, 0x02, EDX, 5)                                  \
+    X(LAHF_LM, "LAHF_LM", 0x80000001, 0x00, ECX, 0)                            \
+    X(CMP_LEGACY, "CMP_LEGACY", 0x80000001, 0x00, ECX, 1)                      \
+    X(SVM, "SVM", 0x80000001, 0x00, ECX, 2)                                    \
+    X(EXTAPIC, "EXTAPIC", 0x80000001, 0x00, ECX, 3)                            \
+    X(CR8_LEGACY, "CR8_LEGACY", 0x80000001, 0x00, ECX, 4)                      \
+    X(ABM, "ABM", 0x80000001, 0x00, ECX, 5)                                    \
+    X(SSE4A, "SSE4A", 0x80000001, 0x00, ECX, 6)                                \
+    X(MISALIGNSSE, "MISALIGNSSE", 0x80000001, 0x00, ECX, 7)                    \
+    X(AMD_3DNOWPREFETCH, "3DNOWPREFETCH", 0x80000001, 0x00, ECX, 8)            \
+    X(OSVW, "OSVW", 0x80000001, 0x00, ECX, 9)                                  \
+    X(IBS, "IBS", 0x80000001, 0x00, ECX, 10)                                   \
+    X(XOP, "XOP", 0x80000001, 0x00, ECX, 11)                                   \
+    X(SKINIT, "SKINIT", 0x80000001, 0x00, ECX, 12)                             \
+    X(WDT, "WDT", 0x80000001, 0x00, ECX, 13)                                   \
+    X(LWP, "LWP", 0x80000001, 0x00, ECX, 15)                                   \
+    X(FMA4, "FMA4", 0x80000001, 0x00, ECX, 16)                                 \
+    X(TCE, "TCE", 0x80000001, 0x00, ECX, 17)                                   \
+    X(NODEID_MSR, "NODEID_MSR", 0x80000001, 0x00, ECX, 19)                     \
+    X(TBM, "TBM", 0x80000001, 0x00, ECX, 21)                                   \
+    X(TOPOEXT, "TOPOEXT", 0x80000001, 0x00, ECX, 22)                           \
+    X(PERFCTR_CORE, "PERFCTR_CORE", 0x80000001, 0x00, ECX, 23)                 \
+    X(PERFCTR_NB, "PERFCTR_NB", 0x80000001, 0x00, ECX, 24)                     \
+    X(DBX, "DBX", 0x80000001, 0x00, ECX, 26)                                   \
+    X(PERFTSC, "PERFTSC", 0x80000001, 0x00, ECX, 27)                           \
+    X(PCX_L2I, "PCX_L2I", 0x80000001, 0x00, ECX, 28)                           \
+    X(EXT_FPU, "FPU", 0x80000001, 0x00, EDX, 0)                                \
+    X(EXT_VME, "VME", 0x80000001, 0x00, EDX, 1)                                \
+    X(EXT_DE, "DE", 0x80000001, 0x00, EDX, 2)                                  \
+    X(EXT_PSE, "PSE", 0x80000001, 0x00, EDX, 3)                                \
+    X(EXT_TSC, "TSC", 0x80000001, 0x00, EDX, 4)                                \
+    X(EXT_MSR, "MSR", 0x80000001, 0x00, EDX, 5)                                \
+    X(EXT_PAE, "PAE", 0x80000001, 0x00, EDX, 6)                                \
+    X(EXT_MCE, "MCE", 0x80000001, 0x00, EDX, 7)                                \
+    X(EXT_CX8, "CX8", 0x80000001, 0x00, EDX, 8)                                \
+    X(EXT_APIC, "APIC", 0x80000001, 0x00, EDX, 9)                              \
+    X(SYSCALL, "SYSCALL", 0x80000001, 0x00, EDX, 11)                           \
+    X(EXT_MTRR, "MTRR", 0x80000001, 0x00, EDX, 12)                             \
+    X(EXT_PGE, "PGE", 0x80000001, 0x00, EDX, 13)                               \
+    X(EXT_MCA, "MCA", 0x80000001, 0x00, EDX, 14)                               \
+    X(EXT_CMOV, "CMOV", 0x80000001, 0x00, EDX, 15)                             \
+    X(EXT_PAT, "PAT", 0x80000001, 0x00, EDX, 16)                               \
+    X(PSE36, "PSE36", 0x80000001, 0x00, EDX, 17)                               \
+    X(MP, "MP", 0x80000001, 0x00, EDX, 19)                                     \
+    X(NX, "NX", 0x80000001, 0x00, EDX, 20)                                     \
+    X(EXT_MMX, "MMX", 0x80000001, 0x00, EDX, 22)                               \
+    X(MMXEXT, "MMXEXT", 0x80000001, 0x00, EDX, 23)                             \
+    X(EXT_FXSR, "FXSR", 0x80000001, 0x00, EDX, 24)                             \
+    X(FXSR_OPT, "FXSR_OPT", 0x80000001, 0x00, EDX, 25)                         \
+    X(GBPAGES, "GBPAGES", 0x80000001, 0x00, EDX, 26)                           \
+    X(RDTSCP, "RDTSCP", 0x80000001, 0x00, EDX, 27)                             \
+    X(LM, "LM", 0x80000001, 0x00, EDX, 29)                                     \
+    X(AMD_3DNOWEXT, "3DNOWEXT", 0x80000001, 0x00, EDX, 30)                     \
+    X(AMD_3DNOW, "3DNOW", 0x80000001, 0x00, EDX, 31)                           \
+    X(AMD_IBPB, "IBPB", 0x80000008, 0x00, EBX, 12)                             \
+    X(AMD_IBRS, "IBRS", 0x80000008, 0x00, EBX, 14)                             \
+    X(AMD_STIBP, "STIBP", 0x80000008, 0x00, EBX, 15)                           \
+    X(IBRS_ALWAYS_ON, "IBRS_ALWAYS_ON", 0x80000008, 0x00, EBX, 16)             \
+    X(STIBP_ALWAYS_ON, "STIBP_ALWAYS_ON", 0x80000008, 0x00, EBX, 17)           \
+    X(IBRS_PREFERRED, "IBRS_PREFERRED", 0x80000008, 0x00, EBX, 18)             \
+    X(IBRS_SAME_MODE, "IBRS_SAME_MODE", 0x80000008, 0x00, EBX, 19)             \
+    X(AMD_SSBD, "SSBD", 0x80000008, 0x00, EBX, 24)                             \
+    X(VIRT_SSBD, "VIRT_SSBD", 0x80000008, 0x00, EBX, 25)                       \
+    X(SSB_NO, "SSB_NO", 0x80000008, 0x00, EBX, 26)                             \
+    X(AUTOIBRS, "AUTOIBRS", 0x80000021, 0x00, EAX, 8)                          \
+    X(SBPB, "SBPB", 0x80000021, 0x00, EAX, 27)                                 \
+    X(IBPB_BRTYPE, "IBPB_BRTYPE", 0x80000021, 0x00, EAX, 28)                   \
+    X(SRSO_NO, "SRSO_NO", 0x80000021, 0x00, EAX, 29)
+
+namespace cpuid_info
+{
+
+enum class RegisterName : unsigned char { EAX, EBX, ECX, EDX };
+
+inline unsigned register_value(const Register &reg, RegisterName name)
+{
+    switch (name) {
+        case RegisterName::EAX:
+            return reg.eax;
+        case RegisterName::EBX:
+            return reg.ebx;
+        case RegisterName::ECX:
+            return reg.ecx;
+        default:
+            return reg.edx;
+    }
+}
+
+enum class Feature : unsigned short {
+#define CPUID_INFO_FEATURE_ENUM(id, name, eax, ecx, reg, bit) id,
+    CPUID_INFO_FEATURES(CPUID_INFO_FEATURE_ENUM)
+#undef CPUID_INFO_FEATURE_ENUM
+        Count
+};
+
+const unsigned feature_count = static_cast<unsigned>(Feature::Count);
+
+/// \brief Where a feature flag lives and how it is printed
+struct FeatureInfo {
+    const char *name;
+    unsigned eax;
+    unsigned ecx;
+    RegisterName reg;
+    unsigned bit;
+};
+
+constexpr FeatureInfo feature_table[] = {
+#define CPUID_INFO_FEATURE_INFO(id, name, eax, ecx, reg, bit)                  \
+    {name, eax, ecx, RegisterName::reg, bit},
+    CPUID_INFO_FEATURES(CPUID_INFO_FEATURE_INFO)
+#undef CPUID_INFO_FEATURE_INFO
+};
+
+static_assert(sizeof(feature_table) / sizeof(FeatureInfo) == feature_count,
+    "feature_table does not match Feature");
+
+constexpr const FeatureInfo &feature_info(Feature f)
+{
+    return feature_table[static_cast<unsigned>(f)];
+}
+
+constexpr const char *feature_name(Feature f) { return feature_info(f).name; }
+
+/// \brief A thermal and power management capability of leaf 0x06
+struct PowerFeatureInfo {
+    RegisterName reg;
+    unsigned bit;
+    const char *name;
+};
+
+constexpr PowerFeatureInfo power_feature_table[] = {
+    {RegisterName::EAX, 0, "Digital temperature sensor"},
+    {RegisterName::EAX, 1, "Intel Turbo Boost Technology"},
+    {RegisterName::EAX, 2, "ARAT. APIC-Timer-always-running feature"},
+    {RegisterName::EAX, 4, "PLN. Power limit notification controls"},
+    {RegisterName::EAX, 5, "ECMD. Clock modulation duty cycle extension"},
+    {RegisterName::EAX, 6, "PTM. Package thermal management"},
+    {RegisterName::EAX, 7, "HWP base registers"},
+    {RegisterName::EAX, 8, "HWP_Notification"},
+    {RegisterName::EAX, 9, "HWP_Activity_Window"},
+    {RegisterName::EAX, 10, "HWP_Energy_Performance_Preference"},
+    {RegisterName::EAX, 11, "HWP_Package_Level_Request"},
+    {RegisterName::EAX, 13, "HDC base registers"},
+    {RegisterName::ECX, 0, "Hardware Coordination Feedback Capability"},
+    {RegisterName::ECX, 3, "Performance-energy bias preference"},
+};
+
+const unsigned power_feature_count =
+    sizeof(power_feature_table) / sizeof(PowerFeatureInfo);
+
+/// \brief A fixed size bitset indexed by Feature
+///
+/// \details
+/// Queries are a shift and a mask on an inline array, with no allocation,
+/// so `has()` is cheap enough for hot dispatch paths.
+class Features
+{
+    public:
+    static const unsigned word_count = (feature_count + 63) / 64;
+
+    Features() : words_() {}
+
+    /// \brief Populate from leaves 0x01, 0x07 and 0x80000001 of a snapshot
+    explicit Features(const Snapshot &snapshot);
+
+    bool has(Feature f) const
+    {
+        unsigned i = static_cast<unsigned>(f);
+
+        return (words_[i / 64] >> (i % 64)) & 1;
+    }
+
+    void set(Feature f, bool value = true)
+    {
+        unsigned i = static_cast<unsigned>(f);
+        std::uint64_t mask = std::uint64_t(1) << (i % 64);
+        words_[i / 64] = value ? words_[i / 64] | mask : words_[i / 64] & ~mask;
+    }
+
+    /// \brief True if every feature in `other` is also set here
+    bool contains(const Features &other) const
+    {
+        for (unsigned i = 0; i != word_count; ++i)
+            if ((words_[i] & other.words_[i]) != other.words_[i])
+                return false;
+
+        return true;
+    }
+
+    unsigned count() const;
+
+    Features &operator&=(const Features &other)
+    {
+        for (unsigned i = 0; i != word_count; ++i)
+            words_[i] &= other.words_[i];
+
+        return *this;
+    }
+
+    Features &operator|=(const Features &other)
+    {
+        for (unsigned i = 0; i != word_count; ++i)
+            words_[i] |= other.words_[i];
+
+        return *this;
+    }
+
+    bool operator==(const Features &other) const
+    {
+        for (unsigned i = 0; i != word_count; ++i)
+            if (words_[i] != other.words_[i])
+                return false;
+
+        return true;
+    }
+
+    bool operator!=(const Features &other) const { return !(*this == other); }
+
+    const std::uint64_t *words() const { return words_; }
+
+    private:
+    std::uint64_t words_[word_count];
+}; // class Features
+
+inline Features operator&(Features a, const Features &b) { return a &= b; }
+
+inline Features operator|(Features a, const Features &b) { return a |= b; }
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_FEATURE_HPP
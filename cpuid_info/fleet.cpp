@@ -0,0 +1,383 @@
+#include <cpuid_info/fleet.hpp>
+#include <cpuid_info/dump.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+/// \brief Read-only view of a whole file, memory mapped where available
+class MappedFile
+{
+    public:
+    explicit MappedFile(const std::string &path) : data_(nullptr), size_(0)
+    {
+#if defined(__linux__)
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return;
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void *p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size),
+                PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                data_ = static_cast<const char *>(p);
+                size_ = static_cast<std::size_t>(st.st_size);
+            }
+        }
+        ::close(fd);
+#else
+        std::ifstream in(path.c_str(), std::ios::binary);
+        copy_.assign(std::istreambuf_iterator<char>(in),
+            std::istreambuf_iterator<char>());
+        data_ = copy_.data();
+        size_ = copy_.size();
+#endif
+    }
+
+    ~MappedFile()
+    {
+#if defined(__linux__)
+        if (data_ != nullptr)
+            ::munmap(const_cast<char *>(data_), size_);
+#endif
+    }
+
+    const char *data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+    private:
+    MappedFile(const MappedFile &);
+    MappedFile &operator=(const MappedFile &);
+
+    const char *data_;
+    std::size_t size_;
+#if !defined(__linux__)
+    std::string copy_;
+#endif
+}; // class MappedFile
+
+// FNV-1a over every leaf, snapshots are sorted so equal register sets hash
+// equally
+std::uint64_t hash_snapshot(const Snapshot &snapshot)
+{
+    std::uint64_t h = 14695981039346656037ULL;
+    const std::vector<Leaf> &leaves = snapshot.leaves();
+    for (std::size_t i = 0; i != leaves.size(); ++i) {
+        const Leaf &leaf = leaves[i];
+        unsigned words[6] = {leaf.eax, leaf.ecx, leaf.reg.eax, leaf.reg.ebx,
+            leaf.reg.ecx, leaf.reg.edx};
+        for (unsigned w = 0; w != 6; ++w) {
+            h ^= words[w];
+            h *= 1099511628211ULL;
+        }
+    }
+
+    return h;
+}
+
+bool same_snapshot(const Snapshot &a, const Snapshot &b)
+{
+    const std::vector<Leaf> &x = a.leaves();
+    const std::vector<Leaf> &y = b.leaves();
+    if (x.size() != y.size())
+        return false;
+    for (std::size_t i = 0; i != x.size(); ++i) {
+        if (x[i].eax != y[i].eax || x[i].ecx != y[i].ecx ||
+            x[i].reg.eax != y[i].reg.eax || x[i].reg.ebx != y[i].reg.ebx ||
+            x[i].reg.ecx != y[i].reg.ecx || x[i].reg.edx != y[i].reg.edx)
+            return false;
+    }
+
+    return true;
+}
+
+/// \brief Distinct snapshots and how many hosts reported each
+class GroupSet
+{
+    public:
+    // Add `hosts` hosts to the group of `snapshot`, returns its index
+    std::size_t add(const Snapshot &snapshot, std::uint64_t hash,
+        unsigned long long hosts)
+    {
+        std::vector<std::size_t> &bucket = index_[hash];
+        std::size_t i = 0;
+        while (i != bucket.size() &&
+            !same_snapshot(groups_[bucket[i]].snapshot, snapshot))
+            ++i;
+        if (i == bucket.size()) {
+            FleetGroup group = {snapshot, 0};
+            bucket.push_back(groups_.size());
+            groups_.push_back(group);
+        }
+        groups_[bucket[i]].hosts += hosts;
+
+        return bucket[i];
+    }
+
+    // Add the groups of `other`, returns the index each got here
+    std::vector<std::size_t> merge(const GroupSet &other)
+    {
+        std::vector<std::size_t> index;
+        for (std::size_t i = 0; i != other.groups_.size(); ++i) {
+            const FleetGroup &group = other.groups_[i];
+            index.push_back(add(group.snapshot, hash_snapshot(group.snapshot),
+                group.hosts));
+        }
+
+        return index;
+    }
+
+    std::vector<FleetGroup> &groups() { return groups_; }
+
+    private:
+    std::vector<FleetGroup> groups_;
+    std::unordered_map<std::uint64_t, std::vector<std::size_t> > index_;
+}; // class GroupSet
+
+// Hosts per set of group indices, ascending
+typedef std::map<std::vector<std::size_t>, unsigned long long> MixCount;
+
+// Add the mixes of `from` to `to`, renumbering their groups through `index`
+void add_mixes(const MixCount &from, const std::vector<std::size_t> &index,
+    MixCount &to)
+{
+    std::vector<std::size_t> groups;
+    for (MixCount::const_iterator it = from.begin(); it != from.end(); ++it) {
+        groups.clear();
+        for (std::size_t i = 0; i != it->first.size(); ++i)
+            groups.push_back(index[it->first[i]]);
+        std::sort(groups.begin(), groups.end());
+        to[groups] += it->second;
+    }
+}
+
+struct WorkerResult {
+    GroupSet groups;
+    MixCount mixes;
+    unsigned long long hosts;
+    unsigned long long failed;
+};
+
+void ingest_files(const std::vector<std::string> &files,
+    std::atomic<std::size_t> &next, WorkerResult &result)
+{
+    std::vector<Snapshot> snapshots;
+    std::vector<std::size_t> mix;
+    for (;;) {
+        std::size_t i = next.fetch_add(1, std::memory_order_relaxed);
+        if (i >= files.size())
+            break;
+
+        MappedFile file(files[i]);
+        if (file.data() == nullptr ||
+            !parse_dump(file.data(), file.size(), snapshots)) {
+            ++result.failed;
+            continue;
+        }
+        ++result.hosts;
+
+        // Count each type once per host, a hybrid host has two
+        mix.clear();
+        for (std::size_t s = 0; s != snapshots.size(); ++s) {
+            Snapshot canonical(canonical_snapshot(snapshots[s]));
+            std::size_t group =
+                result.groups.add(canonical, hash_snapshot(canonical), 0);
+            if (std::find(mix.begin(), mix.end(), group) == mix.end())
+                mix.push_back(group);
+        }
+        for (std::size_t g = 0; g != mix.size(); ++g)
+            ++result.groups.groups()[mix[g]].hosts;
+        std::sort(mix.begin(), mix.end());
+        ++result.mixes[mix];
+    }
+}
+
+/// \brief Orders group indices by descending host count
+class MoreHosts
+{
+    public:
+    explicit MoreHosts(const std::vector<FleetGroup> &groups)
+        : groups_(groups)
+    {
+    }
+
+    bool operator()(std::size_t a, std::size_t b) const
+    {
+        return groups_[a].hosts > groups_[b].hosts;
+    }
+
+    private:
+    const std::vector<FleetGroup> &groups_;
+}; // class MoreHosts
+
+#if defined(__linux__)
+void walk(const std::string &path, std::vector<std::string> &files)
+{
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0)
+        return;
+    if (S_ISREG(st.st_mode)) {
+        files.push_back(path);
+        return;
+    }
+    if (!S_ISDIR(st.st_mode))
+        return;
+
+    DIR *dir = ::opendir(path.c_str());
+    if (dir == nullptr)
+        return;
+    std::vector<std::string> names;
+    while (struct dirent *entry = ::readdir(dir)) {
+        std::string name(entry->d_name);
+        if (name != "." && name != "..")
+            names.push_back(name);
+    }
+    ::closedir(dir);
+
+    std::sort(names.begin(), names.end());
+    std::string prefix(path);
+    if (prefix.empty() || prefix[prefix.size() - 1] != '/')
+        prefix += '/';
+    for (std::size_t i = 0; i != names.size(); ++i)
+        walk(prefix + names[i], files);
+}
+#endif
+
+} // namespace
+
+std::vector<std::string> list_dump_files(const std::string &path)
+{
+    std::vector<std::string> files;
+#if defined(__linux__)
+    walk(path, files);
+#else
+    files.push_back(path);
+#endif
+
+    return files;
+}
+
+Snapshot canonical_snapshot(const Snapshot &snapshot)
+{
+    Snapshot canonical;
+    const std::vector<Leaf> &leaves = snapshot.leaves();
+    for (std::size_t i = 0; i != leaves.size(); ++i) {
+        Leaf leaf = leaves[i];
+        switch (leaf.eax) {
+            case 0x01:
+                // Initial APIC ID
+                leaf.reg.ebx &= 0x00FFFFFF;
+                break;
+            case 0x0B:
+            case 0x1F:
+                // x2APIC ID
+                leaf.reg.edx = 0;
+                break;
+            case 0x8000001E:
+                // Extended APIC, core and node IDs
+                leaf.reg.eax = 0;
+                leaf.reg.ebx &= 0xFFFFFF00;
+                leaf.reg.ecx &= 0xFFFFFF00;
+                break;
+            case 0x80000026:
+                // x2APIC ID of the extended topology leaf
+                leaf.reg.edx = 0;
+                break;
+            default:
+                break;
+        }
+        canonical.insert(leaf.eax, leaf.ecx, leaf.reg);
+    }
+
+    return canonical;
+}
+
+FleetSummary ingest_fleet(const std::vector<std::string> &paths,
+    unsigned threads)
+{
+    std::vector<std::string> files;
+    for (std::size_t i = 0; i != paths.size(); ++i) {
+        std::vector<std::string> found(list_dump_files(paths[i]));
+        files.insert(files.end(), found.begin(), found.end());
+    }
+
+    if (threads == 0)
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(
+        std::max<std::size_t>(1, std::min<std::size_t>(threads, files.size())));
+
+    std::vector<WorkerResult> results(threads);
+    for (std::size_t i = 0; i != results.size(); ++i) {
+        results[i].hosts = 0;
+        results[i].failed = 0;
+    }
+
+    std::atomic<std::size_t> next(0);
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t) {
+        workers.push_back(std::thread(ingest_files, std::cref(files),
+            std::ref(next), std::ref(results[t])));
+    }
+    ingest_files(files, next, results[0]);
+    for (std::size_t i = 0; i != workers.size(); ++i)
+        workers[i].join();
+
+    FleetSummary summary;
+    summary.files = files.size();
+    summary.hosts = results[0].hosts;
+    summary.failed = results[0].failed;
+    for (std::size_t i = 1; i != results.size(); ++i) {
+        std::vector<std::size_t> index(
+            results[0].groups.merge(results[i].groups));
+        add_mixes(results[i].mixes, index, results[0].mixes);
+        summary.hosts += results[i].hosts;
+        summary.failed += results[i].failed;
+    }
+
+    // Most hosts first, the mixes follow the groups to their new indices
+    const std::vector<FleetGroup> &groups = results[0].groups.groups();
+    std::vector<std::size_t> order(groups.size());
+    for (std::size_t i = 0; i != order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), MoreHosts(groups));
+    std::vector<std::size_t> index(groups.size());
+    for (std::size_t i = 0; i != order.size(); ++i) {
+        index[order[i]] = i;
+        summary.groups.push_back(groups[order[i]]);
+    }
+    MixCount mixes;
+    add_mixes(results[0].mixes, index, mixes);
+    for (MixCount::const_iterator it = mixes.begin(); it != mixes.end();
+         ++it) {
+        FleetMix mix = {it->first, it->second};
+        summary.mixes.push_back(mix);
+    }
+
+    for (std::size_t i = 0; i != summary.groups.size(); ++i) {
+        Features features(summary.groups[i].snapshot);
+        summary.common = i == 0 ? features : summary.common & features;
+    }
+
+    return summary;
+}
+
+} // namespace cpuid_info
@@ -0,0 +1,71 @@
+#ifndef CPUID_INFO_FLEET_HPP
+#define CPUID_INFO_FLEET_HPP
+
+#include <cpuid_info/feature.hpp>
+#include <cpuid_info/snapshot.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief One distinct CPU type of a fleet
+struct FleetGroup {
+    /// \brief Canonical registers shared by every CPU of the group
+    Snapshot snapshot;
+
+    /// \brief Number of hosts with at least one CPU of this type
+    unsigned long long hosts;
+};
+
+/// \brief Hosts with the same set of CPU types
+struct FleetMix {
+    /// \brief Indices into FleetSummary::groups, ascending; a hybrid host
+    /// has two
+    std::vector<std::size_t> groups;
+
+    unsigned long long hosts;
+};
+
+/// \brief Distinct CPU types found in a set of dump files
+struct FleetSummary {
+    unsigned long long files;
+    unsigned long long hosts;
+
+    /// \brief Files that could not be read or contained no leaves
+    unsigned long long failed;
+
+    /// \brief Most common types first
+    std::vector<FleetGroup> groups;
+
+    /// \brief Every distinct set of types found on a host, so hosts can be
+    /// counted once across groups
+    std::vector<FleetMix> mixes;
+
+    /// \brief Features present on every group, the lowest common
+    /// denominator ISA of the fleet
+    Features common;
+};
+
+/// \brief Regular files under `path`, recursively if it is a directory
+std::vector<std::string> list_dump_files(const std::string &path);
+
+/// \brief Copy of `snapshot` with the fields that differ between the logical
+/// CPUs of one processor (APIC, core and node IDs) cleared
+Snapshot canonical_snapshot(const Snapshot &snapshot);
+
+/// \brief Read dump files, one host per file, and group their CPUs by
+/// identical canonical registers
+///
+/// \details
+/// Files are memory mapped and parsed by `threads` workers (one per
+/// hardware thread if 0). Each worker keeps one snapshot per distinct CPU
+/// type and a host count per distinct set of types, so memory grows with
+/// the number of types and not with the number of hosts.
+FleetSummary ingest_fleet(
+    const std::vector<std::string> &paths, unsigned threads = 0);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_FLEET_HPP
@@ -0,0 +1,101 @@
+#include <cpuid_info/hybrid.hpp>
+#include <cstddef>
+
+namespace cpuid_info
+{
+
+const char *core_type_name(CoreType type)
+{
+    switch (type) {
+        case CoreType::Efficiency:
+            return "Efficiency";
+        case CoreType::Performance:
+            return "Performance";
+        default:
+            return "Unknown";
+    }
+}
+
+CoreType core_type(const Snapshot &snapshot)
+{
+    if (snapshot.max_basic() < 0x1A)
+        return CoreType::Unknown;
+
+    switch (extract_bits(snapshot.get(0x1A).eax, 31, 24)) {
+        case 0x20:
+            return CoreType::Efficiency;
+        case 0x40:
+            return CoreType::Performance;
+        default:
+            return CoreType::Unknown;
+    }
+}
+
+unsigned native_model_id(const Snapshot &snapshot)
+{
+    if (snapshot.max_basic() < 0x1A)
+        return 0;
+
+    return extract_bits(snapshot.get(0x1A).eax, 23, 0);
+}
+
+bool is_hybrid(const Topology &topo)
+{
+    for (std::size_t i = 0; i != topo.cpus().size(); ++i)
+        if (Features(topo.cpus()[i].snapshot).has(Feature::HYBRID))
+            return true;
+
+    return false;
+}
+
+std::vector<CoreClass> core_classes(const Topology &topo)
+{
+    std::vector<CoreClass> classes;
+    for (std::size_t i = 0; i != topo.cpus().size(); ++i) {
+        const LogicalCpu &cpu = topo.cpus()[i];
+        CoreType type = core_type(cpu.snapshot);
+        unsigned model = native_model_id(cpu.snapshot);
+
+        std::size_t j = 0;
+        while (j != classes.size() &&
+            (classes[j].type != type || classes[j].native_model != model))
+            ++j;
+        if (j == classes.size()) {
+            CpuInfo info(cpu.snapshot);
+            CoreClass cls;
+            cls.type = type;
+            cls.native_model = model;
+            cls.features = info.features();
+            cls.caches = info.caches();
+            cls.frequency = info.frequency();
+            classes.push_back(cls);
+        }
+        classes[j].cpus.push_back(cpu.os_id);
+    }
+
+    // Performance before efficiency before unknown
+    std::vector<CoreClass> sorted;
+    const CoreType order[] = {
+        CoreType::Performance, CoreType::Efficiency, CoreType::Unknown};
+    for (std::size_t k = 0; k != sizeof(order) / sizeof(CoreType); ++k)
+        for (std::size_t j = 0; j != classes.size(); ++j)
+            if (classes[j].type == order[k])
+                sorted.push_back(classes[j]);
+
+    return sorted;
+}
+
+std::vector<int> performance_cpus(const Topology &topo)
+{
+    std::vector<int> cpus;
+    bool hybrid = is_hybrid(topo);
+    for (std::size_t i = 0; i != topo.cpus().size(); ++i) {
+        const LogicalCpu &cpu = topo.cpus()[i];
+        if (!hybrid || core_type(cpu.snapshot) == CoreType::Performance)
+            cpus.push_back(cpu.os_id);
+    }
+
+    return cpus;
+}
+
+} // namespace cpuid_info
@@ -0,0 +1,49 @@
+#ifndef CPUID_INFO_HYBRID_HPP
+#define CPUID_INFO_HYBRID_HPP
+
+#include <cpuid_info/cache_param.hpp>
+#include <cpuid_info/cpu_info.hpp>
+#include <cpuid_info/feature.hpp>
+#include <cpuid_info/topology.hpp>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief Core type reported by leaf 0x1A
+enum class CoreType { Unknown, Efficiency, Performance };
+
+const char *core_type_name(CoreType type);
+
+/// \brief Core type of the CPU a snapshot was captured on
+CoreType core_type(const Snapshot &snapshot);
+
+/// \brief Native model ID of the CPU a snapshot was captured on (leaf 0x1A
+/// EAX[23:0])
+unsigned native_model_id(const Snapshot &snapshot);
+
+/// \brief All logical CPUs of one core type and native model, and what they
+/// report
+struct CoreClass {
+    CoreType type;
+    unsigned native_model;
+    std::vector<int> cpus;
+    Features features;
+    std::vector<CacheParam> caches;
+    Frequency frequency;
+};
+
+/// \brief True if any CPU of the topology sets the hybrid flag of leaf 0x07
+bool is_hybrid(const Topology &topo);
+
+/// \brief Group logical CPUs by core type and native model ID, performance
+/// cores first
+std::vector<CoreClass> core_classes(const Topology &topo);
+
+/// \brief CPUs of the performance core class, or all CPUs if the processor
+/// is not hybrid
+std::vector<int> performance_cpus(const Topology &topo);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_HYBRID_HPP
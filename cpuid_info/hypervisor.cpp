@@ -0,0 +1,278 @@
+#include <cpuid_info/bench.hpp>
+#include <cpuid_info/hypervisor.hpp>
+#include <cpuid_info/timestamp.hpp>
+#include <cstdint>
+#include <cstring>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+struct VendorSignature {
+    const char *text;
+    Hypervisor hypervisor;
+};
+
+const VendorSignature signature_table[] = {
+    {"KVMKVMKVM", Hypervisor::KVM},
+    {"Microsoft Hv", Hypervisor::HyperV},
+    {"XenVMMXenVMM", Hypervisor::Xen},
+    {"VMwareVMware", Hypervisor::VMware},
+    {"VBoxVBoxVBox", Hypervisor::VirtualBox},
+    {"bhyve bhyve ", Hypervisor::Bhyve},
+    {"TCGTCGTCGTCG", Hypervisor::QEMU},
+    {"ACRNACRNACRN", Hypervisor::ACRN},
+    {" lrpepyh  vr", Hypervisor::Parallels},
+};
+
+const std::size_t signature_count =
+    sizeof(signature_table) / sizeof(VendorSignature);
+
+// Paravirtual feature bits and the names QEMU and Linux use for them
+struct FeatureBit {
+    unsigned bit;
+    const char *name;
+};
+
+// Leaf 0x40000001 EAX
+const FeatureBit kvm_table[] = {
+    {0, "kvmclock"},
+    {1, "nop-io-delay"},
+    {3, "kvmclock2"},
+    {4, "async-pf"},
+    {5, "steal-time"},
+    {6, "pv-eoi"},
+    {7, "pv-unhalt"},
+    {9, "pv-tlb-flush"},
+    {10, "async-pf-vmexit"},
+    {11, "pv-send-ipi"},
+    {12, "poll-control"},
+    {13, "pv-sched-yield"},
+    {14, "async-pf-int"},
+    {15, "msi-ext-dest-id"},
+    {16, "hc-map-gpa-range"},
+    {17, "migration-control"},
+    {24, "kvmclock-stable"},
+};
+
+const std::size_t kvm_count = sizeof(kvm_table) / sizeof(FeatureBit);
+
+// Partition privileges, leaf 0x40000003 EAX
+const FeatureBit hyperv_table[] = {
+    {1, "hv-time-ref-count"},
+    {2, "hv-synic"},
+    {3, "hv-stimer"},
+    {4, "hv-apic-msrs"},
+    {5, "hv-hypercall"},
+    {6, "hv-vpindex"},
+    {9, "hv-reference-tsc"},
+    {10, "hv-guest-idle"},
+    {11, "hv-frequencies"},
+    {13, "hv-reenlightenment"},
+    {15, "hv-tsc-invariant"},
+};
+
+const std::size_t hyperv_count = sizeof(hyperv_table) / sizeof(FeatureBit);
+
+// "Hv#1" in EAX of the leaf after the signature
+const unsigned hyperv_interface_id = 0x31237648;
+
+const unsigned hypervisor_base = 0x40000000;
+const unsigned hypervisor_alt_base = 0x40000100;
+
+std::string range_signature(const Register &reg)
+{
+    char text[12];
+    std::memcpy(text, &reg.ebx, 4);
+    std::memcpy(text + 4, &reg.ecx, 4);
+    std::memcpy(text + 8, &reg.edx, 4);
+    std::size_t n = 12;
+    while (n != 0 && text[n - 1] == '\0')
+        --n;
+
+    return std::string(text, n);
+}
+
+Hypervisor identify(const std::string &signature)
+{
+    for (std::size_t i = 0; i != signature_count; ++i)
+        if (signature == signature_table[i].text)
+            return signature_table[i].hypervisor;
+
+    return Hypervisor::Unknown;
+}
+
+void add_features(unsigned reg, const FeatureBit *table, std::size_t n,
+    std::vector<const char *> &features)
+{
+    for (std::size_t i = 0; i != n; ++i)
+        if (test_bit(reg, table[i].bit))
+            features.push_back(table[i].name);
+}
+
+// Instructions measured by measure_exit_costs()
+struct RunCpuid {
+    static std::uint64_t run() { return cpuid(0x00, 0x00).eax; }
+};
+
+struct RunRdtsc {
+    static std::uint64_t run() { return rdtsc(); }
+};
+
+struct RunRdtscp {
+    static std::uint64_t run()
+    {
+        unsigned aux = 0;
+        __asm__ volatile("rdtscp" : "=c"(aux) : : "eax", "edx");
+        return aux;
+    }
+};
+
+struct RunRdpid {
+    static std::uint64_t run()
+    {
+        std::uint64_t id = 0;
+        __asm__ volatile("rdpid %0" : "=r"(id));
+        return id;
+    }
+};
+
+template <typename Run>
+void run_loop(unsigned long iterations)
+{
+    std::uint64_t sum = 0;
+    for (unsigned long i = 0; i != iterations; ++i)
+        sum += Run::run();
+    do_not_optimize(sum);
+}
+
+template <typename Run>
+double run_cost(double ms)
+{
+    return time_per_iteration(run_loop<Run>, ms);
+}
+
+ExitCost exit_cost(const char *name, double ns)
+{
+    ExitCost cost = {name, ns, ns >= vm_exit_ns};
+    return cost;
+}
+
+} // namespace
+
+const char *hypervisor_name(Hypervisor hypervisor)
+{
+    switch (hypervisor) {
+        case Hypervisor::None:
+            return "None";
+        case Hypervisor::KVM:
+            return "KVM";
+        case Hypervisor::HyperV:
+            return "Hyper-V";
+        case Hypervisor::Xen:
+            return "Xen";
+        case Hypervisor::VMware:
+            return "VMware";
+        case Hypervisor::VirtualBox:
+            return "VirtualBox";
+        case Hypervisor::Bhyve:
+            return "bhyve";
+        case Hypervisor::QEMU:
+            return "QEMU (TCG)";
+        case Hypervisor::ACRN:
+            return "ACRN";
+        case Hypervisor::Parallels:
+            return "Parallels";
+        default:
+            return "Unknown";
+    }
+}
+
+HypervisorInfo hypervisor_info(const Snapshot &snapshot)
+{
+    HypervisorInfo info;
+    info.vendor = Hypervisor::None;
+    info.base = 0;
+    info.max_leaf = 0;
+    info.hyperv_interface = false;
+    info.stable_clock = false;
+    info.tsc_emulated = false;
+    info.dedicated_cpus = false;
+    info.tsc_hz = 0;
+    info.apic_hz = 0;
+    if (!test_bit(snapshot.get(0x01).ecx, 31))
+        return info;
+
+    info.vendor = Hypervisor::Unknown;
+    unsigned hyperv_base = 0;
+    const unsigned bases[] = {hypervisor_base, hypervisor_alt_base};
+    for (std::size_t i = 0; i != 2; ++i) {
+        unsigned base = bases[i];
+        if (!snapshot.contains(base))
+            continue;
+        Register reg(snapshot.get(base));
+        std::string signature(range_signature(reg));
+        Hypervisor vendor = identify(signature);
+        if (vendor == Hypervisor::HyperV ||
+            snapshot.get(base + 1).eax == hyperv_interface_id)
+            hyperv_base = base;
+        // Prefer the hypervisor's own interface over its Hyper-V emulation
+        if (i == 0 || vendor != Hypervisor::HyperV) {
+            info.vendor = vendor;
+            info.signature = signature;
+            info.base = base;
+            info.max_leaf = reg.eax > base ? reg.eax : base + 1;
+        }
+    }
+
+    unsigned base = info.base;
+    if (info.vendor == Hypervisor::KVM) {
+        Register reg(snapshot.get(base + 1));
+        add_features(reg.eax, kvm_table, kvm_count, info.features);
+        info.stable_clock = test_bit(reg.eax, 24);
+        info.dedicated_cpus = test_bit(reg.edx, 0);
+    }
+    if (hyperv_base != 0) {
+        info.hyperv_interface = true;
+        Register reg(snapshot.get(hyperv_base + 3));
+        add_features(reg.eax, hyperv_table, hyperv_count, info.features);
+        if (info.vendor == Hypervisor::HyperV)
+            info.stable_clock = test_bit(reg.eax, 15);
+    }
+    if (info.vendor == Hypervisor::Xen && info.max_leaf >= base + 3) {
+        Register reg(snapshot.get(base + 3));
+        info.tsc_emulated = test_bit(reg.eax, 0);
+        info.stable_clock = test_bit(reg.eax, 1);
+        if (info.tsc_emulated)
+            info.features.push_back("vtsc");
+        if (test_bit(reg.eax, 2))
+            info.features.push_back("rdtscp");
+        // Guest frequency in kHz, else the host's in subleaf 2
+        unsigned khz = reg.ecx != 0 ? reg.ecx : snapshot.get(base + 3, 2).eax;
+        info.tsc_hz = khz * 1e3;
+    } else if (info.vendor != Hypervisor::HyperV &&
+        info.max_leaf >= base + 0x10) {
+        Register reg(snapshot.get(base + 0x10));
+        info.tsc_hz = reg.eax * 1e3;
+        info.apic_hz = reg.ebx * 1e3;
+    }
+
+    return info;
+}
+
+std::vector<ExitCost> measure_exit_costs(bool rdtscp, bool rdpid, double ms)
+{
+    std::vector<ExitCost> costs;
+    costs.push_back(exit_cost("cpuid", run_cost<RunCpuid>(ms)));
+    costs.push_back(exit_cost("rdtsc", run_cost<RunRdtsc>(ms)));
+    if (rdtscp)
+        costs.push_back(exit_cost("rdtscp", run_cost<RunRdtscp>(ms)));
+    if (rdpid)
+        costs.push_back(exit_cost("rdpid", run_cost<RunRdpid>(ms)));
+
+    return costs;
+}
+
+} // namespace cpuid_info
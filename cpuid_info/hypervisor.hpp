@@ -0,0 +1,89 @@
+#ifndef CPUID_INFO_HYPERVISOR_HPP
+#define CPUID_INFO_HYPERVISOR_HPP
+
+#include <cpuid_info/snapshot.hpp>
+#include <string>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief Hypervisors told apart by the signature of leaf 0x40000000
+enum class Hypervisor {
+    None,     ///< Leaf 0x01 ECX bit 31 clear, bare metal
+    Unknown,  ///< Bit 31 set, signature not recognized
+    KVM,
+    HyperV,
+    Xen,
+    VMware,
+    VirtualBox,
+    Bhyve,
+    QEMU,  ///< TCG emulation
+    ACRN,
+    Parallels
+};
+
+const char *hypervisor_name(Hypervisor hypervisor);
+
+/// \brief The hypervisor and its paravirtual interface
+struct HypervisorInfo {
+    Hypervisor vendor;
+    std::string signature;
+    unsigned base;      ///< First leaf of the vendor's range
+    unsigned max_leaf;  ///< Last leaf of the vendor's range
+
+    /// \brief Hyper-V enlightenments are offered, also by KVM or Xen
+    bool hyperv_interface;
+
+    /// \brief The paravirtual clock is stable across vCPUs (KVM bit 24 of
+    /// leaf 0x40000001, Hyper-V invariant TSC, Xen reliable host TSC)
+    bool stable_clock;
+
+    bool tsc_emulated;    ///< Xen traps RDTSC to scale or offset it
+    bool dedicated_cpus;  ///< KVM hint: vCPUs are never preempted
+
+    double tsc_hz;   ///< Guest TSC frequency, zero if not reported
+    double apic_hz;  ///< APIC timer frequency, zero if not reported
+
+    /// \brief Names of the paravirtual features, e.g. "kvmclock"
+    std::vector<const char *> features;
+
+    bool empty() const { return vendor == Hypervisor::None; }
+};
+
+/// \brief Decode the hypervisor leaves
+///
+/// \details
+/// A hypervisor offering Hyper-V enlightenments answers with "Microsoft
+/// Hv" at 0x40000000 and its own signature at 0x40000100; the latter is
+/// reported as the vendor. The TSC frequency comes from the VMware timing
+/// leaf 0x40000010 (also offered by KVM with QEMU's vmware-cpuid-freq) or
+/// Xen's time leaf.
+HypervisorInfo hypervisor_info(const Snapshot &snapshot);
+
+/// \brief Cost of an instruction a hypervisor may intercept
+struct ExitCost {
+    const char *name;
+    double ns;         ///< Per instruction, back to back
+    bool likely_exit;  ///< At least `vm_exit_ns`
+};
+
+/// \brief Cost above which an instruction most likely exits to the
+/// hypervisor: a VM exit and entry take well over 500 cycles, CPUID runs
+/// natively in 100 to 250 and RDTSC in about 25
+const double vm_exit_ns = 150;
+
+/// \brief Time CPUID, RDTSC, RDTSCP and RDPID (when supported) back to back
+/// on the calling thread for at least `ms` milliseconds each
+///
+/// \details
+/// CPUID always exits under VT-x and AMD-V. RDTSC and RDTSCP exit only if
+/// the hypervisor emulates the TSC, e.g. to hide a frequency change after
+/// migration without TSC scaling, which makes every timestamp on a hot
+/// path cost microseconds.
+std::vector<ExitCost> measure_exit_costs(
+    bool rdtscp, bool rdpid, double ms = 20);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_HYPERVISOR_HPP
@@ -0,0 +1,170 @@
+#include <cpuid_info/mitigation.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+
+#if defined(__linux__)
+#include <dirent.h>
+#endif
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+const Feature control_table[] = {
+    Feature::MD_CLEAR,
+    Feature::SPEC_CTRL,
+    Feature::STIBP,
+    Feature::L1D_FLUSH,
+    Feature::ARCH_CAPABILITIES,
+    Feature::CORE_CAPABILITIES,
+    Feature::SSBD,
+    Feature::PSFD,
+    Feature::IPRED_CTRL,
+    Feature::RRSBA_CTRL,
+    Feature::DDPD_U,
+    Feature::BHI_CTRL,
+    Feature::MCDT_NO,
+    Feature::AMD_IBPB,
+    Feature::AMD_IBRS,
+    Feature::AMD_STIBP,
+    Feature::IBRS_ALWAYS_ON,
+    Feature::STIBP_ALWAYS_ON,
+    Feature::IBRS_PREFERRED,
+    Feature::IBRS_SAME_MODE,
+    Feature::AMD_SSBD,
+    Feature::VIRT_SSBD,
+    Feature::SSB_NO,
+    Feature::AUTOIBRS,
+    Feature::SBPB,
+    Feature::IBPB_BRTYPE,
+    Feature::SRSO_NO,
+};
+
+const std::size_t control_count = sizeof(control_table) / sizeof(Feature);
+
+// Which controls bear on which file of the vulnerabilities directory
+struct Relevance {
+    const char *vulnerability;
+    Feature control;
+};
+
+const Relevance relevance_table[] = {
+    {"spectre_v2", Feature::SPEC_CTRL},
+    {"spectre_v2", Feature::STIBP},
+    {"spectre_v2", Feature::IPRED_CTRL},
+    {"spectre_v2", Feature::RRSBA_CTRL},
+    {"spectre_v2", Feature::BHI_CTRL},
+    {"spectre_v2", Feature::AMD_IBPB},
+    {"spectre_v2", Feature::AMD_IBRS},
+    {"spectre_v2", Feature::AMD_STIBP},
+    {"spectre_v2", Feature::IBRS_ALWAYS_ON},
+    {"spectre_v2", Feature::STIBP_ALWAYS_ON},
+    {"spectre_v2", Feature::IBRS_PREFERRED},
+    {"spectre_v2", Feature::IBRS_SAME_MODE},
+    {"spectre_v2", Feature::AUTOIBRS},
+    {"spec_store_bypass", Feature::SSBD},
+    {"spec_store_bypass", Feature::PSFD},
+    {"spec_store_bypass", Feature::AMD_SSBD},
+    {"spec_store_bypass", Feature::VIRT_SSBD},
+    {"spec_store_bypass", Feature::SSB_NO},
+    {"l1tf", Feature::L1D_FLUSH},
+    {"mds", Feature::MD_CLEAR},
+    {"tsx_async_abort", Feature::MD_CLEAR},
+    {"mmio_stale_data", Feature::MD_CLEAR},
+    {"reg_file_data_sampling", Feature::MD_CLEAR},
+    {"retbleed", Feature::SPEC_CTRL},
+    {"retbleed", Feature::AMD_IBPB},
+    {"retbleed", Feature::AMD_IBRS},
+    {"retbleed", Feature::AUTOIBRS},
+    {"spec_rstack_overflow", Feature::AMD_IBPB},
+    {"spec_rstack_overflow", Feature::SBPB},
+    {"spec_rstack_overflow", Feature::IBPB_BRTYPE},
+    {"spec_rstack_overflow", Feature::SRSO_NO},
+};
+
+const std::size_t relevance_count =
+    sizeof(relevance_table) / sizeof(Relevance);
+
+// Prefixes of the mitigation options in the kernel's parameter list
+const char *const option_table[] = {
+    "mitigations=", "nospectre", "spectre", "nopti", "pti=", "mds=",
+    "tsx", "l1tf=", "nossb", "spec_store_bypass_disable=", "ssbd=",
+    "retbleed=", "mmio_stale_data=", "srbds=", "gather_data_sampling=",
+    "reg_file_data_sampling=", "spec_rstack_overflow=", "nosmt",
+};
+
+const std::size_t option_count = sizeof(option_table) / sizeof(char *);
+
+} // namespace
+
+std::vector<Feature> speculation_controls(const Features &features)
+{
+    std::vector<Feature> controls;
+    for (std::size_t i = 0; i != control_count; ++i)
+        if (features.has(control_table[i]))
+            controls.push_back(control_table[i]);
+
+    return controls;
+}
+
+std::vector<Vulnerability> read_vulnerabilities(
+    const Features &features, const std::string &dir)
+{
+    std::vector<Vulnerability> result;
+#if defined(__linux__)
+    DIR *d = ::opendir(dir.c_str());
+    if (d == nullptr)
+        return result;
+    std::vector<std::string> names;
+    while (struct dirent *entry = ::readdir(d)) {
+        std::string name(entry->d_name);
+        if (name != "." && name != "..")
+            names.push_back(name);
+    }
+    ::closedir(d);
+    std::sort(names.begin(), names.end());
+
+    for (std::size_t i = 0; i != names.size(); ++i) {
+        Vulnerability vuln;
+        vuln.name = names[i];
+        std::ifstream in((dir + "/" + names[i]).c_str());
+        if (!std::getline(in, vuln.status))
+            continue;
+        for (std::size_t j = 0; j != relevance_count; ++j) {
+            const Relevance &rel = relevance_table[j];
+            if (vuln.name == rel.vulnerability && features.has(rel.control))
+                vuln.controls.push_back(rel.control);
+        }
+        result.push_back(vuln);
+    }
+#else
+    static_cast<void>(features);
+    static_cast<void>(dir);
+#endif
+
+    return result;
+}
+
+std::vector<std::string> mitigation_options(const std::string &path)
+{
+    std::vector<std::string> options;
+    std::ifstream in(path.c_str());
+    std::string word;
+    while (in >> word) {
+        for (std::size_t i = 0; i != option_count; ++i) {
+            if (word.compare(0, std::strlen(option_table[i]),
+                    option_table[i]) == 0) {
+                options.push_back(word);
+                break;
+            }
+        }
+    }
+
+    return options;
+}
+
+} // namespace cpuid_info
@@ -0,0 +1,43 @@
+#ifndef CPUID_INFO_MITIGATION_HPP
+#define CPUID_INFO_MITIGATION_HPP
+
+#include <cpuid_info/feature.hpp>
+#include <string>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief The speculation controls of leaves 0x07 and 0x80000008/0x80000021
+/// the CPU (or hypervisor) offers
+std::vector<Feature> speculation_controls(const Features &features);
+
+/// \brief A CPU vulnerability as the kernel reports it
+struct Vulnerability {
+    std::string name;    ///< File name, e.g. "spectre_v2"
+    std::string status;  ///< e.g. "Mitigation: Enhanced / Automatic IBRS"
+
+    /// \brief Controls present on this CPU that the kernel can mitigate
+    /// the vulnerability with, or that declare the CPU not affected
+    std::vector<Feature> controls;
+};
+
+/// \brief Read every file of the kernel's vulnerabilities directory and
+/// pair it with the relevant controls of `features`
+///
+/// \details
+/// The kernel picks a mitigation from these controls, the microcode
+/// revision, IA32_ARCH_CAPABILITIES (only readable through the msr driver)
+/// and the command line, so hosts with the same CPUID can differ. Empty if
+/// the directory cannot be read.
+std::vector<Vulnerability> read_vulnerabilities(const Features &features,
+    const std::string &dir = "/sys/devices/system/cpu/vulnerabilities");
+
+/// \brief Options of the kernel command line that select mitigations,
+/// e.g. "mitigations=off" or "spectre_v2=retpoline"
+std::vector<std::string> mitigation_options(
+    const std::string &path = "/proc/cmdline");
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_MITIGATION_HPP
@@ -0,0 +1,403 @@
+#include <cpuid_info/bench.hpp>
+#include <cpuid_info/monitor.hpp>
+#include <cpuid_info/timestamp.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <sstream>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+const unsigned msr_mperf = 0xE7;
+const unsigned msr_aperf = 0xE8;
+
+#if defined(__linux__)
+int open_event(unsigned long long config, int cpu, int group)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+        PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(
+        ::syscall(SYS_perf_event_open, &attr, -1, cpu, group, 0));
+}
+
+bool read_msr(int fd, unsigned msr, std::uint64_t &value)
+{
+    return ::pread(fd, &value, sizeof(value), msr) == sizeof(value);
+}
+
+// Why perf_event_open failed with `err` on `cpu`
+std::string perf_error(int err, int cpu)
+{
+    std::ostringstream ss;
+    ss << "perf: ";
+    switch (err) {
+        case ENOENT:
+        case EOPNOTSUPP:
+        case ENODEV:
+            ss << "no hardware events (no PMU, or a VM without a virtual "
+               << "PMU)";
+            break;
+        case EACCES:
+        case EPERM:
+            ss << "needs CAP_PERFMON or perf_event_paranoid <= 0";
+            break;
+        default:
+            ss << "cannot open the counters of CPU " << cpu << " ("
+               << std::strerror(err) << ")";
+            break;
+    }
+
+    return ss.str();
+}
+
+// Why /dev/cpu/N/msr could not be opened with `err`
+std::string msr_error(int err, int cpu)
+{
+    std::ostringstream ss;
+    ss << "msr: ";
+    switch (err) {
+        case ENOENT:
+        case ENXIO:
+        case ENODEV:
+            ss << "no /dev/cpu/" << cpu << "/msr (modprobe msr)";
+            break;
+        case EACCES:
+        case EPERM:
+            ss << "/dev/cpu/" << cpu << "/msr needs root";
+            break;
+        default:
+            ss << "cannot open /dev/cpu/" << cpu << "/msr ("
+               << std::strerror(err) << ")";
+            break;
+    }
+
+    return ss.str();
+}
+#endif
+
+} // namespace
+
+const char *counter_source_name(CounterSource source)
+{
+    switch (source) {
+        case CounterSource::Perf:
+            return "perf cycles/ref-cycles";
+        case CounterSource::Msr:
+            return "APERF/MPERF (msr driver)";
+        default:
+            return "None";
+    }
+}
+
+FrequencyMonitor::FrequencyMonitor(const std::vector<int> &cpus, double tsc_hz)
+    : source_(CounterSource::None), tsc_hz_(tsc_hz), head_(0), tail_(0),
+      dropped_(0), stopping_(false)
+{
+    for (std::size_t i = 0; i != cpus.size(); ++i) {
+        CpuCounters counters = {cpus[i], {-1, -1}, 0, 0, 0, 0};
+        counters_.push_back(counters);
+    }
+    if (counters_.empty()) {
+        error_ = "no CPUs to sample";
+        return;
+    }
+    if (tsc_hz_ <= 0) {
+        error_ = "TSC frequency unknown";
+        return;
+    }
+    if (open_perf() || open_msr())
+        error_.clear();
+}
+
+FrequencyMonitor::~FrequencyMonitor()
+{
+    stop();
+    close_all();
+}
+
+bool FrequencyMonitor::open_perf()
+{
+#if defined(__linux__)
+    for (std::size_t i = 0; i != counters_.size(); ++i) {
+        CpuCounters &c = counters_[i];
+        c.fd[0] = open_event(PERF_COUNT_HW_CPU_CYCLES, c.cpu, -1);
+        if (c.fd[0] >= 0)
+            c.fd[1] = open_event(PERF_COUNT_HW_REF_CPU_CYCLES, c.cpu, c.fd[0]);
+        if (c.fd[1] < 0) {
+            error_ = perf_error(errno, c.cpu);
+            close_all();
+            return false;
+        }
+    }
+    source_ = CounterSource::Perf;
+    for (std::size_t i = 0; i != counters_.size(); ++i) {
+        if (!read(counters_[i])) {
+            std::ostringstream ss;
+            ss << "perf: cannot read the counters of CPU " << counters_[i].cpu;
+            error_ = ss.str();
+            close_all();
+            return false;
+        }
+    }
+
+    return true;
+#else
+    error_ = "perf: Linux only";
+
+    return false;
+#endif
+}
+
+bool FrequencyMonitor::open_msr()
+{
+#if defined(__linux__)
+    for (std::size_t i = 0; i != counters_.size(); ++i) {
+        CpuCounters &c = counters_[i];
+        std::ostringstream path;
+        path << "/dev/cpu/" << c.cpu << "/msr";
+        c.fd[0] = ::open(path.str().c_str(), O_RDONLY);
+        if (c.fd[0] < 0) {
+            error_ += "; " + msr_error(errno, c.cpu);
+            close_all();
+            return false;
+        }
+    }
+    source_ = CounterSource::Msr;
+    for (std::size_t i = 0; i != counters_.size(); ++i) {
+        // Readable but zero where the hypervisor does not pass them through
+        if (!read(counters_[i]) || counters_[i].ref_cycles == 0) {
+            std::ostringstream ss;
+            ss << "; msr: APERF/MPERF of CPU " << counters_[i].cpu
+               << (counters_[i].ref_cycles == 0
+                          ? " read as zero (not passed through to the VM)"
+                          : " cannot be read");
+            error_ += ss.str();
+            close_all();
+            return false;
+        }
+    }
+
+    return true;
+#else
+    error_ += "; msr: Linux only";
+
+    return false;
+#endif
+}
+
+void FrequencyMonitor::close_all()
+{
+#if defined(__linux__)
+    for (std::size_t i = 0; i != counters_.size(); ++i) {
+        for (unsigned k = 0; k != 2; ++k) {
+            if (counters_[i].fd[k] >= 0)
+                ::close(counters_[i].fd[k]);
+            counters_[i].fd[k] = -1;
+        }
+    }
+#endif
+    source_ = CounterSource::None;
+}
+
+bool FrequencyMonitor::read(CpuCounters &now) const
+{
+#if defined(__linux__)
+    if (source_ == CounterSource::Perf) {
+        // nr, time enabled, time running, then one value per event
+        std::uint64_t data[5];
+        if (::read(now.fd[0], data, sizeof(data)) != sizeof(data) ||
+            data[0] != 2)
+            return false;
+        now.enabled = data[1];
+        now.running = data[2];
+        now.cycles = data[3];
+        now.ref_cycles = data[4];
+        return true;
+    }
+    if (source_ == CounterSource::Msr)
+        return read_msr(now.fd[0], msr_aperf, now.cycles) &&
+            read_msr(now.fd[0], msr_mperf, now.ref_cycles);
+#else
+    static_cast<void>(now);
+#endif
+
+    return false;
+}
+
+bool FrequencyMonitor::start(double interval_ms, unsigned ring_intervals)
+{
+    if (source_ == CounterSource::None || thread_.joinable() ||
+        interval_ms <= 0 || ring_intervals == 0)
+        return false;
+
+    ring_.assign(counters_.size() * ring_intervals, FrequencySample());
+    head_.store(0);
+    tail_.store(0);
+    stopping_ = false;
+    thread_ = std::thread(&FrequencyMonitor::run, this, interval_ms);
+
+    return true;
+}
+
+void FrequencyMonitor::stop()
+{
+    if (!thread_.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+}
+
+std::size_t FrequencyMonitor::drain(std::vector<FrequencySample> &samples)
+{
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    std::size_t head = head_.load(std::memory_order_acquire);
+    for (std::size_t i = tail; i != head; ++i)
+        samples.push_back(ring_[i % ring_.size()]);
+    tail_.store(head, std::memory_order_release);
+
+    return head - tail;
+}
+
+void FrequencyMonitor::push(const FrequencySample &sample)
+{
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == ring_.size()) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ring_[head % ring_.size()] = sample;
+    head_.store(head + 1, std::memory_order_release);
+}
+
+void FrequencyMonitor::run(double interval_ms)
+{
+    for (std::size_t i = 0; i != counters_.size(); ++i)
+        read(counters_[i]);
+    std::uint64_t last_tsc = rdtsc();
+    bench_clock::time_point start = bench_clock::now();
+    bench_clock::duration interval =
+        std::chrono::duration_cast<bench_clock::duration>(
+            std::chrono::duration<double, std::milli>(interval_ms));
+
+    bench_clock::time_point next = start;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (unsigned n = 0; !stopping_; ++n) {
+        next += interval;
+        while (!stopping_ && bench_clock::now() < next)
+            wake_.wait_until(lock, next);
+        if (stopping_)
+            break;
+
+        std::uint64_t tsc = rdtsc();
+        double ticks = static_cast<double>(tsc - last_tsc);
+        last_tsc = tsc;
+        double seconds = elapsed_ns(start) / 1e9;
+        for (std::size_t i = 0; i != counters_.size(); ++i) {
+            CpuCounters &last = counters_[i];
+            CpuCounters now = last;
+            if (!read(now))
+                continue;
+            double cycles = static_cast<double>(now.cycles - last.cycles);
+            double ref = static_cast<double>(now.ref_cycles - last.ref_cycles);
+            // Scale up if perf multiplexed the counters with other events
+            double enabled = static_cast<double>(now.enabled - last.enabled);
+            double running = static_cast<double>(now.running - last.running);
+            if (running > 0 && running < enabled) {
+                cycles *= enabled / running;
+                ref *= enabled / running;
+            }
+            last = now;
+
+            FrequencySample sample;
+            sample.interval = n;
+            sample.seconds = seconds;
+            sample.cpu = now.cpu;
+            sample.mhz = ref > 0 ? cycles / ref * tsc_hz_ / 1e6 : 0;
+            sample.c0 = ticks > 0 ? ref / ticks : 0;
+            if (sample.c0 > 1)
+                sample.c0 = 1;
+            push(sample);
+        }
+    }
+}
+
+std::vector<TurboStep> turbo_steps(
+    const std::vector<FrequencySample> &samples, double active_c0)
+{
+    std::map<unsigned, TurboStep> steps;
+    std::size_t i = 0;
+    while (i != samples.size()) {
+        unsigned interval = samples[i].interval;
+        unsigned active = 0;
+        double mhz = 0;
+        for (; i != samples.size() && samples[i].interval == interval; ++i) {
+            if (samples[i].c0 >= active_c0 && samples[i].mhz > 0) {
+                ++active;
+                mhz += samples[i].mhz;
+            }
+        }
+        if (active == 0)
+            continue;
+
+        TurboStep &step = steps[active];
+        step.active = active;
+        ++step.intervals;
+        step.mhz += mhz / active;
+    }
+
+    std::vector<TurboStep> result;
+    for (std::map<unsigned, TurboStep>::iterator it = steps.begin();
+         it != steps.end(); ++it) {
+        it->second.mhz /= it->second.intervals;
+        result.push_back(it->second);
+    }
+
+    return result;
+}
+
+bool parse_monitor(
+    const std::string &str, unsigned &interval_ms, unsigned &intervals)
+{
+    char *end = nullptr;
+    unsigned long ms = std::strtoul(str.c_str(), &end, 10);
+    if (end == str.c_str())
+        return false;
+    unsigned long n = 0;
+    if (*end == ',') {
+        const char *begin = end + 1;
+        n = std::strtoul(begin, &end, 10);
+        if (end == begin)
+            return false;
+    }
+    if (*end != '\0' || ms == 0 || ms > 3600000 || n > 1000000)
+        return false;
+    interval_ms = static_cast<unsigned>(ms);
+    intervals = static_cast<unsigned>(n);
+
+    return true;
+}
+
+} // namespace cpuid_info
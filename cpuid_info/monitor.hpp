@@ -0,0 +1,141 @@
+#ifndef CPUID_INFO_MONITOR_HPP
+#define CPUID_INFO_MONITOR_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief Counters the effective frequency is read from
+enum class CounterSource {
+    None,  ///< Neither is readable
+    Perf,  ///< cycles and ref-cycles of perf_event_open
+    Msr    ///< IA32_APERF and IA32_MPERF through /dev/cpu/N/msr
+};
+
+const char *counter_source_name(CounterSource source);
+
+/// \brief One CPU over one sampling interval
+struct FrequencySample {
+    unsigned interval;  ///< Sequence number of the interval, from zero
+    double seconds;     ///< End of the interval since the monitor started
+    int cpu;
+    double mhz;  ///< Average clock while in C0, zero if the CPU stayed idle
+    double c0;   ///< Share of the interval the CPU spent in C0, 0 to 1
+};
+
+/// \brief Samples the effective frequency and C0 residency of a set of
+/// CPUs from a background thread
+///
+/// \details
+/// Both sources count core cycles and reference cycles only while a CPU is
+/// in C0. Reference cycles tick at the TSC rate, so cycles over reference
+/// cycles times the TSC frequency is the average clock the CPU ran at, and
+/// reference cycles over elapsed TSC ticks is its C0 residency. perf needs
+/// CAP_PERFMON or kernel.perf_event_paranoid of 0 or less and a PMU the
+/// hypervisor exposes; AMD cores have no ref-cycles event and use the msr
+/// driver, which needs root and `modprobe msr`.
+///
+/// The sampler thread wakes once per interval and reads every CPU, which
+/// costs each CPU one interprocessor interrupt, and pushes the samples into
+/// a fixed size ring the caller drains without blocking it. Samples that
+/// find the ring full are dropped and counted.
+class FrequencyMonitor
+{
+    public:
+    /// \brief Open the counters of `cpus`, TSC ticks at `tsc_hz`
+    FrequencyMonitor(const std::vector<int> &cpus, double tsc_hz);
+    ~FrequencyMonitor();
+
+    /// \brief None if the counters of some CPU could not be opened
+    CounterSource source() const { return source_; }
+
+    /// \brief Why each source could not be used, e.g. "perf: no hardware
+    /// events (no PMU, or a VM without a virtual PMU); msr: ...", empty
+    /// if a source was opened
+    const std::string &error() const { return error_; }
+
+    /// \brief Start sampling every `interval_ms` milliseconds, keeping up to
+    /// `ring_intervals` intervals that were not drained yet
+    bool start(double interval_ms, unsigned ring_intervals = 64);
+
+    /// \brief Stop the sampler thread, samples in the ring stay drainable
+    void stop();
+
+    /// \brief Append the samples taken since the last call to `samples`
+    ///
+    /// \return the number of samples appended
+    std::size_t drain(std::vector<FrequencySample> &samples);
+
+    /// \brief Samples lost because the ring was full
+    unsigned long dropped() const { return dropped_.load(); }
+
+    private:
+    // Counter values of one CPU at the last sample
+    struct CpuCounters {
+        int cpu;
+        int fd[2];
+        std::uint64_t cycles;
+        std::uint64_t ref_cycles;
+        std::uint64_t enabled;
+        std::uint64_t running;
+    };
+
+    CounterSource source_;
+    std::string error_;
+    double tsc_hz_;
+    std::vector<CpuCounters> counters_;
+
+    std::vector<FrequencySample> ring_;
+    std::atomic<std::size_t> head_;  // Next slot to write, sampler only
+    std::atomic<std::size_t> tail_;  // Next slot to read, drain() only
+    std::atomic<unsigned long> dropped_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_;
+
+    bool open_perf();
+    bool open_msr();
+    void close_all();
+    bool read(CpuCounters &now) const;
+    void push(const FrequencySample &sample);
+    void run(double interval_ms);
+
+    FrequencyMonitor(const FrequencyMonitor &);
+    FrequencyMonitor &operator=(const FrequencyMonitor &);
+}; // class FrequencyMonitor
+
+/// \brief Average clock of the busy CPUs by how many CPUs were busy
+struct TurboStep {
+    unsigned active;     ///< CPUs in C0 for at least the threshold
+    unsigned intervals;  ///< Intervals with exactly `active` busy CPUs
+    double mhz;          ///< Average clock of the busy CPUs
+};
+
+/// \brief Group the intervals of `samples` by the number of CPUs whose C0
+/// residency reached `active_c0`, in ascending order of that number
+///
+/// \details
+/// A falling clock as the count rises is the turbo budget being shared:
+/// the highest ratios of leaf 0x16 and the turbo ratio limits only hold
+/// while few cores are busy, and power or thermal limits cut in later.
+/// SMT siblings count individually but share their core's clock.
+std::vector<TurboStep> turbo_steps(
+    const std::vector<FrequencySample> &samples, double active_c0 = 0.5);
+
+/// \brief Parse "MS" or "MS,N": the interval in milliseconds and the
+/// number of intervals, zero if not given
+bool parse_monitor(
+    const std::string &str, unsigned &interval_ms, unsigned &intervals);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_MONITOR_HPP
@@ -0,0 +1,90 @@
+#include <cpuid_info/feature.hpp>
+#include <cpuid_info/rdt.hpp>
+
+namespace cpuid_info
+{
+
+const RdtCacheAllocation *RdtInfo::cache(unsigned level) const
+{
+    for (std::size_t i = 0; i != caches.size(); ++i)
+        if (caches[i].level == level)
+            return &caches[i];
+
+    return nullptr;
+}
+
+RdtInfo rdt_info(const Snapshot &snapshot)
+{
+    RdtInfo info;
+    info.max_rmid = 0;
+    info.l3_monitoring = false;
+    info.l3_max_rmid = 0;
+    info.l3_scale = 0;
+    info.l3_counter_width = 0;
+    info.l3_overflow_bit = false;
+    info.l3_occupancy = false;
+    info.l3_total_bandwidth = false;
+    info.l3_local_bandwidth = false;
+    info.mba = false;
+    info.mba_max = 0;
+    info.mba_linear = false;
+    info.mba_amd = false;
+    info.mba_cos_count = 0;
+
+    Features features(snapshot);
+    if (snapshot.max_basic() >= 0x0F && features.has(Feature::PQM)) {
+        Register reg(snapshot.get(0x0F));
+        info.max_rmid = reg.ebx;
+        if (test_bit(reg.edx, 1)) {
+            Register l3(snapshot.get(0x0F, 1));
+            info.l3_monitoring = true;
+            info.l3_max_rmid = l3.ecx;
+            info.l3_scale = l3.ebx;
+            info.l3_counter_width = 24 + extract_bits(l3.eax, 7, 0);
+            info.l3_overflow_bit = test_bit(l3.eax, 8);
+            info.l3_occupancy = test_bit(l3.edx, 0);
+            info.l3_total_bandwidth = test_bit(l3.edx, 1);
+            info.l3_local_bandwidth = test_bit(l3.edx, 2);
+        }
+    }
+
+    if (snapshot.max_basic() >= 0x10 && features.has(Feature::PQE)) {
+        unsigned resources = snapshot.get(0x10).ebx;
+        for (unsigned level = 3; level >= 2; --level) {
+            // Subleaf 1 is L3, subleaf 2 is L2
+            unsigned ecx = 4 - level;
+            if (!test_bit(resources, ecx))
+                continue;
+            Register reg(snapshot.get(0x10, ecx));
+            RdtCacheAllocation cache;
+            cache.level = level;
+            cache.cbm_length = extract_bits(reg.eax, 4, 0) + 1;
+            cache.shareable_mask = reg.ebx;
+            cache.cos_count = extract_bits(reg.edx, 15, 0) + 1;
+            cache.cdp = test_bit(reg.ecx, 2);
+            cache.non_contiguous = test_bit(reg.ecx, 3);
+            info.caches.push_back(cache);
+        }
+        if (test_bit(resources, 3)) {
+            Register reg(snapshot.get(0x10, 3));
+            info.mba = true;
+            info.mba_max = extract_bits(reg.eax, 11, 0) + 1;
+            info.mba_linear = test_bit(reg.ecx, 2);
+            info.mba_cos_count = extract_bits(reg.edx, 15, 0) + 1;
+        }
+    }
+
+    // AMD reports bandwidth limits, not throttling, in its own leaf
+    if (!info.mba && snapshot.max_extended() >= 0x80000020 &&
+        test_bit(snapshot.get(0x80000020).ebx, 1)) {
+        Register reg(snapshot.get(0x80000020, 1));
+        info.mba = true;
+        info.mba_max = 1U << extract_bits(reg.eax, 4, 0);
+        info.mba_amd = true;
+        info.mba_cos_count = reg.edx + 1;
+    }
+
+    return info;
+}
+
+} // namespace cpuid_info
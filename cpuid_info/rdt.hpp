@@ -0,0 +1,58 @@
+#ifndef CPUID_INFO_RDT_HPP
+#define CPUID_INFO_RDT_HPP
+
+#include <cpuid_info/snapshot.hpp>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief Cache allocation of one level, leaf 0x10 subleaf 1 (L3) or 2 (L2)
+struct RdtCacheAllocation {
+    unsigned level;
+    unsigned cbm_length;      ///< Bits of the capacity bitmask, one per way
+    unsigned shareable_mask;  ///< Ways other agents, e.g. I/O, may fill too
+    unsigned cos_count;       ///< Classes of service
+    bool cdp;                 ///< Separate code and data masks
+    bool non_contiguous;      ///< Masks need not be one run of set bits
+};
+
+/// \brief Resource Director Technology of leaves 0x0F and 0x10 (and
+/// 0x80000020 for AMD memory bandwidth)
+struct RdtInfo {
+    /// \brief Highest RMID of any resource, zero without monitoring
+    unsigned max_rmid;
+
+    /// \brief L3 monitoring, leaf 0x0F subleaf 1
+    bool l3_monitoring;
+    unsigned l3_max_rmid;
+    unsigned l3_scale;          ///< Bytes per unit of the counters
+    unsigned l3_counter_width;  ///< Bits of the bandwidth counters
+    bool l3_overflow_bit;       ///< Counters report overflow in bit 61
+    bool l3_occupancy;
+    bool l3_total_bandwidth;
+    bool l3_local_bandwidth;
+
+    std::vector<RdtCacheAllocation> caches;
+
+    /// \brief Memory bandwidth allocation
+    bool mba;
+    unsigned mba_max;       ///< Highest throttle value (Intel) or bandwidth
+    bool mba_linear;        ///< Intel throttle values are percentages
+    bool mba_amd;           ///< Values are bandwidth in 1/8 GB/s
+    unsigned mba_cos_count;
+
+    bool monitoring() const { return max_rmid != 0; }
+    bool allocation() const { return !caches.empty() || mba; }
+    bool empty() const { return !monitoring() && !allocation(); }
+
+    /// \brief Cache allocation of a level, nullptr if not supported
+    const RdtCacheAllocation *cache(unsigned level) const;
+};
+
+/// \brief Decode monitoring (PQM) and allocation (PQE) capabilities
+RdtInfo rdt_info(const Snapshot &snapshot);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_RDT_HPP
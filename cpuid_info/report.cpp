@@ -0,0 +1,396 @@
+#include <cpuid_info/report.hpp>
+#include <cpuid_info/amx.hpp>
+#include <cpuid_info/hypervisor.hpp>
+#include <cpuid_info/rdt.hpp>
+#include <cpuid_info/tsc.hpp>
+#include <cpuid_info/uarch.hpp>
+#include <cpuid_info/xsave.hpp>
+#include <cstddef>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+void write_features(const Features &features, unsigned eax, Writer &writer)
+{
+    writer.begin_object();
+    writer.field("leaf", eax);
+    writer.key("flags");
+    writer.begin_array();
+    for (unsigned i = 0; i != feature_count; ++i) {
+        Feature f = static_cast<Feature>(i);
+        if (feature_info(f).eax == eax && features.has(f))
+            writer.value(feature_name(f));
+    }
+    writer.end_array();
+    writer.end_object();
+}
+
+void write_cache(const CacheParam &cache, Writer &writer)
+{
+    writer.begin_object();
+    writer.field("level", cache.level());
+    writer.field("type", cache.type());
+    writer.field("size", cache.size());
+    writer.field("max_proc_sharing", cache.max_proc_sharing());
+    writer.field("max_proc_physical", cache.max_proc_physical());
+    writer.field("line_size", cache.line_size());
+    writer.field("partitions", cache.partitions());
+    writer.field("ways", cache.ways());
+    writer.field("sets", cache.sets());
+    writer.field("self_initializing", cache.self_initializing());
+    writer.field("fully_associative", cache.fully_associative());
+    writer.field("wbinvd", cache.wbinvd());
+    writer.field("inclusive", cache.inclusiveness());
+    writer.field("complex_indexing", cache.complex_indexing());
+    writer.end_object();
+}
+
+void write_tlb(const TlbParam &tlb, Writer &writer)
+{
+    writer.begin_object();
+    writer.field("level", tlb.level);
+    writer.field("type", tlb.type);
+    writer.key("pages");
+    writer.begin_array();
+    static const char *names[] = {"4K", "2M", "4M", "1G"};
+    for (unsigned i = 0; i != 4; ++i)
+        if (tlb.pages & (1U << i))
+            writer.value(names[i]);
+    writer.end_array();
+    writer.field("entries", tlb.entries);
+    writer.field("ways", tlb.ways);
+    writer.field("fully_associative", tlb.fully_associative);
+    writer.field("max_proc_sharing", tlb.max_proc_sharing);
+    writer.end_object();
+}
+
+} // namespace
+
+void write_report(const CpuInfo &info, Writer &writer, std::uint64_t xcr0)
+{
+    const Snapshot &snapshot = info.snapshot();
+    unsigned max_basic = snapshot.max_basic();
+    unsigned max_extended = snapshot.max_extended();
+
+    writer.begin_object();
+    writer.field("vendor", info.vendor());
+    writer.field("brand", info.brand());
+    writer.field("max_basic", max_basic);
+    writer.field("max_extended", max_extended);
+    if (max_basic >= 0x01) {
+        Signature sig(info.signature());
+        const Microarch *uarch = identify_microarch(info);
+        Quirks quirks(microarch_quirks(info));
+        writer.field("signature", snapshot.get(0x01).eax);
+        writer.field("family", sig.family);
+        writer.field("model", sig.model);
+        writer.field("stepping", sig.stepping);
+        writer.key("microarch");
+        writer.begin_object();
+        if (uarch != nullptr) {
+            writer.field("name", uarch->name);
+            writer.field("march", uarch->march);
+        }
+        writer.field("slow_pdep_pext", quirks.slow_pdep_pext);
+        writer.field("avx512_fma_ports", quirks.avx512_fma_ports);
+        writer.field("rep_movsb", rep_movsb_name(quirks.rep_movsb));
+        writer.field("split_lock_detect", quirks.split_lock_detect);
+        writer.end_object();
+    }
+
+    writer.key("features");
+    writer.begin_array();
+    if (max_basic >= 0x01)
+        write_features(info.features(), 0x01, writer);
+    if (max_basic >= 0x07)
+        write_features(info.features(), 0x07, writer);
+    if (max_extended >= 0x80000001)
+        write_features(info.features(), 0x80000001, writer);
+    if (max_extended >= 0x80000008)
+        write_features(info.features(), 0x80000008, writer);
+    if (max_extended >= 0x80000021)
+        write_features(info.features(), 0x80000021, writer);
+    writer.end_array();
+
+    if (xcr0 != 0) {
+        Features usable(usable_features(info.features(), xcr0));
+        writer.field("xcr0", xcr0);
+        writer.key("usable_features");
+        writer.begin_array();
+        if (max_basic >= 0x01)
+            write_features(usable, 0x01, writer);
+        if (max_basic >= 0x07)
+            write_features(usable, 0x07, writer);
+        if (max_extended >= 0x80000001)
+            write_features(usable, 0x80000001, writer);
+        if (max_extended >= 0x80000008)
+            write_features(usable, 0x80000008, writer);
+        if (max_extended >= 0x80000021)
+            write_features(usable, 0x80000021, writer);
+        writer.end_array();
+    }
+
+    XsaveInfo xsave(xsave_info(snapshot));
+    if (!xsave.empty()) {
+        writer.key("xsave");
+        writer.begin_object();
+        writer.field("user_mask", xsave.user_mask);
+        writer.field("supervisor_mask", xsave.supervisor_mask);
+        writer.field("enabled_size", xsave.enabled_size);
+        writer.field("max_size", xsave.max_size);
+        writer.field("compacted_size", xsave.compacted_size);
+        writer.field("xsaveopt", xsave.xsaveopt);
+        writer.field("xsavec", xsave.xsavec);
+        writer.field("xgetbv1", xsave.xgetbv1);
+        writer.field("xsaves", xsave.xsaves);
+        writer.field("xfd", xsave.xfd);
+        writer.key("components");
+        writer.begin_array();
+        for (std::size_t i = 0; i != xsave.components.size(); ++i) {
+            const XsaveComponent &comp = xsave.components[i];
+            writer.begin_object();
+            writer.field("index", comp.index);
+            writer.field("name", xsave_component_name(comp.index));
+            writer.field("size", comp.size);
+            writer.field("offset", comp.offset);
+            writer.field("supervisor", comp.supervisor);
+            writer.field("aligned", comp.aligned);
+            writer.field("xfd", comp.xfd);
+            writer.end_object();
+        }
+        writer.end_array();
+        writer.end_object();
+    }
+
+    HypervisorInfo hv(hypervisor_info(snapshot));
+    if (!hv.empty()) {
+        writer.key("hypervisor");
+        writer.begin_object();
+        writer.field("vendor", hypervisor_name(hv.vendor));
+        writer.field("signature", hv.signature);
+        writer.field("base", hv.base);
+        writer.field("max_leaf", hv.max_leaf);
+        writer.field("hyperv_interface", hv.hyperv_interface);
+        writer.field("stable_clock", hv.stable_clock);
+        writer.field("tsc_emulated", hv.tsc_emulated);
+        writer.field("dedicated_cpus", hv.dedicated_cpus);
+        writer.field("tsc_hz", hv.tsc_hz);
+        writer.field("apic_hz", hv.apic_hz);
+        writer.key("features");
+        writer.begin_array();
+        for (std::size_t i = 0; i != hv.features.size(); ++i)
+            writer.value(hv.features[i]);
+        writer.end_array();
+        writer.end_object();
+    }
+
+    RdtInfo rdt(rdt_info(snapshot));
+    if (!rdt.empty()) {
+        writer.key("rdt");
+        writer.begin_object();
+        writer.field("max_rmid", rdt.max_rmid);
+        if (rdt.l3_monitoring) {
+            writer.key("l3_monitoring");
+            writer.begin_object();
+            writer.field("max_rmid", rdt.l3_max_rmid);
+            writer.field("scale", rdt.l3_scale);
+            writer.field("counter_width", rdt.l3_counter_width);
+            writer.field("overflow_bit", rdt.l3_overflow_bit);
+            writer.field("occupancy", rdt.l3_occupancy);
+            writer.field("total_bandwidth", rdt.l3_total_bandwidth);
+            writer.field("local_bandwidth", rdt.l3_local_bandwidth);
+            writer.end_object();
+        }
+        writer.key("cache_allocation");
+        writer.begin_array();
+        for (std::size_t i = 0; i != rdt.caches.size(); ++i) {
+            const RdtCacheAllocation &cache = rdt.caches[i];
+            writer.begin_object();
+            writer.field("level", cache.level);
+            writer.field("cbm_length", cache.cbm_length);
+            writer.field("shareable_mask", cache.shareable_mask);
+            writer.field("cos_count", cache.cos_count);
+            writer.field("cdp", cache.cdp);
+            writer.field("non_contiguous", cache.non_contiguous);
+            writer.end_object();
+        }
+        writer.end_array();
+        if (rdt.mba) {
+            writer.key("bandwidth_allocation");
+            writer.begin_object();
+            writer.field("max", rdt.mba_max);
+            writer.field("linear", rdt.mba_linear);
+            writer.field("amd", rdt.mba_amd);
+            writer.field("cos_count", rdt.mba_cos_count);
+            writer.end_object();
+        }
+        writer.end_object();
+    }
+
+    if (max_basic >= 0x06) {
+        Register reg(snapshot.get(0x06));
+        writer.key("power_management");
+        writer.begin_array();
+        for (unsigned i = 0; i != power_feature_count; ++i) {
+            const PowerFeatureInfo &p = power_feature_table[i];
+            if (test_bit(register_value(reg, p.reg), p.bit))
+                writer.value(p.name);
+        }
+        writer.end_array();
+        writer.field("thermal_thresholds", reg.ebx & 7);
+    }
+
+    if (max_basic >= 0x02) {
+        std::vector<unsigned> descriptors(
+            leaf2_descriptors(snapshot.get(0x02)));
+        writer.key("leaf2_descriptors");
+        writer.begin_array();
+        for (std::size_t i = 0; i != descriptors.size(); ++i)
+            writer.value(descriptors[i]);
+        writer.end_array();
+    }
+
+    const std::vector<CacheParam> &caches = info.caches();
+    writer.field("cache_leaf", info.cache_leaf());
+    writer.key("caches");
+    writer.begin_array();
+    for (std::size_t i = 0; i != caches.size(); ++i)
+        write_cache(caches[i], writer);
+    writer.end_array();
+
+    const std::vector<TlbParam> &tlbs = info.tlbs();
+    writer.field("tlb_leaf", info.tlb_leaf());
+    writer.key("tlbs");
+    writer.begin_array();
+    for (std::size_t i = 0; i != tlbs.size(); ++i)
+        write_tlb(tlbs[i], writer);
+    writer.end_array();
+
+    AmxInfo amx(amx_info(snapshot));
+    if (!amx.empty()) {
+        writer.key("amx");
+        writer.begin_object();
+        writer.key("palettes");
+        writer.begin_array();
+        for (std::size_t i = 0; i != amx.palettes.size(); ++i) {
+            const AmxPalette &palette = amx.palettes[i];
+            writer.begin_object();
+            writer.field("id", palette.id);
+            writer.field("total_tile_bytes", palette.total_tile_bytes);
+            writer.field("bytes_per_tile", palette.bytes_per_tile);
+            writer.field("bytes_per_row", palette.bytes_per_row);
+            writer.field("max_names", palette.max_names);
+            writer.field("max_rows", palette.max_rows);
+            writer.end_object();
+        }
+        writer.end_array();
+        writer.field("tmul_max_k", amx.tmul_max_k);
+        writer.field("tmul_max_n", amx.tmul_max_n);
+        writer.end_object();
+    }
+
+    if (max_basic >= 0x15 || max_extended >= 0x80000007) {
+        TscInfo tsc(tsc_info(info));
+        writer.key("tsc");
+        writer.begin_object();
+        writer.field("invariant", tsc.invariant);
+        writer.field("rdtscp", tsc.rdtscp);
+        writer.field("ratio_numerator", tsc.ratio_numerator);
+        writer.field("ratio_denominator", tsc.ratio_denominator);
+        writer.field("crystal_hz", tsc.crystal_hz);
+        writer.field("hz", tsc.hz);
+        writer.field("source", tsc_source_name(tsc.source));
+        writer.end_object();
+    }
+
+    if (max_basic >= 0x16) {
+        const Frequency &freq = info.frequency();
+        writer.key("frequency_mhz");
+        writer.begin_object();
+        writer.field("base", freq.base);
+        writer.field("max", freq.max);
+        writer.field("bus", freq.bus);
+        writer.end_object();
+    }
+
+    if (max_extended >= 0x80000008) {
+        Register reg(snapshot.get(0x80000008));
+        writer.key("address_bits");
+        writer.begin_object();
+        writer.field("physical", extract_bits(reg.eax, 7, 0));
+        writer.field("linear", extract_bits(reg.eax, 15, 8));
+        writer.end_object();
+    }
+
+    const CoreCount &count = info.core_count();
+    writer.key("core_count");
+    writer.begin_object();
+    writer.field("threads_per_core", count.threads_per_core);
+    writer.field("cores_per_package", count.cores_per_package);
+    writer.field("threads_per_package", count.threads_per_package);
+    writer.end_object();
+
+    if (max_extended >= 0x8000001E && info.features().has(Feature::TOPOEXT)) {
+        Register reg(snapshot.get(0x8000001E));
+        writer.key("amd_topology");
+        writer.begin_object();
+        writer.field("extended_apic_id", reg.eax);
+        writer.field("core_id", extract_bits(reg.ebx, 7, 0));
+        writer.field("threads_per_core", extract_bits(reg.ebx, 15, 8) + 1);
+        writer.field("node_id", extract_bits(reg.ecx, 7, 0));
+        writer.field("nodes_per_processor", extract_bits(reg.ecx, 10, 8) + 1);
+        writer.end_object();
+    }
+
+    // Raw leaves as [eax, ecx, EAX, EBX, ECX, EDX]
+    const std::vector<Leaf> &leaves = snapshot.leaves();
+    writer.key("leaves");
+    writer.begin_array();
+    for (std::size_t i = 0; i != leaves.size(); ++i) {
+        writer.begin_array();
+        writer.value(leaves[i].eax);
+        writer.value(leaves[i].ecx);
+        writer.value(leaves[i].reg.eax);
+        writer.value(leaves[i].reg.ebx);
+        writer.value(leaves[i].reg.ecx);
+        writer.value(leaves[i].reg.edx);
+        writer.end_array();
+    }
+    writer.end_array();
+
+    writer.end_object();
+}
+
+void write_fleet(const FleetSummary &fleet, Writer &writer)
+{
+    writer.begin_object();
+    writer.field("files", fleet.files);
+    writer.field("hosts", fleet.hosts);
+    writer.field("failed", fleet.failed);
+
+    writer.key("common_features");
+    writer.begin_array();
+    for (unsigned i = 0; i != feature_count; ++i) {
+        Feature f = static_cast<Feature>(i);
+        if (fleet.common.has(f))
+            writer.value(feature_name(f));
+    }
+    writer.end_array();
+
+    writer.key("groups");
+    writer.begin_array();
+    for (std::size_t i = 0; i != fleet.groups.size(); ++i) {
+        writer.begin_object();
+        writer.field("hosts", fleet.groups[i].hosts);
+        writer.key("cpu");
+        write_report(CpuInfo(fleet.groups[i].snapshot), writer);
+        writer.end_object();
+    }
+    writer.end_array();
+    writer.end_object();
+}
+
+} // namespace cpuid_info
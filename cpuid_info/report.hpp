@@ -0,0 +1,31 @@
+#ifndef CPUID_INFO_REPORT_HPP
+#define CPUID_INFO_REPORT_HPP
+
+#include <cpuid_info/cpu_info.hpp>
+#include <cpuid_info/fleet.hpp>
+#include <cpuid_info/writer.hpp>
+#include <cstdint>
+
+namespace cpuid_info
+{
+
+/// \brief Write the decoded model of a CPU as one object
+///
+/// \details
+/// The object holds the same decoded data as the text report (vendor,
+/// brand, feature lists, power management, cache, TLB, frequency and core
+/// count tables) followed by every raw leaf of the snapshot, so consumers
+/// can decode what the report does not cover. Leaves the CPU does not
+/// support are omitted, as in the text report. A non-zero `xcr0`, for a
+/// report of the local CPU, is written along with the features it makes
+/// usable; dumps do not record it.
+void write_report(
+    const CpuInfo &info, Writer &writer, std::uint64_t xcr0 = 0);
+
+/// \brief Write the host counts, the common features and the full report of
+/// every distinct CPU type of a fleet
+void write_fleet(const FleetSummary &fleet, Writer &writer);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_REPORT_HPP
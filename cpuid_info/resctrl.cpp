@@ -0,0 +1,337 @@
+#include <cpuid_info/cache_domain.hpp>
+#include <cpuid_info/resctrl.hpp>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#if defined(__linux__)
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+ResctrlResource cache_resource(
+    const std::string &name, const RdtCacheAllocation &cache)
+{
+    ResctrlResource resource;
+    resource.name = name;
+    resource.cbm_length = cache.cbm_length;
+    resource.shareable_mask = cache.shareable_mask;
+    resource.min_cbm_bits = 1;
+    resource.max_bandwidth = 0;
+    resource.min_bandwidth = 0;
+    resource.bandwidth_gran = 0;
+
+    return resource;
+}
+
+// Linux takes the minimum and granularity of Intel throttling from the
+// highest throttle value; AMD limits go down to a single unit
+ResctrlResource bandwidth_resource(const RdtInfo &rdt)
+{
+    ResctrlResource resource;
+    resource.name = "MB";
+    resource.cbm_length = 0;
+    resource.shareable_mask = 0;
+    resource.min_cbm_bits = 0;
+    if (rdt.mba_amd) {
+        resource.max_bandwidth = rdt.mba_max;
+        resource.min_bandwidth = 1;
+        resource.bandwidth_gran = 1;
+    } else {
+        resource.max_bandwidth = 100;
+        resource.min_bandwidth = rdt.mba_max < 100 ? 100 - rdt.mba_max : 10;
+        resource.bandwidth_gran = resource.min_bandwidth;
+    }
+
+    return resource;
+}
+
+bool read_line(const std::string &path, std::string &line)
+{
+    std::ifstream in(path.c_str());
+    return static_cast<bool>(std::getline(in, line));
+}
+
+// A hexadecimal (cbm_mask, shareable_bits) or decimal file of info/
+bool read_number(const std::string &path, int base, unsigned &value)
+{
+    std::string line;
+    if (!read_line(path, line) || line.empty())
+        return false;
+    char *end = nullptr;
+    unsigned long number = std::strtoul(line.c_str(), &end, base);
+    if (end == line.c_str())
+        return false;
+    value = static_cast<unsigned>(number);
+
+    return true;
+}
+
+unsigned popcount(unsigned mask)
+{
+    unsigned n = 0;
+    for (; mask != 0; mask &= mask - 1)
+        ++n;
+
+    return n;
+}
+
+unsigned low_bits(unsigned n)
+{
+    return static_cast<unsigned>((std::uint64_t(1) << n) - 1);
+}
+
+// "    L3:0=7ff;1=7ff" gives "L3" and the IDs 0 and 1
+bool parse_schemata_line(const std::string &line, ResctrlResource &resource)
+{
+    std::size_t begin = line.find_first_not_of(' ');
+    std::size_t colon = line.find(':');
+    if (begin == std::string::npos || colon == std::string::npos ||
+        colon <= begin)
+        return false;
+    resource.name = line.substr(begin, colon - begin);
+
+    std::stringstream ss(line.substr(colon + 1));
+    std::string entry;
+    while (std::getline(ss, entry, ';')) {
+        char *end = nullptr;
+        unsigned long id = std::strtoul(entry.c_str(), &end, 10);
+        if (end == entry.c_str() || *end != '=')
+            return false;
+        resource.domains.push_back(static_cast<unsigned>(id));
+    }
+
+    return !resource.domains.empty();
+}
+
+void append_line(std::string &schemata, const ResctrlResource &resource,
+    unsigned value, bool hex)
+{
+    std::stringstream text;
+    if (hex)
+        text << std::hex;
+    text << value;
+
+    std::stringstream ss;
+    ss << resource.name << ':';
+    for (std::size_t i = 0; i != resource.domains.size(); ++i)
+        ss << (i == 0 ? "" : ";") << resource.domains[i] << '=' << text.str();
+    ss << '\n';
+    schemata += ss.str();
+}
+
+#if defined(__linux__)
+bool write_file(const std::string &path, const std::string &text)
+{
+    std::ofstream out(path.c_str());
+    out << text;
+    out.close();
+
+    return !out.fail();
+}
+#endif
+
+} // namespace
+
+const ResctrlResource *ResctrlLayout::find(const std::string &name) const
+{
+    for (std::size_t i = 0; i != resources.size(); ++i)
+        if (resources[i].name == name)
+            return &resources[i];
+
+    return nullptr;
+}
+
+ResctrlLayout resctrl_layout(const RdtInfo &rdt, const Topology &topo)
+{
+    ResctrlLayout layout;
+    layout.mounted = false;
+
+    unsigned l3_domains = 1;
+    for (std::size_t i = 0; i != rdt.caches.size(); ++i) {
+        const RdtCacheAllocation &cache = rdt.caches[i];
+        std::size_t n = cache_domains(topo, cache.level).size();
+        if (n == 0)
+            n = 1;
+        if (cache.level == 3)
+            l3_domains = static_cast<unsigned>(n);
+
+        std::stringstream name;
+        name << 'L' << cache.level;
+        ResctrlResource resource(cache_resource(name.str(), cache));
+        for (unsigned id = 0; id != n; ++id)
+            resource.domains.push_back(id);
+        layout.resources.push_back(resource);
+    }
+
+    if (rdt.mba) {
+        ResctrlResource resource(bandwidth_resource(rdt));
+        for (unsigned id = 0; id != l3_domains; ++id)
+            resource.domains.push_back(id);
+        layout.resources.push_back(resource);
+    }
+
+    return layout;
+}
+
+bool read_resctrl_layout(
+    const std::string &root, const RdtInfo &rdt, ResctrlLayout &layout)
+{
+    std::ifstream in((root + "/schemata").c_str());
+    if (!in)
+        return false;
+
+    layout.resources.clear();
+    layout.mounted = true;
+    std::string line;
+    while (std::getline(in, line)) {
+        ResctrlResource parsed;
+        if (!parse_schemata_line(line, parsed))
+            continue;
+
+        // L3CODE and L3DATA are the halves of L3 with CDP
+        const std::string &name = parsed.name;
+        unsigned level = name.size() >= 2 && name[0] == 'L' ? name[1] - '0'
+                                                            : 0;
+        const RdtCacheAllocation *cache = rdt.cache(level);
+        ResctrlResource resource;
+        if (name == "MB") {
+            resource = bandwidth_resource(rdt);
+        } else if (cache != nullptr) {
+            resource = cache_resource(name, *cache);
+        } else {
+            RdtCacheAllocation unknown = {level, 0, 0, 0, false, false};
+            resource = cache_resource(name, unknown);
+        }
+        resource.domains = parsed.domains;
+
+        std::string info(root + "/info/" + name + "/");
+        unsigned mask = 0;
+        if (read_number(info + "cbm_mask", 16, mask))
+            resource.cbm_length = popcount(mask);
+        read_number(info + "shareable_bits", 16, resource.shareable_mask);
+        read_number(info + "min_cbm_bits", 10, resource.min_cbm_bits);
+        read_number(info + "min_bandwidth", 10, resource.min_bandwidth);
+        read_number(info + "bandwidth_gran", 10, resource.bandwidth_gran);
+        layout.resources.push_back(resource);
+    }
+
+    return true;
+}
+
+bool plan_resctrl(const ResctrlLayout &layout, unsigned ways,
+    unsigned mba_percent, ResctrlPlan &plan)
+{
+    plan.critical_mask = 0;
+    plan.batch_mask = 0;
+    plan.critical_bandwidth = 0;
+    plan.batch_bandwidth = 0;
+    plan.critical.clear();
+    plan.batch.clear();
+
+    // Check every L3 resource (two with CDP) first and pick one end of the
+    // mask for all of them
+    std::vector<const ResctrlResource *> l3;
+    bool low_end = false;
+    for (std::size_t i = 0; ways != 0 && i != layout.resources.size(); ++i) {
+        const ResctrlResource &resource = layout.resources[i];
+        if (!resource.cache() || resource.name.compare(0, 2, "L3") != 0)
+            continue;
+        unsigned length = resource.cbm_length;
+        unsigned min_bits = resource.min_cbm_bits != 0
+            ? resource.min_cbm_bits : 1;
+        if (ways < min_bits || ways > length || length - ways < min_bits)
+            return false;
+
+        unsigned low = low_bits(ways);
+        unsigned high = low << (length - ways);
+        unsigned shared = resource.shareable_mask;
+        if ((high & shared) != 0 && (low & shared) == 0)
+            low_end = true;
+        l3.push_back(&resource);
+    }
+    if (ways != 0 && l3.empty())
+        return false;
+
+    for (std::size_t i = 0; i != l3.size(); ++i) {
+        unsigned length = l3[i]->cbm_length;
+        unsigned full = low_bits(length);
+        unsigned critical = low_bits(ways) << (low_end ? 0 : length - ways);
+        if (i == 0) {
+            plan.critical_mask = critical;
+            plan.batch_mask = full & ~critical;
+        }
+        append_line(plan.critical, *l3[i], critical, true);
+        append_line(plan.batch, *l3[i], full & ~critical, true);
+    }
+
+    if (mba_percent != 0) {
+        const ResctrlResource *resource = layout.find("MB");
+        if (resource == nullptr || mba_percent >= 100)
+            return false;
+
+        unsigned max = resource->max_bandwidth;
+        unsigned gran = resource->bandwidth_gran != 0
+            ? resource->bandwidth_gran : 1;
+        unsigned batch = static_cast<unsigned>(
+            static_cast<std::uint64_t>(max) * (100 - mba_percent) / 100);
+        batch -= batch % gran;
+        if (batch < resource->min_bandwidth)
+            batch = resource->min_bandwidth;
+        if (batch < gran)
+            batch = gran;
+        plan.critical_bandwidth = max;
+        plan.batch_bandwidth = batch;
+        append_line(plan.critical, *resource, max, false);
+        append_line(plan.batch, *resource, batch, false);
+    }
+
+    return true;
+}
+
+bool parse_reservation(
+    const std::string &str, unsigned &ways, unsigned &mba_percent)
+{
+    char *end = nullptr;
+    unsigned long w = std::strtoul(str.c_str(), &end, 10);
+    if (end == str.c_str())
+        return false;
+    unsigned long p = 0;
+    if (*end == ',') {
+        const char *begin = end + 1;
+        p = std::strtoul(begin, &end, 10);
+        if (end == begin)
+            return false;
+    }
+    if (*end != '\0' || w > 32 || p >= 100 || (w == 0 && p == 0))
+        return false;
+    ways = static_cast<unsigned>(w);
+    mba_percent = static_cast<unsigned>(p);
+
+    return true;
+}
+
+bool apply_resctrl(
+    const std::string &root, const std::string &group, const ResctrlPlan &plan)
+{
+#if defined(__linux__)
+    std::string dir(root + "/" + group);
+    if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST)
+        return false;
+
+    return write_file(dir + "/schemata", plan.critical) &&
+        write_file(root + "/schemata", plan.batch);
+#else
+    return false;
+#endif
+}
+
+} // namespace cpuid_info
@@ -0,0 +1,92 @@
+#ifndef CPUID_INFO_RESCTRL_HPP
+#define CPUID_INFO_RESCTRL_HPP
+
+#include <cpuid_info/rdt.hpp>
+#include <cpuid_info/topology.hpp>
+#include <string>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief One resource of a resctrl schemata file, e.g. "L3" or "MB"
+struct ResctrlResource {
+    std::string name;
+    std::vector<unsigned> domains;  ///< Cache IDs the resource is set per
+    unsigned cbm_length;            ///< Zero for memory bandwidth
+    unsigned shareable_mask;
+    unsigned min_cbm_bits;
+    unsigned max_bandwidth;  ///< 100 (percent), or the AMD limit
+    unsigned min_bandwidth;
+    unsigned bandwidth_gran;
+
+    bool cache() const { return cbm_length != 0; }
+};
+
+/// \brief The resources of a resctrl mount, or those CPUID predicts
+struct ResctrlLayout {
+    std::vector<ResctrlResource> resources;
+    bool mounted;  ///< Read from a resctrl file system
+
+    /// \brief The resource of a schemata name, nullptr if not present
+    const ResctrlResource *find(const std::string &name) const;
+};
+
+/// \brief The layout Linux presents with CDP off, one domain per instance
+/// of the cache in `topo` numbered from zero
+///
+/// \details
+/// Memory bandwidth is set per L3 domain. Used when resctrl is not mounted;
+/// the kernel's cache IDs usually but not always count from zero.
+ResctrlLayout resctrl_layout(const RdtInfo &rdt, const Topology &topo);
+
+/// \brief Read the resources and cache IDs from the default group's
+/// schemata and the limits from the info directory under `root`
+///
+/// \details
+/// Limits the info directory does not provide are taken from `rdt`. False
+/// if `root`/schemata cannot be read, e.g. resctrl is not mounted.
+bool read_resctrl_layout(
+    const std::string &root, const RdtInfo &rdt, ResctrlLayout &layout);
+
+/// \brief Schemata isolating a latency-critical group from the default
+/// group, which holds every task not assigned elsewhere
+struct ResctrlPlan {
+    unsigned critical_mask;       ///< L3 ways of the critical group
+    unsigned batch_mask;          ///< L3 ways left to the default group
+    unsigned critical_bandwidth;  ///< Unthrottled
+    unsigned batch_bandwidth;
+    std::string critical;  ///< Schemata of the critical group
+    std::string batch;     ///< Schemata of the default group
+};
+
+/// \brief Give the critical group `ways` L3 ways of its own and limit the
+/// default group to `mba_percent` less than the full memory bandwidth
+///
+/// \details
+/// The critical ways are taken from the high end of the mask unless those
+/// are shareable with I/O and the low end is not, so both masks stay
+/// contiguous. Bandwidth is rounded down to the granularity. With CDP code
+/// and data get the same masks. Zero `ways` or `mba_percent` leaves that
+/// resource alone. False if the layout lacks a requested resource or
+/// either group would get fewer ways than the minimum.
+bool plan_resctrl(const ResctrlLayout &layout, unsigned ways,
+    unsigned mba_percent, ResctrlPlan &plan);
+
+/// \brief Parse "W" or "W,P": `ways` L3 ways and `mba_percent` of the
+/// memory bandwidth, zero if not given
+bool parse_reservation(
+    const std::string &str, unsigned &ways, unsigned &mba_percent);
+
+/// \brief Create `group` under `root` and write both schemata
+///
+/// \details
+/// Tasks are assigned afterwards by writing their PIDs to
+/// `root`/`group`/tasks. The kernel reports rejected schemata in
+/// `root`/info/last_cmd_status. False on the first write that fails.
+bool apply_resctrl(
+    const std::string &root, const std::string &group, const ResctrlPlan &plan);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_RESCTRL_HPP
@@ -0,0 +1,246 @@
+#include <cpuid_info/snapshot.hpp>
+#include <algorithm>
+#include <cstddef>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+// Some hypervisors report nonsensical maximum leaves, do not walk further
+// than this many leaves past the base of each range
+const unsigned max_range = 0x100;
+
+// Upper bound on the number of subleaves captured for any leaf
+const unsigned max_subleaf = 64;
+
+// Hypervisors answer from 0x40000000; Hyper-V compatible ones may offer
+// their own interface one range higher
+const unsigned hypervisor_base = 0x40000000;
+const unsigned hypervisor_alt_base = 0x40000100;
+
+// "XenVMMXenVMM" in EBX, ECX, EDX
+inline bool xen_signature(const Register &reg)
+{
+    return reg.ebx == 0x566E6558 && reg.ecx == 0x65584D4D &&
+        reg.edx == 0x4D4D566E;
+}
+
+inline bool leaf_less(const Leaf &a, const Leaf &b)
+{
+    return a.eax < b.eax || (a.eax == b.eax && a.ecx < b.ecx);
+}
+
+inline bool in_range(unsigned eax, unsigned base, unsigned max)
+{
+    return eax >= base && eax <= max && eax - base < max_range;
+}
+
+} // namespace
+
+Snapshot Snapshot::capture() { return capture(HardwareSource()); }
+
+Snapshot Snapshot::capture(const RegisterSource &source)
+{
+    Snapshot snapshot;
+    snapshot.capture_leaf(source, 0x00);
+    snapshot.capture_leaf(source, 0x80000000);
+
+    unsigned max_basic = std::min(snapshot.max_basic(), max_range - 1);
+    unsigned max_ext = snapshot.max_extended();
+    for (unsigned eax = 0x01; eax <= max_basic; ++eax)
+        snapshot.capture_leaf(source, eax);
+    for (unsigned eax = 0x80000001; in_range(eax, 0x80000000, max_ext); ++eax)
+        snapshot.capture_leaf(source, eax);
+
+    std::sort(snapshot.leaves_.begin(), snapshot.leaves_.end(), leaf_less);
+
+    // Without a hypervisor the range reads as the highest basic leaf
+    if (test_bit(snapshot.get(0x01).ecx, 31)) {
+        snapshot.capture_hypervisor(source, hypervisor_base);
+        snapshot.capture_hypervisor(source, hypervisor_alt_base);
+        std::sort(snapshot.leaves_.begin(), snapshot.leaves_.end(), leaf_less);
+    }
+
+    return snapshot;
+}
+
+Snapshot Snapshot::capture(const unsigned *leaves, unsigned n)
+{
+    return capture(leaves, n, HardwareSource());
+}
+
+Snapshot Snapshot::capture(
+    const unsigned *leaves, unsigned n, const RegisterSource &source)
+{
+    Snapshot snapshot;
+    snapshot.capture_leaf(source, 0x00);
+    snapshot.capture_leaf(source, 0x80000000);
+
+    std::vector<unsigned> list(leaves, leaves + n);
+    std::sort(list.begin(), list.end());
+    list.erase(std::unique(list.begin(), list.end()), list.end());
+
+    unsigned max_basic = snapshot.max_basic();
+    unsigned max_ext = snapshot.max_extended();
+    for (std::size_t i = 0; i != list.size(); ++i) {
+        unsigned eax = list[i];
+        if (eax == 0x00 || eax == 0x80000000)
+            continue;
+        if (in_range(eax, 0x00, max_basic) ||
+            in_range(eax, 0x80000000, max_ext))
+            snapshot.capture_leaf(source, eax);
+    }
+
+    std::sort(snapshot.leaves_.begin(), snapshot.leaves_.end(), leaf_less);
+
+    return snapshot;
+}
+
+bool Snapshot::contains(unsigned eax, unsigned ecx) const
+{
+    Leaf key = {eax, ecx, {0, 0, 0, 0}};
+    std::vector<Leaf>::const_iterator iter =
+        std::lower_bound(leaves_.begin(), leaves_.end(), key, leaf_less);
+
+    return iter != leaves_.end() && iter->eax == eax && iter->ecx == ecx;
+}
+
+Register Snapshot::get(unsigned eax, unsigned ecx) const
+{
+    Leaf key = {eax, ecx, {0, 0, 0, 0}};
+    std::vector<Leaf>::const_iterator iter =
+        std::lower_bound(leaves_.begin(), leaves_.end(), key, leaf_less);
+    if (iter != leaves_.end() && iter->eax == eax && iter->ecx == ecx)
+        return iter->reg;
+
+    return key.reg;
+}
+
+void Snapshot::insert(unsigned eax, unsigned ecx, const Register &reg)
+{
+    Leaf leaf = {eax, ecx, reg};
+    std::vector<Leaf>::iterator iter =
+        std::lower_bound(leaves_.begin(), leaves_.end(), leaf, leaf_less);
+    if (iter != leaves_.end() && iter->eax == eax && iter->ecx == ecx)
+        iter->reg = reg;
+    else
+        leaves_.insert(iter, leaf);
+}
+
+// Leaves are appended unsorted, callers sort once all leaves are captured
+void Snapshot::capture_hypervisor(const RegisterSource &source, unsigned base)
+{
+    Register reg(source.read(base, 0x00));
+    unsigned max = reg.eax;
+    // Old KVM reports zero for a range ending at 0x40000001
+    if (max == 0 && base == hypervisor_base && reg.ebx != 0)
+        max = base + 1;
+    if (max < base || max - base >= max_range ||
+        (reg.ebx == 0 && reg.ecx == 0 && reg.edx == 0))
+        return;
+
+    Leaf leaf = {base, 0x00, reg};
+    leaves_.push_back(leaf);
+    for (unsigned eax = base + 1; eax <= max; ++eax)
+        capture_leaf(source, eax);
+
+    // Xen's time leaf has the TSC offset and host frequency in subleaves
+    if (xen_signature(reg) && max >= base + 3) {
+        for (unsigned ecx = 1; ecx <= 2; ++ecx) {
+            Leaf sub = {base + 3, ecx, source.read(base + 3, ecx)};
+            leaves_.push_back(sub);
+        }
+    }
+}
+
+void Snapshot::capture_leaf(const RegisterSource &source, unsigned eax)
+{
+    Register reg(source.read(eax, 0x00));
+    Leaf leaf = {eax, 0x00, reg};
+    leaves_.push_back(leaf);
+
+    unsigned ecx = 0;
+    switch (eax) {
+        case 0x04:
+        case 0x8000001D:
+            // Enumerate until cache type is null
+            while (extract_bits(reg.eax, 4, 0) != 0 && ++ecx < max_subleaf) {
+                reg = source.read(eax, ecx);
+                Leaf sub = {eax, ecx, reg};
+                leaves_.push_back(sub);
+            }
+            break;
+        case 0x0B:
+        case 0x1F:
+        case 0x80000026:
+            // Enumerate until level type is invalid
+            while (extract_bits(reg.ecx, 15, 8) != 0 && ++ecx < max_subleaf) {
+                reg = source.read(eax, ecx);
+                Leaf sub = {eax, ecx, reg};
+                leaves_.push_back(sub);
+            }
+            break;
+        case 0x07:
+        case 0x14:
+        case 0x17:
+        case 0x18:
+        case 0x1D:
+        case 0x20:
+        case 0x24:
+            // Subleaf 0 EAX reports the maximum subleaf
+            for (ecx = 1; ecx <= reg.eax && ecx < max_subleaf; ++ecx) {
+                Leaf sub = {eax, ecx, source.read(eax, ecx)};
+                leaves_.push_back(sub);
+            }
+            break;
+        case 0x0D:
+            // Subleaf 1 and one subleaf per supported XCR0 or IA32_XSS
+            // state component
+            {
+                Register sub1(source.read(eax, 0x01));
+                Leaf sub = {eax, 0x01, sub1};
+                leaves_.push_back(sub);
+                unsigned lo = reg.eax | sub1.ecx;
+                unsigned hi = reg.edx | sub1.edx;
+                for (ecx = 2; ecx != 63; ++ecx) {
+                    bool valid =
+                        ecx < 32 ? test_bit(lo, ecx) : test_bit(hi, ecx - 32);
+                    if (valid) {
+                        Leaf comp = {eax, ecx, source.read(eax, ecx)};
+                        leaves_.push_back(comp);
+                    }
+                }
+            }
+            break;
+        case 0x0F:
+        case 0x10:
+        case 0x80000020:
+            // Subleaf 0 reports a bitmap of the valid resource subleaves
+            {
+                unsigned mask = eax == 0x0F ? reg.edx : reg.ebx;
+                for (ecx = 1; ecx != 32; ++ecx) {
+                    if (test_bit(mask, ecx)) {
+                        Leaf sub = {eax, ecx, source.read(eax, ecx)};
+                        leaves_.push_back(sub);
+                    }
+                }
+            }
+            break;
+        case 0x12:
+            // SGX capability, attributes and EPC sections until invalid
+            for (ecx = 1; ecx < max_subleaf; ++ecx) {
+                reg = source.read(eax, ecx);
+                if (ecx >= 2 && extract_bits(reg.eax, 3, 0) == 0)
+                    break;
+                Leaf sub = {eax, ecx, reg};
+                leaves_.push_back(sub);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+} // namespace cpuid_info
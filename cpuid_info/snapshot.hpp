@@ -0,0 +1,109 @@
+#ifndef CPUID_INFO_SNAPSHOT_HPP
+#define CPUID_INFO_SNAPSHOT_HPP
+
+#include <cpuid_info/cpuid.hpp>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief The registers returned by one leaf/subleaf pair
+struct Leaf {
+    unsigned eax;
+    unsigned ecx;
+    Register reg;
+};
+
+/// \brief Where Snapshot::capture() reads its registers from
+class RegisterSource
+{
+    public:
+    virtual ~RegisterSource() {}
+
+    virtual Register read(unsigned eax, unsigned ecx) const = 0;
+}; // class RegisterSource
+
+/// \brief The CPUID instruction on the calling thread's CPU
+class HardwareSource : public RegisterSource
+{
+    public:
+    Register read(unsigned eax, unsigned ecx) const
+    {
+        return cpuid(eax, ecx);
+    }
+}; // class HardwareSource
+
+/// \brief Raw CPUID registers of every basic, extended and subleaf captured
+/// in one pass
+///
+/// \details
+/// Leaves are kept sorted by (eax, ecx) in a flat vector, so a lookup is a
+/// binary search and never executes another CPUID instruction. Leaves that
+/// were not captured read as all zero, which every decoder treats as "not
+/// supported". The hypervisor ranges from 0x40000000 and 0x40000100 are
+/// only captured by a full capture and only if leaf 0x01 reports a
+/// hypervisor.
+class Snapshot
+{
+    public:
+    /// \brief Capture all leaves on the calling thread's CPU
+    static Snapshot capture();
+
+    /// \brief Capture all leaves from `source`
+    static Snapshot capture(const RegisterSource &source);
+
+    /// \brief Capture only the listed leaves (with all of their subleaves)
+    /// on the calling thread's CPU
+    static Snapshot capture(const unsigned *leaves, unsigned n);
+
+    static Snapshot capture(
+        const unsigned *leaves, unsigned n, const RegisterSource &source);
+
+    unsigned max_basic() const { return get(0x00).eax; }
+    unsigned max_extended() const { return get(0x80000000).eax; }
+
+    bool contains(unsigned eax, unsigned ecx = 0) const;
+    Register get(unsigned eax, unsigned ecx = 0) const;
+    const std::vector<Leaf> &leaves() const { return leaves_; }
+
+    /// \brief Insert or replace a leaf
+    void insert(unsigned eax, unsigned ecx, const Register &reg);
+
+    private:
+    std::vector<Leaf> leaves_;
+
+    void capture_leaf(const RegisterSource &source, unsigned eax);
+    void capture_hypervisor(const RegisterSource &source, unsigned base);
+}; // class Snapshot
+
+/// \brief Registers served from a snapshot, for replaying dumps and mocking
+/// CPUs through the capture logic
+///
+/// \details
+/// Leaves missing from the snapshot read as all zero, as on a CPU that
+/// does not support them.
+class MockSource : public RegisterSource
+{
+    public:
+    MockSource() {}
+
+    explicit MockSource(const Snapshot &snapshot) : snapshot_(snapshot) {}
+
+    Register read(unsigned eax, unsigned ecx) const
+    {
+        return snapshot_.get(eax, ecx);
+    }
+
+    /// \brief Set the registers returned for a leaf
+    void set(unsigned eax, unsigned ecx, const Register &reg)
+    {
+        snapshot_.insert(eax, ecx, reg);
+    }
+
+    private:
+    Snapshot snapshot_;
+}; // class MockSource
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_SNAPSHOT_HPP
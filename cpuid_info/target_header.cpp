@@ -0,0 +1,128 @@
+#include <cpuid_info/target_header.hpp>
+#include <cpuid_info/uarch.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <ios>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+struct Level {
+    const char *name;
+    std::size_t size;
+    std::size_t per_thread;
+    unsigned ways;
+};
+
+// The first data or unified cache of `level`
+Level find_level(const CpuInfo &info, const char *name, unsigned level)
+{
+    Level result = {name, 0, 0, 0};
+    const std::vector<CacheParam> &caches = info.caches();
+    unsigned threads = info.core_count().threads_per_package;
+    for (std::size_t i = 0; i != caches.size(); ++i) {
+        const CacheParam &cache = caches[i];
+        if (cache.level() != level || cache.type() == "Instruction")
+            continue;
+        unsigned sharing = cache.max_proc_sharing();
+        if (threads != 0)
+            sharing = std::min(sharing, threads);
+        result.size = cache.size();
+        result.per_thread = cache.size() / std::max(sharing, 1U);
+        result.ways = cache.ways();
+        break;
+    }
+
+    return result;
+}
+
+// Widest vectors the compiler should use, see Microarch::vector_width
+unsigned vector_bits(const CpuInfo &info)
+{
+    const Features &features = info.features();
+    if (features.has(Feature::AVX512F)) {
+        const Microarch *m = identify_microarch(info);
+        return m != nullptr ? m->vector_width : 256;
+    }
+    if (features.has(Feature::AVX))
+        return 256;
+
+    return 128;
+}
+
+std::size_t tile_edge(std::size_t bytes, unsigned element, std::size_t lanes)
+{
+    std::size_t edge = static_cast<std::size_t>(
+        std::sqrt(static_cast<double>(bytes / 2) / (3.0 * element)));
+    edge -= edge % lanes;
+
+    return std::max(edge, lanes);
+}
+
+} // namespace
+
+void write_target_header(
+    const CpuInfo &info, std::ostream &out, const std::string &ns)
+{
+    Level levels[] = {find_level(info, "l1d", 1), find_level(info, "l2", 2),
+        find_level(info, "l3", 3)};
+    const std::size_t level_count = sizeof(levels) / sizeof(Level);
+
+    unsigned line_size = 64;
+    const std::vector<CacheParam> &caches = info.caches();
+    if (!caches.empty())
+        line_size = caches.front().line_size();
+    unsigned bits = vector_bits(info);
+    Signature sig(info.signature());
+
+    out << "// Generated by cpuid_info --header, do not edit\n";
+    out << "// " << info.vendor() << ", " << info.brand() << std::hex
+        << std::uppercase << ", family 0x" << sig.family << " model 0x"
+        << sig.model << " stepping " << std::dec << sig.stepping << "\n\n";
+    out << "#ifndef CPUID_TARGET_HPP\n#define CPUID_TARGET_HPP\n\n";
+    out << "#include <cstddef>\n\n";
+    out << "namespace " << ns << "\n{\n\n";
+
+    out << "constexpr std::size_t line_size = " << line_size << ";\n";
+    out << "constexpr unsigned vector_bits = " << bits << ";\n";
+    out << "constexpr std::size_t vector_bytes = vector_bits / 8;\n\n";
+
+    out << "// Size in bytes, share of one logical CPU and ways, zero if the"
+           " level\n// is not reported\n";
+    for (std::size_t i = 0; i != level_count; ++i) {
+        out << "constexpr std::size_t " << levels[i].name
+            << "_size = " << levels[i].size << ";\n";
+        out << "constexpr std::size_t " << levels[i].name
+            << "_size_per_thread = " << levels[i].per_thread << ";\n";
+        out << "constexpr unsigned " << levels[i].name
+            << "_ways = " << levels[i].ways << ";\n";
+    }
+    out << "\n";
+
+    out << "// Edge in elements of square tiles, three of which fill half of"
+           " each\n// level's share, in whole vectors\n";
+    out << "template <std::size_t ElementSize>\nstruct tile;\n";
+    for (unsigned e = 0; e != target_element_size_count; ++e) {
+        unsigned element = target_element_sizes[e];
+        std::size_t lanes = std::max(bits / 8 / element, 1U);
+        out << "\ntemplate <>\nstruct tile<" << element << "> {\n";
+        std::size_t bytes = 0;
+        for (std::size_t i = 0; i != level_count; ++i) {
+            if (levels[i].per_thread != 0)
+                bytes = levels[i].per_thread;
+            const char *name = i == 0 ? "l1" : levels[i].name;
+            out << "    static constexpr std::size_t " << name << " = "
+                << (bytes != 0 ? tile_edge(bytes, element, lanes) : lanes)
+                << ";\n";
+        }
+        out << "};\n";
+    }
+
+    out << "\n} // namespace " << ns << "\n\n#endif // CPUID_TARGET_HPP\n";
+}
+
+} // namespace cpuid_info
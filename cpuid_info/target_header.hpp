@@ -0,0 +1,33 @@
+#ifndef CPUID_INFO_TARGET_HEADER_HPP
+#define CPUID_INFO_TARGET_HEADER_HPP
+
+#include <cpuid_info/cpu_info.hpp>
+#include <ostream>
+#include <string>
+
+namespace cpuid_info
+{
+
+/// \brief Element sizes `write_target_header()` computes tiles for
+const unsigned target_element_sizes[] = {1, 2, 4, 8};
+
+const unsigned target_element_size_count =
+    sizeof(target_element_sizes) / sizeof(unsigned);
+
+/// \brief Write a C++ header of `constexpr` cache and vector constants for
+/// the CPU of `info`
+///
+/// \details
+/// The header defines, in namespace `ns`, the line size, the preferred
+/// vector width, the size, per-thread share and associativity of L1D, L2
+/// and L3, and a `tile<ElementSize>` template specialized for every size of
+/// `target_element_sizes`. A tile is the edge in elements of a square block
+/// of which three (two inputs and one output) fill half of a level's
+/// per-thread share, rounded down to a whole number of vectors. Missing
+/// levels are zero and their tiles repeat the level below.
+void write_target_header(const CpuInfo &info, std::ostream &out,
+    const std::string &ns = "cpuid_target");
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_TARGET_HEADER_HPP
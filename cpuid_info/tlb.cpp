@@ -0,0 +1,237 @@
+#include <cpuid_info/tlb.hpp>
+#include <algorithm>
+#include <cstddef>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+// Leaf 0x02 TLB descriptors, SDM Vol. 2A Table 3-12. Descriptors that
+// describe two arrays (0x63, 0xC3) have one row per array.
+struct TlbDescriptor {
+    unsigned char descriptor;
+    unsigned char level;
+    const char *type;
+    unsigned char pages;
+    unsigned short entries;
+    unsigned char ways;  // 0 if unspecified, 0xFF if fully associative
+};
+
+const unsigned char fully = 0xFF;
+
+const TlbDescriptor tlb_descriptors[] = {
+    {0x01, 1, "Instruction", TlbPage4K, 32, 4},
+    {0x02, 1, "Instruction", TlbPage4M, 2, fully},
+    {0x03, 1, "Data", TlbPage4K, 64, 4},
+    {0x04, 1, "Data", TlbPage4M, 8, 4},
+    {0x05, 1, "Data", TlbPage4M, 32, 4},
+    {0x0B, 1, "Instruction", TlbPage4M, 4, 4},
+    {0x4F, 1, "Instruction", TlbPage4K, 32, 0},
+    {0x50, 1, "Instruction", TlbPage4K | TlbPage2M | TlbPage4M, 64, 0},
+    {0x51, 1, "Instruction", TlbPage4K | TlbPage2M | TlbPage4M, 128, 0},
+    {0x52, 1, "Instruction", TlbPage4K | TlbPage2M | TlbPage4M, 256, 0},
+    {0x55, 1, "Instruction", TlbPage2M | TlbPage4M, 7, fully},
+    {0x56, 1, "Data", TlbPage4M, 16, 4},
+    {0x57, 1, "Data", TlbPage4K, 16, 4},
+    {0x59, 1, "Data", TlbPage4K, 16, fully},
+    {0x5A, 1, "Data", TlbPage2M | TlbPage4M, 32, 4},
+    {0x5B, 1, "Data", TlbPage4K | TlbPage4M, 64, 0},
+    {0x5C, 1, "Data", TlbPage4K | TlbPage4M, 128, 0},
+    {0x5D, 1, "Data", TlbPage4K | TlbPage4M, 256, 0},
+    {0x61, 1, "Instruction", TlbPage4K, 48, fully},
+    {0x63, 1, "Data", TlbPage2M | TlbPage4M, 32, 4},
+    {0x63, 1, "Data", TlbPage1G, 4, 4},
+    {0x64, 1, "Data", TlbPage4K, 512, 4},
+    {0x6A, 1, "Load", TlbPage4K, 64, 8},
+    {0x6B, 1, "Data", TlbPage4K, 256, 8},
+    {0x6C, 1, "Data", TlbPage2M | TlbPage4M, 128, 8},
+    {0x6D, 1, "Data", TlbPage1G, 16, fully},
+    {0x76, 1, "Instruction", TlbPage2M | TlbPage4M, 8, fully},
+    {0xA0, 1, "Data", TlbPage4K, 32, fully},
+    {0xB0, 1, "Instruction", TlbPage4K, 128, 4},
+    {0xB1, 1, "Instruction", TlbPage2M, 8, 4},
+    {0xB2, 1, "Instruction", TlbPage4K, 64, 4},
+    {0xB3, 1, "Data", TlbPage4K, 128, 4},
+    {0xB4, 1, "Data", TlbPage4K, 256, 4},
+    {0xB5, 1, "Instruction", TlbPage4K, 64, 8},
+    {0xB6, 1, "Instruction", TlbPage4K, 128, 8},
+    {0xBA, 1, "Data", TlbPage4K, 64, 4},
+    {0xC0, 1, "Data", TlbPage4K | TlbPage4M, 8, 4},
+    {0xC1, 2, "Unified", TlbPage4K | TlbPage2M, 1024, 8},
+    {0xC2, 1, "Data", TlbPage4K | TlbPage2M, 16, 4},
+    {0xC3, 2, "Unified", TlbPage4K | TlbPage2M, 1536, 6},
+    {0xC3, 2, "Unified", TlbPage1G, 16, 4},
+    {0xC4, 1, "Data", TlbPage2M | TlbPage4M, 32, 4},
+    {0xCA, 2, "Unified", TlbPage4K, 512, 4},
+};
+
+const std::size_t tlb_descriptor_count =
+    sizeof(tlb_descriptors) / sizeof(tlb_descriptors[0]);
+
+bool tlb_less(const TlbParam &a, const TlbParam &b)
+{
+    if (a.level != b.level)
+        return a.level < b.level;
+    if (a.type != b.type)
+        return a.type < b.type;
+
+    return a.pages < b.pages;
+}
+
+void add_tlb(std::vector<TlbParam> &tlbs, unsigned level, const char *type,
+    unsigned pages, unsigned entries, unsigned ways)
+{
+    if (entries == 0 || ways == 0)
+        return;
+
+    TlbParam tlb;
+    tlb.level = level;
+    tlb.type = type;
+    tlb.pages = pages;
+    tlb.entries = entries;
+    tlb.fully_associative = ways == 0xFF;
+    tlb.ways = tlb.fully_associative ? entries : ways;
+    tlb.max_proc_sharing = 0;
+    tlbs.push_back(tlb);
+}
+
+// An L2 or 1G register of 0x80000006/0x80000019: data TLB in the upper
+// half, instruction TLB in the lower half
+void add_amd_tlbs(std::vector<TlbParam> &tlbs, unsigned level, unsigned reg,
+    unsigned pages)
+{
+    add_tlb(tlbs, level, "Data", pages, extract_bits(reg, 27, 16),
+        amd_associativity(extract_bits(reg, 31, 28)));
+    add_tlb(tlbs, level, "Instruction", pages, extract_bits(reg, 11, 0),
+        amd_associativity(extract_bits(reg, 15, 12)));
+}
+
+} // namespace
+
+std::string tlb_page_names(unsigned pages)
+{
+    static const char *names[] = {"4K", "2M", "4M", "1G"};
+
+    std::string str;
+    for (unsigned i = 0; i != 4; ++i) {
+        if (pages & (1u << i)) {
+            if (!str.empty())
+                str += "/";
+            str += names[i];
+        }
+    }
+
+    return str;
+}
+
+std::vector<unsigned> leaf2_descriptors(const Register &reg)
+{
+    std::vector<unsigned> descriptors;
+    const unsigned regs[] = {reg.eax, reg.ebx, reg.ecx, reg.edx};
+    for (unsigned r = 0; r != 4; ++r) {
+        if (test_bit(regs[r], 31))
+            continue;
+        for (unsigned b = r == 0 ? 1 : 0; b != 4; ++b)
+            if (extract_byte(regs[r], b) != 0)
+                descriptors.push_back(extract_byte(regs[r], b));
+    }
+    std::sort(descriptors.begin(), descriptors.end());
+
+    return descriptors;
+}
+
+std::vector<TlbParam> leaf2_tlbs(const Register &reg)
+{
+    std::vector<unsigned> descriptors(leaf2_descriptors(reg));
+    std::vector<TlbParam> tlbs;
+    for (std::size_t i = 0; i != descriptors.size(); ++i) {
+        for (std::size_t j = 0; j != tlb_descriptor_count; ++j) {
+            const TlbDescriptor &d = tlb_descriptors[j];
+            if (d.descriptor != descriptors[i])
+                continue;
+            TlbParam tlb;
+            tlb.level = d.level;
+            tlb.type = d.type;
+            tlb.pages = d.pages;
+            tlb.entries = d.entries;
+            tlb.fully_associative = d.ways == fully;
+            tlb.ways = tlb.fully_associative ? d.entries : d.ways;
+            tlb.max_proc_sharing = 0;
+            tlbs.push_back(tlb);
+        }
+    }
+    std::stable_sort(tlbs.begin(), tlbs.end(), tlb_less);
+
+    return tlbs;
+}
+
+std::vector<TlbParam> leaf18_tlbs(const Snapshot &snapshot)
+{
+    static const char *types[] = {
+        nullptr, "Data", "Instruction", "Unified", "Load", "Store"};
+
+    std::vector<TlbParam> tlbs;
+    if (snapshot.max_basic() < 0x18)
+        return tlbs;
+
+    // Subleaf 0 EAX is the highest subleaf, invalid subleaves have type 0
+    unsigned max_subleaf = snapshot.get(0x18).eax;
+    for (unsigned ecx = 0; ecx <= max_subleaf; ++ecx) {
+        if (!snapshot.contains(0x18, ecx))
+            break;
+        Register reg(snapshot.get(0x18, ecx));
+        unsigned type = extract_bits(reg.edx, 4, 0);
+        if (type == 0 || type > 5)
+            continue;
+
+        TlbParam tlb;
+        tlb.level = extract_bits(reg.edx, 7, 5);
+        tlb.type = types[type];
+        tlb.pages = extract_bits(reg.ebx, 3, 0);
+        tlb.ways = extract_bits(reg.ebx, 31, 16);
+        tlb.entries = tlb.ways * reg.ecx;
+        tlb.fully_associative = test_bit(reg.edx, 8);
+        tlb.max_proc_sharing = extract_bits(reg.edx, 25, 14) + 1;
+        tlbs.push_back(tlb);
+    }
+    std::stable_sort(tlbs.begin(), tlbs.end(), tlb_less);
+
+    return tlbs;
+}
+
+std::vector<TlbParam> amd_tlbs(const Snapshot &snapshot)
+{
+    std::vector<TlbParam> tlbs;
+    unsigned max = snapshot.max_extended();
+
+    // L1: data TLB in the upper half, instruction TLB in the lower half,
+    // entries in 8 bits and the associativity as a plain count
+    if (max >= 0x80000005) {
+        Register reg(snapshot.get(0x80000005));
+        add_tlb(tlbs, 1, "Data", TlbPage2M | TlbPage4M,
+            extract_byte(reg.eax, 2), extract_byte(reg.eax, 3));
+        add_tlb(tlbs, 1, "Instruction", TlbPage2M | TlbPage4M,
+            extract_byte(reg.eax, 0), extract_byte(reg.eax, 1));
+        add_tlb(tlbs, 1, "Data", TlbPage4K, extract_byte(reg.ebx, 2),
+            extract_byte(reg.ebx, 3));
+        add_tlb(tlbs, 1, "Instruction", TlbPage4K, extract_byte(reg.ebx, 0),
+            extract_byte(reg.ebx, 1));
+    }
+    if (max >= 0x80000006) {
+        Register reg(snapshot.get(0x80000006));
+        add_amd_tlbs(tlbs, 2, reg.eax, TlbPage2M | TlbPage4M);
+        add_amd_tlbs(tlbs, 2, reg.ebx, TlbPage4K);
+    }
+    if (max >= 0x80000019) {
+        Register reg(snapshot.get(0x80000019));
+        add_amd_tlbs(tlbs, 1, reg.eax, TlbPage1G);
+        add_amd_tlbs(tlbs, 2, reg.ebx, TlbPage1G);
+    }
+    std::stable_sort(tlbs.begin(), tlbs.end(), tlb_less);
+
+    return tlbs;
+}
+
+} // namespace cpuid_info
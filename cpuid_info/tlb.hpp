@@ -0,0 +1,57 @@
+#ifndef CPUID_INFO_TLB_HPP
+#define CPUID_INFO_TLB_HPP
+
+#include <cpuid_info/cpuid.hpp>
+#include <cpuid_info/snapshot.hpp>
+#include <string>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief Page sizes a TLB holds translations for, combined as a bitmask
+enum TlbPage : unsigned {
+    TlbPage4K = 0x1,
+    TlbPage2M = 0x2,
+    TlbPage4M = 0x4,
+    TlbPage1G = 0x8
+};
+
+/// \brief Page sizes of a TLB, e.g. "4K/2M/4M"
+std::string tlb_page_names(unsigned pages);
+
+/// \brief One TLB, or one array of a TLB with a separate array per page size
+struct TlbParam {
+    unsigned level;           ///< 1 for the first level, 2 for the STLB
+    std::string type;         ///< Data, Instruction, Unified, Load or Store
+    unsigned pages;           ///< TlbPage bitmask
+    unsigned entries;         ///< Number of entries, 0 if unknown
+    unsigned ways;            ///< Associativity, 0 if unknown
+    bool fully_associative;
+    unsigned max_proc_sharing;  ///< Logical CPUs sharing it, 0 if unknown
+};
+
+/// \brief The non-zero descriptor bytes of leaf 0x02, sorted
+///
+/// \details
+/// The low byte of EAX is the iteration count and not a descriptor, a
+/// register with bit 31 set holds no descriptors.
+std::vector<unsigned> leaf2_descriptors(const Register &reg);
+
+/// \brief TLBs of the leaf 0x02 descriptors, Intel only
+///
+/// \details
+/// Descriptor 0xFE means the TLBs are reported by leaf 0x18 instead and
+/// yields nothing here.
+std::vector<TlbParam> leaf2_tlbs(const Register &reg);
+
+/// \brief TLBs of the deterministic address translation leaf 0x18
+std::vector<TlbParam> leaf18_tlbs(const Snapshot &snapshot);
+
+/// \brief TLBs of the AMD leaves 0x80000005 (L1), 0x80000006 (L2) and
+/// 0x80000019 (1G pages)
+std::vector<TlbParam> amd_tlbs(const Snapshot &snapshot);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_TLB_HPP
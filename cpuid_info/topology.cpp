@@ -0,0 +1,307 @@
+#include <cpuid_info/affinity.hpp>
+#include <cpuid_info/cpu_info.hpp>
+#include <cpuid_info/topology.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <set>
+#include <thread>
+#include <utility>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+// Leaves whose content differs between logical CPUs, plus the legacy AMD
+// cache leaves needed to decode the caches without 0x8000001D
+const unsigned topology_leaves[] = {0x01, 0x04, 0x07, 0x0B, 0x16, 0x1A,
+    0x1F, 0x80000001, 0x80000005, 0x80000006, 0x80000008, 0x8000001D,
+    0x8000001E};
+
+inline unsigned low_bits(unsigned x, unsigned n)
+{
+    return n >= 32 ? x : x & ((1U << n) - 1);
+}
+
+inline unsigned high_bits(unsigned x, unsigned n)
+{
+    return n >= 32 ? 0 : x >> n;
+}
+
+inline bool cpu_less(const LogicalCpu &a, const LogicalCpu &b)
+{
+    if (a.package != b.package)
+        return a.package < b.package;
+    if (a.die != b.die)
+        return a.die < b.die;
+    if (a.core != b.core)
+        return a.core < b.core;
+    if (a.thread != b.thread)
+        return a.thread < b.thread;
+
+    return a.os_id < b.os_id;
+}
+
+// Leaf 0x1F or 0x0B, or zero if neither enumerates any level
+inline unsigned extended_topology_leaf(const Snapshot &snapshot)
+{
+    if (snapshot.max_basic() >= 0x1F && snapshot.get(0x1F).ebx != 0)
+        return 0x1F;
+    if (snapshot.max_basic() >= 0x0B && snapshot.get(0x0B).ebx != 0)
+        return 0x0B;
+
+    return 0;
+}
+
+void visit_cpus(const std::vector<int> &ids, std::vector<LogicalCpu> &cpus,
+    std::vector<char> &visited, std::size_t first, std::size_t stride)
+{
+    const unsigned n = sizeof(topology_leaves) / sizeof(unsigned);
+    for (std::size_t i = first; i < ids.size(); i += stride) {
+        if (!pin_this_thread(ids[i]))
+            continue;
+        cpus[i].os_id = ids[i];
+        cpus[i].snapshot = Snapshot::capture(topology_leaves, n);
+        decode_topology(cpus[i]);
+        visited[i] = 1;
+    }
+}
+
+} // namespace
+
+void decode_topology(LogicalCpu &cpu)
+{
+    const Snapshot &snapshot = cpu.snapshot;
+    const Vendor vendor = vendor_of(snapshot);
+    const bool amd = vendor == Vendor::AMD || vendor == Vendor::Hygon;
+    const bool topoext = snapshot.max_extended() >= 0x8000001E &&
+        test_bit(snapshot.get(0x80000001).ecx, 22);
+
+    Register leaf01(snapshot.get(0x01));
+    cpu.apic_id = extract_bits(leaf01.ebx, 31, 24);
+    unsigned smt_shift = 0;
+    unsigned pkg_shift = 0;
+    unsigned die_lo = 0;
+    unsigned die_hi = 0;
+
+    unsigned leaf = extended_topology_leaf(snapshot);
+    if (leaf != 0) {
+        // Each level reports the shift to the ID of the next level up, the
+        // last valid level gives the package shift
+        unsigned prev_shift = 0;
+        for (unsigned ecx = 0; snapshot.contains(leaf, ecx); ++ecx) {
+            Register reg(snapshot.get(leaf, ecx));
+            unsigned type = extract_bits(reg.ecx, 15, 8);
+            if (type == 0)
+                break;
+            unsigned shift = extract_bits(reg.eax, 4, 0);
+            if (type == 1)
+                smt_shift = shift;
+            if (type == 5) {
+                die_lo = prev_shift;
+                die_hi = shift;
+            }
+            prev_shift = shift;
+            pkg_shift = shift;
+            cpu.apic_id = reg.edx;
+        }
+    } else {
+        unsigned logical =
+            test_bit(leaf01.edx, 28) ? extract_bits(leaf01.ebx, 23, 16) : 1;
+        unsigned cores = 1;
+        if (amd && snapshot.max_extended() >= 0x80000008) {
+            Register reg(snapshot.get(0x80000008));
+            cores = extract_bits(reg.ecx, 7, 0) + 1;
+            unsigned core_id_size = extract_bits(reg.ecx, 15, 12);
+            pkg_shift = core_id_size != 0 ? core_id_size : ceil_log2(cores);
+        } else if (snapshot.max_basic() >= 0x04) {
+            cores = extract_bits(snapshot.get(0x04).eax, 31, 26) + 1;
+            pkg_shift = ceil_log2(logical);
+        }
+        unsigned threads = logical > cores ? logical / cores : 1;
+        if (amd && topoext)
+            threads = extract_bits(snapshot.get(0x8000001E).ebx, 15, 8) + 1;
+        smt_shift = ceil_log2(threads);
+        pkg_shift = std::max(pkg_shift, smt_shift);
+    }
+
+    if (amd && topoext && leaf == 0)
+        cpu.apic_id = snapshot.get(0x8000001E).eax;
+
+    cpu.thread = low_bits(cpu.apic_id, smt_shift);
+    cpu.core = low_bits(cpu.apic_id, pkg_shift) >> smt_shift;
+    cpu.die = die_hi > die_lo ? low_bits(cpu.apic_id, die_hi) >> die_lo : 0;
+    cpu.package = high_bits(cpu.apic_id, pkg_shift);
+
+    // AMD does not report a die level, the node ID identifies the die
+    if (amd && topoext && die_hi == 0)
+        cpu.die = extract_bits(snapshot.get(0x8000001E).ecx, 7, 0);
+}
+
+Topology Topology::enumerate()
+{
+    std::vector<int> ids(allowed_cpus());
+    std::vector<LogicalCpu> cpus(ids.size());
+    std::vector<char> visited(ids.size(), 0);
+
+    if (!ids.empty()) {
+        std::vector<std::thread> workers;
+        for (std::size_t i = 0; i != ids.size(); ++i) {
+            workers.push_back(std::thread(visit_cpus, std::cref(ids),
+                std::ref(cpus), std::ref(visited), i, ids.size()));
+        }
+        for (std::size_t i = 0; i != workers.size(); ++i)
+            workers[i].join();
+    }
+
+    std::vector<LogicalCpu> result;
+    for (std::size_t i = 0; i != cpus.size(); ++i)
+        if (visited[i])
+            result.push_back(cpus[i]);
+
+    if (result.empty()) {
+        LogicalCpu cpu;
+        cpu.os_id = 0;
+        cpu.snapshot = Snapshot::capture(
+            topology_leaves, sizeof(topology_leaves) / sizeof(unsigned));
+        decode_topology(cpu);
+        result.push_back(cpu);
+    }
+
+    return Topology(result);
+}
+
+Topology Topology::replay(const std::vector<Snapshot> &snapshots)
+{
+    std::vector<LogicalCpu> cpus(snapshots.size());
+    for (std::size_t i = 0; i != snapshots.size(); ++i) {
+        cpus[i].os_id = static_cast<int>(i);
+        cpus[i].snapshot = snapshots[i];
+        decode_topology(cpus[i]);
+    }
+
+    return Topology(cpus);
+}
+
+Topology::Topology(const std::vector<LogicalCpu> &cpus) : cpus_(cpus)
+{
+    std::sort(cpus_.begin(), cpus_.end(), cpu_less);
+}
+
+const LogicalCpu *Topology::find(int os_id) const
+{
+    for (std::size_t i = 0; i != cpus_.size(); ++i)
+        if (cpus_[i].os_id == os_id)
+            return &cpus_[i];
+
+    return 0;
+}
+
+unsigned Topology::packages() const
+{
+    return static_cast<unsigned>(package_ids().size());
+}
+
+unsigned Topology::dies() const
+{
+    std::set<std::pair<unsigned, unsigned> > ids;
+    for (std::size_t i = 0; i != cpus_.size(); ++i)
+        ids.insert(std::make_pair(cpus_[i].package, cpus_[i].die));
+
+    return static_cast<unsigned>(ids.size());
+}
+
+unsigned Topology::cores() const
+{
+    std::set<std::pair<unsigned, unsigned> > ids;
+    for (std::size_t i = 0; i != cpus_.size(); ++i)
+        ids.insert(std::make_pair(cpus_[i].package, cpus_[i].core));
+
+    return static_cast<unsigned>(ids.size());
+}
+
+std::vector<unsigned> Topology::package_ids() const
+{
+    std::set<unsigned> ids;
+    for (std::size_t i = 0; i != cpus_.size(); ++i)
+        ids.insert(cpus_[i].package);
+
+    return std::vector<unsigned>(ids.begin(), ids.end());
+}
+
+std::vector<unsigned> Topology::die_ids(unsigned package) const
+{
+    std::set<unsigned> ids;
+    for (std::size_t i = 0; i != cpus_.size(); ++i)
+        if (cpus_[i].package == package)
+            ids.insert(cpus_[i].die);
+
+    return std::vector<unsigned>(ids.begin(), ids.end());
+}
+
+std::vector<int> Topology::package_cpus(unsigned package) const
+{
+    std::vector<int> cpus;
+    for (std::size_t i = 0; i != cpus_.size(); ++i)
+        if (cpus_[i].package == package)
+            cpus.push_back(cpus_[i].os_id);
+
+    return cpus;
+}
+
+std::vector<int> Topology::die_cpus(unsigned package, unsigned die) const
+{
+    std::vector<int> cpus;
+    for (std::size_t i = 0; i != cpus_.size(); ++i)
+        if (cpus_[i].package == package && cpus_[i].die == die)
+            cpus.push_back(cpus_[i].os_id);
+
+    return cpus;
+}
+
+std::vector<int> Topology::core_cpus(int os_id) const
+{
+    std::vector<int> cpus;
+    const LogicalCpu *cpu = find(os_id);
+    if (cpu == 0)
+        return cpus;
+
+    for (std::size_t i = 0; i != cpus_.size(); ++i)
+        if (cpus_[i].package == cpu->package && cpus_[i].core == cpu->core)
+            cpus.push_back(cpus_[i].os_id);
+
+    return cpus;
+}
+
+std::vector<int> Topology::one_thread_per_core() const
+{
+    std::vector<int> cpus;
+    std::set<std::pair<unsigned, unsigned> > seen;
+    for (std::size_t i = 0; i != cpus_.size(); ++i) {
+        if (seen.insert(std::make_pair(cpus_[i].package, cpus_[i].core))
+                .second)
+            cpus.push_back(cpus_[i].os_id);
+    }
+
+    return cpus;
+}
+
+std::vector<int> Topology::cores_first(const std::vector<int> &cpus) const
+{
+    std::vector<int> first;
+    std::vector<int> rest;
+    std::vector<int> primary(one_thread_per_core());
+    for (std::size_t i = 0; i != cpus.size(); ++i) {
+        if (std::find(primary.begin(), primary.end(), cpus[i]) != primary.end())
+            first.push_back(cpus[i]);
+        else
+            rest.push_back(cpus[i]);
+    }
+    first.insert(first.end(), rest.begin(), rest.end());
+
+    return first;
+}
+
+} // namespace cpuid_info
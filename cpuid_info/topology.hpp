@@ -0,0 +1,82 @@
+#ifndef CPUID_INFO_TOPOLOGY_HPP
+#define CPUID_INFO_TOPOLOGY_HPP
+
+#include <cpuid_info/snapshot.hpp>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief One logical CPU and its place in the package/die/core/thread
+/// hierarchy
+struct LogicalCpu {
+    int os_id;          ///< CPU number used by the OS for affinity
+    unsigned apic_id;   ///< x2APIC ID, or the initial APIC ID on old CPUs
+    unsigned package;   ///< Package (socket) ID
+    unsigned die;       ///< Die ID within the package, node ID on AMD
+    unsigned core;      ///< Core ID within the package
+    unsigned thread;    ///< SMT thread ID within the core
+    Snapshot snapshot;  ///< The per-CPU leaves captured on this CPU
+};
+
+/// \brief Decode the topology IDs of a LogicalCpu from its snapshot
+void decode_topology(LogicalCpu &cpu);
+
+/// \brief Package/die/core/thread map of all logical CPUs
+class Topology
+{
+    public:
+    /// \brief Visit every logical CPU the process is allowed to run on
+    ///
+    /// \details
+    /// Worker threads are pinned with `sched_setaffinity` to each CPU in
+    /// turn and capture the leaves that differ between CPUs (0x01, 0x04,
+    /// 0x07, 0x0B, 0x16, 0x1A, 0x1F and the AMD 0x8000001D/0x8000001E)
+    /// there. The CPUs are visited in parallel, one worker per CPU up to the
+    /// number of CPUs. On platforms without affinity support only the
+    /// calling thread's CPU is visited.
+    static Topology enumerate();
+
+    /// \brief Decode the topology of replayed snapshots, e.g. a dump of
+    /// another machine, numbering the CPUs in order from 0
+    static Topology replay(const std::vector<Snapshot> &snapshots);
+
+    Topology() {}
+
+    /// \brief Build from already decoded CPUs, e.g. replayed snapshots
+    explicit Topology(const std::vector<LogicalCpu> &cpus);
+
+    /// \brief All CPUs, ordered by package, die, core and thread
+    const std::vector<LogicalCpu> &cpus() const { return cpus_; }
+
+    /// \brief The CPU with the given OS number, or null
+    const LogicalCpu *find(int os_id) const;
+
+    unsigned packages() const;
+    unsigned dies() const;
+    unsigned cores() const;
+    unsigned threads() const { return static_cast<unsigned>(cpus_.size()); }
+
+    std::vector<unsigned> package_ids() const;
+    std::vector<unsigned> die_ids(unsigned package) const;
+
+    std::vector<int> package_cpus(unsigned package) const;
+    std::vector<int> die_cpus(unsigned package, unsigned die) const;
+
+    /// \brief The SMT siblings of a CPU, including itself
+    std::vector<int> core_cpus(int os_id) const;
+
+    /// \brief The first SMT thread of every core
+    std::vector<int> one_thread_per_core() const;
+
+    /// \brief Reorder `cpus` so that the first SMT thread of every core
+    /// comes before any second thread
+    std::vector<int> cores_first(const std::vector<int> &cpus) const;
+
+    private:
+    std::vector<LogicalCpu> cpus_;
+}; // class Topology
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_TOPOLOGY_HPP
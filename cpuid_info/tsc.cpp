@@ -0,0 +1,256 @@
+#include <cpuid_info/tsc.hpp>
+#include <cpuid_info/bench.hpp>
+#include <cpuid_info/hypervisor.hpp>
+
+#if defined(__linux__)
+#include <time.h>
+#endif
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+// Crystal clocks of Intel family 6 models whose leaf 0x15 ECX is zero
+struct Crystal {
+    unsigned model;
+    unsigned hz;
+};
+
+const Crystal crystal_table[] = {
+    {0x4E, 24000000},  // Skylake client
+    {0x5E, 24000000},
+    {0x8E, 24000000},  // Kaby, Coffee, Whiskey and Amber Lake
+    {0x9E, 24000000},
+    {0xA5, 24000000},  // Comet Lake
+    {0xA6, 24000000},
+    {0x5C, 19200000},  // Goldmont
+    {0x5F, 25000000},  // Denverton
+};
+
+const std::size_t crystal_count = sizeof(crystal_table) / sizeof(Crystal);
+
+double monotonic_ns()
+{
+#if defined(__linux__)
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+
+    return static_cast<double>(ts.tv_sec) * 1e9 +
+        static_cast<double>(ts.tv_nsec);
+#else
+    return std::chrono::duration<double, std::nano>(
+        bench_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+// A TSC reading and the clock at the same moment
+struct ClockPair {
+    std::uint64_t tsc;
+    double ns;
+};
+
+ClockPair read_pair()
+{
+    ClockPair best = {0, 0};
+    std::uint64_t best_ticks = ~std::uint64_t(0);
+    for (unsigned i = 0; i != 8; ++i) {
+        std::uint64_t before = rdtsc_ordered();
+        double ns = monotonic_ns();
+        std::uint64_t after = rdtsc_ordered();
+        if (after - before < best_ticks) {
+            best_ticks = after - before;
+            best.tsc = before + (after - before) / 2;
+            best.ns = ns;
+        }
+    }
+
+    return best;
+}
+
+// Time sources measured by measure_timer_costs()
+struct ReadRdtsc {
+    static std::uint64_t read(const TscClock &) { return rdtsc(); }
+};
+
+struct ReadOrdered {
+    static std::uint64_t read(const TscClock &) { return rdtsc_ordered(); }
+};
+
+struct ReadRdtscp {
+    static std::uint64_t read(const TscClock &) { return rdtscp(); }
+};
+
+struct ReadTscClock {
+    static std::uint64_t read(const TscClock &clock)
+    {
+        return clock.now_ns();
+    }
+};
+
+#if defined(__linux__)
+struct ReadClockGettime {
+    static std::uint64_t read(const TscClock &)
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+
+        return static_cast<std::uint64_t>(ts.tv_nsec);
+    }
+};
+#endif
+
+struct ReadSteadyClock {
+    static std::uint64_t read(const TscClock &)
+    {
+        return static_cast<std::uint64_t>(
+            bench_clock::now().time_since_epoch().count());
+    }
+};
+
+// Reads `clock` with `Read` a given number of times
+template <typename Read>
+struct ReadLoop {
+    const TscClock &clock;
+
+    void operator()(unsigned long iterations) const
+    {
+        std::uint64_t sum = 0;
+        for (unsigned long i = 0; i != iterations; ++i)
+            sum += Read::read(clock);
+        do_not_optimize(sum);
+    }
+};
+
+template <typename Read>
+double read_cost(const TscClock &clock, double ms)
+{
+    ReadLoop<Read> loop = {clock};
+
+    return time_per_iteration(loop, ms);
+}
+
+} // namespace
+
+const char *tsc_source_name(TscSource source)
+{
+    switch (source) {
+        case TscSource::Leaf15:
+            return "Leaf 0x15";
+        case TscSource::Leaf15Model:
+            return "Leaf 0x15, crystal of the model";
+        case TscSource::Leaf15Base:
+            return "Leaf 0x15, crystal from leaf 0x16";
+        case TscSource::Leaf16:
+            return "Leaf 0x16 base frequency";
+        case TscSource::Hypervisor:
+            return "Hypervisor";
+        case TscSource::Calibrated:
+            return "Calibrated";
+        default:
+            return "Unknown";
+    }
+}
+
+TscInfo tsc_info(const CpuInfo &info)
+{
+    const Snapshot &snapshot = info.snapshot();
+    TscInfo tsc = TscInfo();
+    tsc.source = TscSource::None;
+    tsc.invariant = snapshot.max_extended() >= 0x80000007 &&
+        test_bit(snapshot.get(0x80000007).edx, 8);
+    tsc.rdtscp = info.features().has(Feature::RDTSCP);
+
+    bool intel = info.vendor_id() == Vendor::Intel;
+    unsigned base_mhz =
+        snapshot.max_basic() >= 0x16 ? info.frequency().base : 0;
+    if (snapshot.max_basic() >= 0x15) {
+        Register reg(snapshot.get(0x15));
+        tsc.ratio_denominator = reg.eax;
+        tsc.ratio_numerator = reg.ebx;
+        tsc.crystal_hz = reg.ecx;
+    }
+    if (tsc.ratio_numerator != 0 && tsc.ratio_denominator != 0) {
+        Signature sig(info.signature());
+        if (tsc.crystal_hz != 0) {
+            tsc.source = TscSource::Leaf15;
+        } else if (intel && sig.family == 0x6) {
+            for (std::size_t i = 0; i != crystal_count; ++i) {
+                if (crystal_table[i].model == sig.model) {
+                    tsc.crystal_hz = crystal_table[i].hz;
+                    tsc.source = TscSource::Leaf15Model;
+                }
+            }
+        }
+        if (tsc.crystal_hz == 0 && base_mhz != 0) {
+            tsc.crystal_hz = static_cast<unsigned>(
+                base_mhz * 1000000ULL * tsc.ratio_denominator /
+                tsc.ratio_numerator);
+            tsc.source = TscSource::Leaf15Base;
+        }
+        tsc.hz = static_cast<double>(tsc.crystal_hz) * tsc.ratio_numerator /
+            tsc.ratio_denominator;
+    }
+    if (tsc.hz == 0 && intel && base_mhz != 0) {
+        tsc.hz = base_mhz * 1e6;
+        tsc.source = TscSource::Leaf16;
+    }
+    HypervisorInfo hypervisor(hypervisor_info(snapshot));
+    if (hypervisor.tsc_hz != 0) {
+        tsc.hz = hypervisor.tsc_hz;
+        tsc.source = TscSource::Hypervisor;
+    }
+
+    return tsc;
+}
+
+double calibrate_tsc_hz(double ms)
+{
+    ClockPair start(read_pair());
+    while (monotonic_ns() - start.ns < ms * 1e6)
+        continue;
+    ClockPair end(read_pair());
+
+    return static_cast<double>(end.tsc - start.tsc) / (end.ns - start.ns) *
+        1e9;
+}
+
+double tsc_hz(const CpuInfo &info)
+{
+    TscInfo tsc(tsc_info(info));
+
+    return tsc.hz != 0 ? tsc.hz : calibrate_tsc_hz();
+}
+
+std::vector<TimerCost> measure_timer_costs(
+    const TscClock &clock, bool rdtscp, double ms)
+{
+    std::vector<TimerCost> costs;
+    TimerCost cost = {"rdtsc", read_cost<ReadRdtsc>(clock, ms)};
+    costs.push_back(cost);
+    cost.name = "lfence; rdtsc";
+    cost.ns = read_cost<ReadOrdered>(clock, ms);
+    costs.push_back(cost);
+    if (rdtscp) {
+        cost.name = "rdtscp; lfence";
+        cost.ns = read_cost<ReadRdtscp>(clock, ms);
+        costs.push_back(cost);
+    }
+    cost.name = "TscClock::now_ns";
+    cost.ns = read_cost<ReadTscClock>(clock, ms);
+    costs.push_back(cost);
+#if defined(__linux__)
+    cost.name = "clock_gettime";
+    cost.ns = read_cost<ReadClockGettime>(clock, ms);
+    costs.push_back(cost);
+#endif
+    cost.name = "steady_clock::now";
+    cost.ns = read_cost<ReadSteadyClock>(clock, ms);
+    costs.push_back(cost);
+
+    return costs;
+}
+
+} // namespace cpuid_info
@@ -0,0 +1,78 @@
+#ifndef CPUID_INFO_TSC_HPP
+#define CPUID_INFO_TSC_HPP
+
+#include <cpuid_info/cpu_info.hpp>
+#include <cpuid_info/timestamp.hpp>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief Where a TSC frequency comes from
+enum class TscSource {
+    None,         ///< Unknown
+    Leaf15,       ///< Crystal clock and ratio of leaf 0x15
+    Leaf15Model,  ///< Ratio of leaf 0x15, crystal clock known for the model
+    Leaf15Base,   ///< Ratio of leaf 0x15, crystal derived from leaf 0x16
+    Leaf16,       ///< Base frequency of leaf 0x16
+    Hypervisor,   ///< Guest frequency the hypervisor reports
+    Calibrated    ///< Timed against the OS clock
+};
+
+const char *tsc_source_name(TscSource source);
+
+/// \brief Time stamp counter properties of leaves 0x15, 0x16 and 0x80000007
+struct TscInfo {
+    /// \brief Constant rate in every P-, C- and T-state (0x80000007 EDX bit
+    /// 8), required for converting ticks to time
+    bool invariant;
+
+    bool rdtscp;  ///< RDTSCP is supported
+
+    unsigned ratio_numerator;    ///< Leaf 0x15 EBX, zero if not enumerated
+    unsigned ratio_denominator;  ///< Leaf 0x15 EAX
+    unsigned crystal_hz;         ///< Leaf 0x15 ECX or derived, else zero
+
+    double hz;  ///< TSC frequency, zero if CPUID does not tell
+    TscSource source;
+};
+
+/// \brief The TSC frequency as CPUID reports it, without timing anything
+///
+/// \details
+/// Leaf 0x15 gives the TSC to crystal clock ratio. Where it leaves the
+/// crystal frequency out, it is taken from the model (24 MHz on Skylake to
+/// Comet Lake clients, 25 MHz on Denverton, 19.2 MHz on Goldmont), else
+/// derived from the base frequency of leaf 0x16 as Linux
+/// does. Leaf 0x16 alone gives the base frequency, which the TSC runs at
+/// on Intel cores, to within a MHz. Under a hypervisor that reports the
+/// guest's TSC frequency (see hypervisor_info()) that is used instead, as
+/// the host's leaves do not account for TSC scaling.
+TscInfo tsc_info(const CpuInfo &info);
+
+/// \brief Measure the TSC frequency against the monotonic clock
+///
+/// \details
+/// Busy waits for `ms` milliseconds instead of sleeping. Each end of the
+/// window pairs the TSC with the clock reading that took the fewest ticks
+/// of several attempts, so an interrupted read does not skew the result.
+/// The raw monotonic clock is used on Linux, which NTP does not slew.
+double calibrate_tsc_hz(double ms = 10);
+
+/// \brief `tsc_info().hz`, else a calibrated frequency
+double tsc_hz(const CpuInfo &info);
+
+/// \brief Cost of reading one time source
+struct TimerCost {
+    const char *name;
+    double ns;  ///< Per read, back to back on the calling thread
+};
+
+/// \brief Time the rdtsc variants, `TscClock::now_ns()`, clock_gettime and
+/// std::chrono::steady_clock
+std::vector<TimerCost> measure_timer_costs(
+    const TscClock &clock, bool rdtscp, double ms = 20);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_TSC_HPP
@@ -0,0 +1,217 @@
+#include <cpuid_info/uarch.hpp>
+#include <cstddef>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+const unsigned any = 0xF;
+
+// Display family and model as in the vendors' revision guides and the SDM
+// model tables, first match wins
+const Microarch microarch_table[] = {
+    // Intel big cores
+    {Vendor::Intel, 0x6, 0x3C, 0x3C, 0, any, "Haswell", "haswell", 256,
+        {false, 0, RepMovsb::Large, false}},
+    {Vendor::Intel, 0x6, 0x3F, 0x3F, 0, any, "Haswell-EP", "haswell", 256,
+        {false, 0, RepMovsb::Large, false}},
+    {Vendor::Intel, 0x6, 0x45, 0x46, 0, any, "Haswell", "haswell", 256,
+        {false, 0, RepMovsb::Large, false}},
+    {Vendor::Intel, 0x6, 0x3D, 0x3D, 0, any, "Broadwell", "broadwell", 256,
+        {false, 0, RepMovsb::Large, false}},
+    {Vendor::Intel, 0x6, 0x47, 0x47, 0, any, "Broadwell", "broadwell", 256,
+        {false, 0, RepMovsb::Large, false}},
+    {Vendor::Intel, 0x6, 0x4F, 0x4F, 0, any, "Broadwell-EP", "broadwell", 256,
+        {false, 0, RepMovsb::Large, false}},
+    {Vendor::Intel, 0x6, 0x56, 0x56, 0, any, "Broadwell-DE", "broadwell", 256,
+        {false, 0, RepMovsb::Large, false}},
+    {Vendor::Intel, 0x6, 0x4E, 0x4E, 0, any, "Skylake", "skylake", 256,
+        {false, 0, RepMovsb::Large, false}},
+    {Vendor::Intel, 0x6, 0x5E, 0x5E, 0, any, "Skylake", "skylake", 256,
+        {false, 0, RepMovsb::Large, false}},
+    {Vendor::Intel, 0x6, 0x8E, 0x8E, 0, any, "Kaby Lake", "skylake", 256,
+        {false, 0, RepMovsb::Large, false}},
+    {Vendor::Intel, 0x6, 0x9E, 0x9E, 0, any, "Coffee Lake", "skylake", 256,
+        {false, 0, RepMovsb::Large, false}},
+    {Vendor::Intel, 0x6, 0xA5, 0xA6, 0, any, "Comet Lake", "skylake", 256,
+        {false, 0, RepMovsb::Large, false}},
+    {Vendor::Intel, 0x6, 0x55, 0x55, 0, 4, "Skylake-SP", "skylake-avx512", 256,
+        {false, 2, RepMovsb::Large, false}},
+    {Vendor::Intel, 0x6, 0x55, 0x55, 5, 7, "Cascade Lake", "cascadelake", 256,
+        {false, 2, RepMovsb::Large, false}},
+    {Vendor::Intel, 0x6, 0x55, 0x55, 10, 11, "Cooper Lake", "cooperlake", 256,
+        {false, 2, RepMovsb::Large, false}},
+    {Vendor::Intel, 0x6, 0x66, 0x66, 0, any, "Cannon Lake", "cannonlake", 256,
+        {false, 1, RepMovsb::Large, false}},
+    {Vendor::Intel, 0x6, 0x6A, 0x6A, 0, any, "Ice Lake-SP",
+        "icelake-server", 256, {false, 2, RepMovsb::Fast, true}},
+    {Vendor::Intel, 0x6, 0x6C, 0x6C, 0, any, "Ice Lake-D",
+        "icelake-server", 256, {false, 2, RepMovsb::Fast, true}},
+    {Vendor::Intel, 0x6, 0x7D, 0x7E, 0, any, "Ice Lake", "icelake-client", 256,
+        {false, 1, RepMovsb::Fast, true}},
+    {Vendor::Intel, 0x6, 0x8C, 0x8D, 0, any, "Tiger Lake", "tigerlake", 256,
+        {false, 1, RepMovsb::Fast, true}},
+    {Vendor::Intel, 0x6, 0xA7, 0xA7, 0, any, "Rocket Lake", "rocketlake", 256,
+        {false, 1, RepMovsb::Fast, true}},
+    {Vendor::Intel, 0x6, 0x8F, 0x8F, 0, any, "Sapphire Rapids",
+        "sapphirerapids", 512, {false, 2, RepMovsb::Fast, true}},
+    {Vendor::Intel, 0x6, 0xCF, 0xCF, 0, any, "Emerald Rapids",
+        "emeraldrapids", 512, {false, 2, RepMovsb::Fast, true}},
+    {Vendor::Intel, 0x6, 0xAD, 0xAE, 0, any, "Granite Rapids",
+        "graniterapids", 512, {false, 2, RepMovsb::Fast, true}},
+    {Vendor::Intel, 0x6, 0x97, 0x97, 0, any, "Alder Lake", "alderlake", 256,
+        {false, 0, RepMovsb::Fast, true}},
+    {Vendor::Intel, 0x6, 0x9A, 0x9A, 0, any, "Alder Lake", "alderlake", 256,
+        {false, 0, RepMovsb::Fast, true}},
+    {Vendor::Intel, 0x6, 0xB7, 0xB7, 0, any, "Raptor Lake", "raptorlake", 256,
+        {false, 0, RepMovsb::Fast, true}},
+    {Vendor::Intel, 0x6, 0xBA, 0xBA, 0, any, "Raptor Lake", "raptorlake", 256,
+        {false, 0, RepMovsb::Fast, true}},
+    {Vendor::Intel, 0x6, 0xBF, 0xBF, 0, any, "Raptor Lake", "raptorlake", 256,
+        {false, 0, RepMovsb::Fast, true}},
+    {Vendor::Intel, 0x6, 0xAA, 0xAC, 0, any, "Meteor Lake", "meteorlake", 256,
+        {false, 0, RepMovsb::Fast, true}},
+    {Vendor::Intel, 0x6, 0xBD, 0xBD, 0, any, "Lunar Lake", "lunarlake", 256,
+        {false, 0, RepMovsb::Fast, true}},
+    {Vendor::Intel, 0x6, 0xC5, 0xC6, 0, any, "Arrow Lake", "arrowlake", 256,
+        {false, 0, RepMovsb::Fast, true}},
+
+    // Intel Atom cores
+    {Vendor::Intel, 0x6, 0x5C, 0x5C, 0, any, "Goldmont", "goldmont", 128,
+        {false, 0, RepMovsb::Large, false}},
+    {Vendor::Intel, 0x6, 0x5F, 0x5F, 0, any, "Goldmont", "goldmont", 128,
+        {false, 0, RepMovsb::Large, false}},
+    {Vendor::Intel, 0x6, 0x7A, 0x7A, 0, any, "Goldmont Plus",
+        "goldmont-plus", 128, {false, 0, RepMovsb::Large, false}},
+    {Vendor::Intel, 0x6, 0x86, 0x86, 0, any, "Tremont", "tremont", 128,
+        {false, 0, RepMovsb::Large, true}},
+    {Vendor::Intel, 0x6, 0x96, 0x96, 0, any, "Tremont", "tremont", 128,
+        {false, 0, RepMovsb::Large, true}},
+    {Vendor::Intel, 0x6, 0x9C, 0x9C, 0, any, "Tremont", "tremont", 128,
+        {false, 0, RepMovsb::Large, true}},
+    {Vendor::Intel, 0x6, 0xAF, 0xAF, 0, any, "Sierra Forest",
+        "sierraforest", 256, {false, 0, RepMovsb::Fast, true}},
+    {Vendor::Intel, 0x6, 0xB6, 0xB6, 0, any, "Grand Ridge", "grandridge", 256,
+        {false, 0, RepMovsb::Fast, true}},
+
+    // AMD
+    {Vendor::AMD, 0x15, 0x00, 0x01, 0, any, "Bulldozer", "bdver1", 128,
+        {true, 0, RepMovsb::Slow, false}},
+    {Vendor::AMD, 0x15, 0x02, 0x02, 0, any, "Piledriver", "bdver2", 128,
+        {true, 0, RepMovsb::Slow, false}},
+    {Vendor::AMD, 0x15, 0x10, 0x1F, 0, any, "Piledriver", "bdver2", 128,
+        {true, 0, RepMovsb::Slow, false}},
+    {Vendor::AMD, 0x15, 0x30, 0x3F, 0, any, "Steamroller", "bdver3", 128,
+        {true, 0, RepMovsb::Slow, false}},
+    {Vendor::AMD, 0x15, 0x60, 0x7F, 0, any, "Excavator", "bdver4", 128,
+        {true, 0, RepMovsb::Slow, false}},
+    {Vendor::AMD, 0x16, 0x30, 0x3F, 0, any, "Jaguar", "btver2", 128,
+        {true, 0, RepMovsb::Slow, false}},
+    {Vendor::AMD, 0x17, 0x01, 0x01, 0, any, "Zen", "znver1", 128,
+        {true, 0, RepMovsb::Slow, false}},
+    {Vendor::AMD, 0x17, 0x08, 0x08, 0, any, "Zen+", "znver1", 128,
+        {true, 0, RepMovsb::Slow, false}},
+    {Vendor::AMD, 0x17, 0x11, 0x11, 0, any, "Zen", "znver1", 128,
+        {true, 0, RepMovsb::Slow, false}},
+    {Vendor::AMD, 0x17, 0x18, 0x18, 0, any, "Zen+", "znver1", 128,
+        {true, 0, RepMovsb::Slow, false}},
+    {Vendor::AMD, 0x17, 0x20, 0x20, 0, any, "Zen", "znver1", 128,
+        {true, 0, RepMovsb::Slow, false}},
+    {Vendor::AMD, 0x17, 0x31, 0x31, 0, any, "Zen 2", "znver2", 256,
+        {true, 0, RepMovsb::Slow, false}},
+    {Vendor::AMD, 0x17, 0x47, 0x47, 0, any, "Zen 2", "znver2", 256,
+        {true, 0, RepMovsb::Slow, false}},
+    {Vendor::AMD, 0x17, 0x60, 0x60, 0, any, "Zen 2", "znver2", 256,
+        {true, 0, RepMovsb::Slow, false}},
+    {Vendor::AMD, 0x17, 0x68, 0x68, 0, any, "Zen 2", "znver2", 256,
+        {true, 0, RepMovsb::Slow, false}},
+    {Vendor::AMD, 0x17, 0x71, 0x71, 0, any, "Zen 2", "znver2", 256,
+        {true, 0, RepMovsb::Slow, false}},
+    {Vendor::AMD, 0x17, 0x90, 0x90, 0, any, "Zen 2", "znver2", 256,
+        {true, 0, RepMovsb::Slow, false}},
+    {Vendor::AMD, 0x17, 0xA0, 0xA0, 0, any, "Zen 2", "znver2", 256,
+        {true, 0, RepMovsb::Slow, false}},
+    {Vendor::AMD, 0x19, 0x00, 0x0F, 0, any, "Zen 3", "znver3", 256,
+        {false, 0, RepMovsb::Large, false}},
+    {Vendor::AMD, 0x19, 0x10, 0x1F, 0, any, "Zen 4", "znver4", 512,
+        {false, 1, RepMovsb::Large, false}},
+    {Vendor::AMD, 0x19, 0x20, 0x5F, 0, any, "Zen 3", "znver3", 256,
+        {false, 0, RepMovsb::Large, false}},
+    {Vendor::AMD, 0x19, 0x60, 0x7F, 0, any, "Zen 4", "znver4", 512,
+        {false, 1, RepMovsb::Large, false}},
+    {Vendor::AMD, 0x19, 0xA0, 0xAF, 0, any, "Zen 4c", "znver4", 512,
+        {false, 1, RepMovsb::Large, false}},
+    {Vendor::AMD, 0x1A, 0x00, 0x7F, 0, any, "Zen 5", "znver5", 512,
+        {false, 2, RepMovsb::Large, false}},
+    {Vendor::Hygon, 0x18, 0x00, 0xFF, 0, any, "Dhyana", "znver1", 128,
+        {true, 0, RepMovsb::Slow, false}},
+};
+
+const std::size_t microarch_count =
+    sizeof(microarch_table) / sizeof(Microarch);
+
+} // namespace
+
+const Microarch *identify_microarch(const CpuInfo &info)
+{
+    if (info.snapshot().max_basic() < 0x01)
+        return nullptr;
+
+    Vendor vendor = info.vendor_id();
+    Signature sig(info.signature());
+    for (std::size_t i = 0; i != microarch_count; ++i) {
+        const Microarch &m = microarch_table[i];
+        if (m.vendor == vendor && m.family == sig.family &&
+            sig.model >= m.model_first && sig.model <= m.model_last &&
+            sig.stepping >= m.stepping_first &&
+            sig.stepping <= m.stepping_last)
+            return &m;
+    }
+
+    return nullptr;
+}
+
+const char *rep_movsb_name(RepMovsb rep)
+{
+    switch (rep) {
+        case RepMovsb::Large:
+            return "Large copies";
+        case RepMovsb::Fast:
+            return "All sizes";
+        default:
+            return "Slow";
+    }
+}
+
+Quirks microarch_quirks(const CpuInfo &info)
+{
+    const Features &features = info.features();
+    const Microarch *m = identify_microarch(info);
+
+    Quirks quirks;
+    if (m != nullptr) {
+        quirks = m->quirks;
+    } else {
+        Vendor vendor = info.vendor_id();
+        bool amd = vendor == Vendor::AMD || vendor == Vendor::Hygon;
+        quirks.slow_pdep_pext = amd && info.signature().family < 0x19;
+        quirks.avx512_fma_ports = 1;
+        quirks.rep_movsb = amd ? RepMovsb::Large : RepMovsb::Fast;
+        quirks.split_lock_detect = false;
+    }
+
+    if (!features.has(Feature::BMI2))
+        quirks.slow_pdep_pext = false;
+    if (!features.has(Feature::AVX512F))
+        quirks.avx512_fma_ports = 0;
+    if (quirks.rep_movsb == RepMovsb::Fast && !features.has(Feature::FSRM))
+        quirks.rep_movsb = RepMovsb::Large;
+    if (quirks.rep_movsb == RepMovsb::Large && !features.has(Feature::ERMS))
+        quirks.rep_movsb = RepMovsb::Slow;
+
+    return quirks;
+}
+
+} // namespace cpuid_info
@@ -0,0 +1,82 @@
+#ifndef CPUID_INFO_UARCH_HPP
+#define CPUID_INFO_UARCH_HPP
+
+#include <cpuid_info/cpu_info.hpp>
+
+namespace cpuid_info
+{
+
+/// \brief How `rep movsb` compares to a vector copy loop
+enum class RepMovsb {
+    /// \brief Slower at every size, use vector loops
+    Slow,
+
+    /// \brief Fastest for large copies only, about 2 KiB and up (ERMS)
+    Large,
+
+    /// \brief Fastest at every size, short copies included (FSRM)
+    Fast
+};
+
+const char *rep_movsb_name(RepMovsb rep);
+
+/// \brief Performance properties that feature flags do not reveal
+struct Quirks {
+    /// \brief PDEP/PEXT are microcoded, with a latency growing with the
+    /// number of set mask bits (AMD before Zen 3)
+    bool slow_pdep_pext;
+
+    /// \brief 512-bit FMA issue ports, zero without AVX-512. One on
+    /// double pumped (Zen 4) and client cores, two on most server cores;
+    /// some Skylake-SP and Cascade Lake SKUs have one only
+    unsigned avx512_fma_ports;
+
+    RepMovsb rep_movsb;
+
+    /// \brief Split locks raise #AC, which Linux reports and throttles.
+    /// Elsewhere they lock the bus, stalling every CPU of the system
+    bool split_lock_detect;
+};
+
+/// \brief A microarchitecture, identified by vendor and display family,
+/// model and stepping ranges
+struct Microarch {
+    Vendor vendor;
+    unsigned family;
+    unsigned model_first;
+    unsigned model_last;
+    unsigned stepping_first;
+    unsigned stepping_last;
+
+    /// \brief Marketing name of the core, e.g. "Skylake-SP"
+    const char *name;
+
+    /// \brief GCC/Clang `-march`/`-mtune` CPU name, e.g. "skylake-avx512"
+    const char *march;
+
+    /// \brief Widest vectors worth using in compiled loops, in bits
+    ///
+    /// \details
+    /// 256 for AVX-512 cores whose 512-bit license lowers the frequency of
+    /// the whole core (and for cores without AVX-512), 512 where full width
+    /// vectors do not reduce the clock.
+    unsigned vector_width;
+
+    Quirks quirks;
+};
+
+/// \brief The table entry matching a CPU, nullptr if it is not known
+const Microarch *identify_microarch(const CpuInfo &info);
+
+/// \brief Quirks of the microarchitecture of a CPU, adjusted to its feature
+/// flags
+///
+/// \details
+/// Features a hypervisor hides disable their quirks, e.g. no AVX-512 ports
+/// without AVX512F and no fast `rep movsb` without FSRM. Unknown CPUs get
+/// the quirks their vendor, family and features imply.
+Quirks microarch_quirks(const CpuInfo &info);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_UARCH_HPP
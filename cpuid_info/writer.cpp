@@ -0,0 +1,248 @@
+#include <cpuid_info/writer.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+// Length of the well-formed UTF-8 sequence at the start of `str` (RFC
+// 3629, no overlong forms, surrogates or code points above U+10FFFF), zero
+// if there is none. Brand strings and hypervisor IDs are not always UTF-8.
+std::size_t utf8_length(const unsigned char *str, std::size_t n)
+{
+    unsigned char c = str[0];
+    if (c < 0x80)
+        return 1;
+
+    // Range of the second byte, narrower after some lead bytes
+    unsigned char lo = 0x80;
+    unsigned char hi = 0xBF;
+    std::size_t len = 0;
+    if (c >= 0xC2 && c <= 0xDF) {
+        len = 2;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        len = 3;
+        if (c == 0xE0)
+            lo = 0xA0;
+        else if (c == 0xED)
+            hi = 0x9F;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        len = 4;
+        if (c == 0xF0)
+            lo = 0x90;
+        else if (c == 0xF4)
+            hi = 0x8F;
+    } else {
+        return 0;
+    }
+    if (n < len || str[1] < lo || str[1] > hi)
+        return 0;
+    for (std::size_t i = 2; i != len; ++i)
+        if (str[i] < 0x80 || str[i] > 0xBF)
+            return 0;
+
+    return len;
+}
+
+} // namespace
+
+void Writer::flush()
+{
+    if (size_ != 0)
+        out_.write(buf_, static_cast<std::streamsize>(size_));
+    size_ = 0;
+}
+
+void Writer::put(const char *str, std::size_t n)
+{
+    for (std::size_t i = 0; i != n; ++i)
+        put(str[i]);
+}
+
+void JsonWriter::separate()
+{
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+    if (depth_ == 0 || depth_ > max_depth)
+        return;
+    if (!first_[depth_ - 1])
+        put(',');
+    first_[depth_ - 1] = false;
+}
+
+void JsonWriter::open(bool object)
+{
+    separate();
+    put(object ? '{' : '[');
+    if (depth_ < max_depth)
+        first_[depth_] = true;
+    ++depth_;
+}
+
+void JsonWriter::close(bool object)
+{
+    put(object ? '}' : ']');
+    if (depth_ != 0 && --depth_ == 0)
+        put('\n');
+}
+
+void JsonWriter::write_key(const char *name, std::size_t n)
+{
+    write_string(name, n);
+    put(':');
+    after_key_ = true;
+}
+
+void JsonWriter::write_bool(bool b)
+{
+    separate();
+    if (b)
+        put("true", 4);
+    else
+        put("false", 5);
+}
+
+void JsonWriter::write_uint(unsigned long long u)
+{
+    separate();
+    char str[24];
+    std::size_t n = 0;
+    do {
+        str[n++] = static_cast<char>('0' + u % 10);
+        u /= 10;
+    } while (u != 0);
+    while (n != 0)
+        put(str[--n]);
+}
+
+void JsonWriter::write_double(double d)
+{
+    separate();
+    if (!std::isfinite(d)) {
+        put("null", 4);
+        return;
+    }
+    char str[32];
+    int n = std::snprintf(str, sizeof(str), "%.6g", d);
+    put(str, static_cast<std::size_t>(n));
+}
+
+void JsonWriter::write_string(const char *str, std::size_t n)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(str);
+    separate();
+    put('"');
+    for (std::size_t i = 0; i != n; ++i) {
+        unsigned char c = bytes[i];
+        std::size_t len = c < 0x80 ? 1 : utf8_length(bytes + i, n - i);
+        if (c == '"' || c == '\\') {
+            put('\\');
+            put(static_cast<char>(c));
+        } else if (c < 0x20 || len == 0) {
+            // Bytes that are not UTF-8 become the Latin-1 code point
+            put("\\u00", 4);
+            put(hex[c >> 4]);
+            put(hex[c & 0xF]);
+        } else {
+            put(str + i, len);
+            i += len - 1;
+        }
+    }
+    put('"');
+}
+
+CborWriter::CborWriter(std::ostream &out) : Writer(out)
+{
+    put("\xD9\xD9\xF7", 3);
+}
+
+void CborWriter::head(unsigned major, unsigned long long arg)
+{
+    char type = static_cast<char>(major << 5);
+    if (arg < 24) {
+        put(static_cast<char>(type | arg));
+        return;
+    }
+
+    // Additional information 24..27 for a 1, 2, 4 or 8 byte argument
+    unsigned bytes = 8;
+    unsigned info = 27;
+    if (arg <= 0xFF) {
+        bytes = 1;
+        info = 24;
+    } else if (arg <= 0xFFFF) {
+        bytes = 2;
+        info = 25;
+    } else if (arg <= 0xFFFFFFFF) {
+        bytes = 4;
+        info = 26;
+    }
+    put(static_cast<char>(type | info));
+    for (unsigned i = bytes; i != 0; --i)
+        put(static_cast<char>((arg >> ((i - 1) * 8)) & 0xFF));
+}
+
+void CborWriter::open(bool object)
+{
+    // Major type 5 (map) or 4 (array) with indefinite length
+    put(object ? '\xBF' : '\x9F');
+}
+
+void CborWriter::close(bool) { put('\xFF'); }
+
+void CborWriter::write_key(const char *name, std::size_t n)
+{
+    write_string(name, n);
+}
+
+void CborWriter::write_bool(bool b) { put(b ? '\xF5' : '\xF4'); }
+
+void CborWriter::write_uint(unsigned long long u) { head(0, u); }
+
+void CborWriter::write_double(double d)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &d, sizeof(bits));
+    put('\xFB');
+    for (unsigned i = 8; i != 0; --i)
+        put(static_cast<char>((bits >> ((i - 1) * 8)) & 0xFF));
+}
+
+void CborWriter::write_string(const char *str, std::size_t n)
+{
+    // Text strings must be UTF-8, other bytes are encoded as the Latin-1
+    // code point, as JsonWriter does
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(str);
+    std::size_t size = 0;
+    for (std::size_t i = 0; i != n;) {
+        std::size_t len = utf8_length(bytes + i, n - i);
+        size += len == 0 ? 2 : len;
+        i += len == 0 ? 1 : len;
+    }
+    head(3, size);
+    if (size == n) {
+        put(str, n);
+        return;
+    }
+    for (std::size_t i = 0; i != n;) {
+        std::size_t len = utf8_length(bytes + i, n - i);
+        if (len == 0) {
+            put(static_cast<char>(0xC0 | bytes[i] >> 6));
+            put(static_cast<char>(0x80 | (bytes[i] & 0x3F)));
+            len = 1;
+        } else {
+            put(str + i, len);
+        }
+        i += len;
+    }
+}
+
+} // namespace cpuid_info
@@ -0,0 +1,136 @@
+#ifndef CPUID_INFO_WRITER_HPP
+#define CPUID_INFO_WRITER_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+namespace cpuid_info
+{
+
+/// \brief Streaming writer of nested objects and arrays
+///
+/// \details
+/// Output goes through a fixed buffer to the stream, and numbers are
+/// formatted into stack buffers, so writing a field never allocates. Keys
+/// are only valid directly inside an object, and every value inside an
+/// object must follow a key. The destructor flushes the buffer. Bytes of
+/// a string that are not well-formed UTF-8 are written as the Latin-1
+/// character of the same value, so the output is always valid.
+class Writer
+{
+    public:
+    explicit Writer(std::ostream &out) : out_(out), size_(0) {}
+
+    virtual ~Writer() { flush(); }
+
+    void begin_object() { open(true); }
+    void end_object() { close(true); }
+    void begin_array() { open(false); }
+    void end_array() { close(false); }
+
+    void key(const char *name) { write_key(name, std::strlen(name)); }
+
+    void value(bool b) { write_bool(b); }
+    void value(unsigned u) { write_uint(u); }
+    void value(unsigned long u) { write_uint(u); }
+    void value(unsigned long long u) { write_uint(u); }
+    void value(double d) { write_double(d); }
+    void value(const char *str) { write_string(str, std::strlen(str)); }
+    void value(const std::string &str) { write_string(str.data(), str.size()); }
+
+    template <typename T>
+    void field(const char *name, const T &v)
+    {
+        key(name);
+        value(v);
+    }
+
+    /// \brief Write the buffered output to the stream
+    void flush();
+
+    protected:
+    virtual void open(bool object) = 0;
+    virtual void close(bool object) = 0;
+    virtual void write_key(const char *name, std::size_t n) = 0;
+    virtual void write_bool(bool b) = 0;
+    virtual void write_uint(unsigned long long u) = 0;
+    virtual void write_double(double d) = 0;
+    virtual void write_string(const char *str, std::size_t n) = 0;
+
+    void put(char c)
+    {
+        if (size_ == sizeof(buf_))
+            flush();
+        buf_[size_++] = c;
+    }
+
+    void put(const char *str, std::size_t n);
+
+    private:
+    Writer(const Writer &);
+    Writer &operator=(const Writer &);
+
+    std::ostream &out_;
+    char buf_[4096];
+    std::size_t size_;
+}; // class Writer
+
+/// \brief Compact single line JSON, terminated by a newline when the
+/// outermost value is closed
+class JsonWriter : public Writer
+{
+    public:
+    explicit JsonWriter(std::ostream &out)
+        : Writer(out), depth_(0), after_key_(false)
+    {
+    }
+
+    protected:
+    void open(bool object);
+    void close(bool object);
+    void write_key(const char *name, std::size_t n);
+    void write_bool(bool b);
+    void write_uint(unsigned long long u);
+    void write_double(double d);
+    void write_string(const char *str, std::size_t n);
+
+    private:
+    static const unsigned max_depth = 32;
+
+    // Separate a value from the previous one, unless it follows a key
+    void separate();
+
+    unsigned depth_;
+    bool first_[max_depth];
+    bool after_key_;
+}; // class JsonWriter
+
+/// \brief CBOR (RFC 8949) with indefinite length maps and arrays
+///
+/// \details
+/// The output starts with the self-described CBOR tag 55799 (bytes D9 D9
+/// F7), which doubles as a file signature. Maps and arrays are written
+/// with indefinite lengths so nothing has to be counted or buffered ahead.
+class CborWriter : public Writer
+{
+    public:
+    explicit CborWriter(std::ostream &out);
+
+    protected:
+    void open(bool object);
+    void close(bool object);
+    void write_key(const char *name, std::size_t n);
+    void write_bool(bool b);
+    void write_uint(unsigned long long u);
+    void write_double(double d);
+    void write_string(const char *str, std::size_t n);
+
+    private:
+    void head(unsigned major, unsigned long long arg);
+}; // class CborWriter
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_WRITER_HPP
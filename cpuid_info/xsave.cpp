@@ -0,0 +1,130 @@
+#include <cpuid_info/xsave.hpp>
+#include <cstddef>
+
+namespace cpuid_info
+{
+
+namespace
+{
+
+const char *component_names[] = {"x87", "SSE", "AVX", "MPX BNDREGS",
+    "MPX BNDCSR", "AVX-512 opmask", "ZMM_Hi256", "Hi16_ZMM", "PT", "PKRU",
+    "PASID", "CET_U", "CET_S", "HDC", "UINTR", "LBR", "HWP", "AMX TILECFG",
+    "AMX TILEDATA", "APX"};
+
+const unsigned component_name_count =
+    sizeof(component_names) / sizeof(const char *);
+
+// The state components each feature needs
+struct StateFeature {
+    Feature feature;
+    std::uint64_t state;
+};
+
+const StateFeature state_table[] = {
+    {Feature::FMA, xstate_avx},
+    {Feature::AVX, xstate_avx},
+    {Feature::F16C, xstate_avx},
+    {Feature::AVX2, xstate_avx},
+    {Feature::MPX, xstate_mpx},
+    {Feature::AVX512F, xstate_avx512},
+    {Feature::AVX512DQ, xstate_avx512},
+    {Feature::AVX512IFMA52, xstate_avx512},
+    {Feature::AVX512PF, xstate_avx512},
+    {Feature::AVX512ER, xstate_avx512},
+    {Feature::AVX512CD, xstate_avx512},
+    {Feature::AVX512BW, xstate_avx512},
+    {Feature::AVX512VL, xstate_avx512},
+    {Feature::AVX512VBMI, xstate_avx512},
+    {Feature::AVX512VBMI2, xstate_avx512},
+    {Feature::VAES, xstate_avx},
+    {Feature::VPCLMULQDQ, xstate_avx},
+    {Feature::AVX512VNNI, xstate_avx512},
+    {Feature::AVX512BITALG, xstate_avx512},
+    {Feature::AVX512VPOPCNTDQ, xstate_avx512},
+    {Feature::AVX512VP2INTERSECT, xstate_avx512},
+    {Feature::AMX_BF16, xstate_amx},
+    {Feature::AVX512FP16, xstate_avx512},
+    {Feature::AMX_TILE, xstate_amx},
+    {Feature::AMX_INT8, xstate_amx},
+    {Feature::AVX_VNNI, xstate_avx},
+    {Feature::AVX512BF16, xstate_avx512},
+    {Feature::AMX_FP16, xstate_amx},
+    {Feature::AVX_IFMA, xstate_avx},
+    {Feature::AVX_VNNI_INT8, xstate_avx},
+    {Feature::AVX_NE_CONVERT, xstate_avx},
+    {Feature::AMX_COMPLEX, xstate_amx},
+    {Feature::AVX_VNNI_INT16, xstate_avx},
+    {Feature::AVX10, xstate_avx512},
+};
+
+const std::size_t state_feature_count =
+    sizeof(state_table) / sizeof(StateFeature);
+
+} // namespace
+
+std::uint64_t os_xcr0()
+{
+    if (!test_bit(cpuid(0x01, 0x00).ecx, 27))
+        return 0x3;
+
+    return xgetbv(0);
+}
+
+const char *xsave_component_name(unsigned index)
+{
+    return index < component_name_count ? component_names[index]
+                                        : "Unknown";
+}
+
+XsaveInfo xsave_info(const Snapshot &snapshot)
+{
+    XsaveInfo info = XsaveInfo();
+    if (snapshot.max_basic() < 0x0D ||
+        !test_bit(snapshot.get(0x01).ecx, 26))
+        return info;
+
+    Register reg(snapshot.get(0x0D, 0x00));
+    info.user_mask = (static_cast<std::uint64_t>(reg.edx) << 32) | reg.eax;
+    info.enabled_size = reg.ebx;
+    info.max_size = reg.ecx;
+
+    Register sub1(snapshot.get(0x0D, 0x01));
+    info.xsaveopt = test_bit(sub1.eax, 0);
+    info.xsavec = test_bit(sub1.eax, 1);
+    info.xgetbv1 = test_bit(sub1.eax, 2);
+    info.xsaves = test_bit(sub1.eax, 3);
+    info.xfd = test_bit(sub1.eax, 4);
+    info.compacted_size = sub1.ebx;
+    info.supervisor_mask =
+        (static_cast<std::uint64_t>(sub1.edx) << 32) | sub1.ecx;
+
+    std::uint64_t all = info.user_mask | info.supervisor_mask;
+    for (unsigned i = 2; i != 63; ++i) {
+        if (((all >> i) & 1) == 0)
+            continue;
+        Register comp(snapshot.get(0x0D, i));
+        XsaveComponent component;
+        component.index = i;
+        component.size = comp.eax;
+        component.offset = comp.ebx;
+        component.supervisor = test_bit(comp.ecx, 0);
+        component.aligned = test_bit(comp.ecx, 1);
+        component.xfd = test_bit(comp.ecx, 2);
+        info.components.push_back(component);
+    }
+
+    return info;
+}
+
+Features usable_features(const Features &present, std::uint64_t xcr0)
+{
+    Features usable(present);
+    for (std::size_t i = 0; i != state_feature_count; ++i)
+        if ((xcr0 & state_table[i].state) != state_table[i].state)
+            usable.set(state_table[i].feature, false);
+
+    return usable;
+}
+
+} // namespace cpuid_info
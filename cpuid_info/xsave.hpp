@@ -0,0 +1,93 @@
+#ifndef CPUID_INFO_XSAVE_HPP
+#define CPUID_INFO_XSAVE_HPP
+
+#include <cpuid_info/feature.hpp>
+#include <cpuid_info/snapshot.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace cpuid_info
+{
+
+/// \brief Execute XGETBV on the calling thread's CPU
+///
+/// \details
+/// Raises #UD unless the OS has set CR4.OSXSAVE (leaf 0x01 ECX bit 27).
+/// Register 0 is XCR0, the user state components the OS saves and
+/// restores; register 1 (with XGETBV1) masks it with the components in use.
+inline std::uint64_t xgetbv(unsigned index)
+{
+    unsigned lo = 0;
+    unsigned hi = 0;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(index));
+
+    return (static_cast<std::uint64_t>(hi) << 32) | lo;
+}
+
+/// \brief XCR0 of the calling thread's CPU, x87 and SSE only (0x3) if the
+/// OS has not enabled XSAVE
+std::uint64_t os_xcr0();
+
+/// \brief XCR0 bits of the state components the instructions use
+const std::uint64_t xstate_sse = 0x2;
+const std::uint64_t xstate_avx = 0x6;
+const std::uint64_t xstate_mpx = 0x18;
+const std::uint64_t xstate_avx512 = 0xE6;
+const std::uint64_t xstate_amx = 0x60000;
+
+/// \brief Name of an XSAVE state component, e.g. "ZMM_Hi256"
+const char *xsave_component_name(unsigned index);
+
+/// \brief One state component of leaf 0x0D subleaf 2 and up
+struct XsaveComponent {
+    unsigned index;   ///< Bit in XCR0 or IA32_XSS
+    unsigned size;    ///< Bytes
+    unsigned offset;  ///< In the standard format, zero for supervisor state
+    bool supervisor;  ///< Enabled in IA32_XSS rather than XCR0
+    bool aligned;     ///< 64-byte aligned in the compacted format
+    bool xfd;         ///< Supports extended feature disable
+};
+
+/// \brief The XSAVE features and state layout of leaf 0x0D
+struct XsaveInfo {
+    std::uint64_t user_mask;        ///< XCR0 bits the CPU supports
+    std::uint64_t supervisor_mask;  ///< IA32_XSS bits the CPU supports
+
+    /// \brief Standard format size for the XCR0 set when the leaf was read
+    unsigned enabled_size;
+
+    /// \brief Standard format size with every user component
+    unsigned max_size;
+
+    /// \brief Compacted (XSAVES) size for XCR0 and IA32_XSS when the leaf
+    /// was read, the state the kernel saves on a context switch
+    unsigned compacted_size;
+
+    bool xsaveopt;
+    bool xsavec;
+    bool xgetbv1;
+    bool xsaves;
+    bool xfd;
+
+    /// \brief Components 2 and up, x87 and SSE share the 512-byte legacy
+    /// area
+    std::vector<XsaveComponent> components;
+
+    bool empty() const { return user_mask == 0; }
+};
+
+/// \brief Decode leaf 0x0D, empty without XSAVE
+XsaveInfo xsave_info(const Snapshot &snapshot);
+
+/// \brief The features whose register state `xcr0` enables
+///
+/// \details
+/// CPUID reports what the CPU implements, but an instruction of a feature
+/// raises #UD unless the OS (or hypervisor) saves its registers: the AVX
+/// family needs the SSE and AVX bits, AVX-512 the opmask and ZMM bits too,
+/// AMX the tile bits and MPX the bound registers. Other features are kept.
+Features usable_features(const Features &present, std::uint64_t xcr0);
+
+} // namespace cpuid_info
+
+#endif // CPUID_INFO_XSAVE_HPP
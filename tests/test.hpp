@@ -0,0 +1,103 @@
+#ifndef CPUID_INFO_TEST_HPP
+#define CPUID_INFO_TEST_HPP
+
+#include <cpuid_info/dump.hpp>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace cpuid_info
+{
+
+namespace test
+{
+
+/// \brief Number of failed checks so far
+inline unsigned &failures()
+{
+    static unsigned count = 0;
+    return count;
+}
+
+inline bool check(bool ok, const char *expr, const char *file, int line)
+{
+    if (!ok) {
+        std::cerr << file << ":" << line << ": check failed: " << expr
+                  << std::endl;
+        ++failures();
+    }
+
+    return ok;
+}
+
+template <typename A, typename B>
+bool check_equal(const A &a, const B &b, const char *expr_a,
+    const char *expr_b, const char *file, int line)
+{
+    if (a == b)
+        return true;
+    std::cerr << file << ":" << line << ": check failed: " << expr_a
+              << " == " << expr_b << " (" << a << " != " << b << ")"
+              << std::endl;
+    ++failures();
+
+    return false;
+}
+
+/// \brief Path of a file under tests/data
+inline std::string data_path(const std::string &name)
+{
+    return std::string(CPUID_INFO_TEST_DATA) + "/" + name;
+}
+
+/// \brief The snapshots of a `cpuid -r` dump under tests/data, a failed
+/// check if it cannot be read
+inline std::vector<Snapshot> load_fixture(const std::string &name)
+{
+    std::vector<Snapshot> snapshots;
+    if (!load_dump(data_path(name), snapshots)) {
+        std::cerr << "cannot read " << data_path(name) << std::endl;
+        ++failures();
+        snapshots.push_back(Snapshot());
+    }
+
+    return snapshots;
+}
+
+/// \brief Whether two snapshots hold the same leaves and registers
+inline bool same_leaves(const Snapshot &a, const Snapshot &b)
+{
+    const std::vector<Leaf> &x = a.leaves();
+    const std::vector<Leaf> &y = b.leaves();
+    if (x.size() != y.size())
+        return false;
+    for (std::size_t i = 0; i != x.size(); ++i) {
+        if (x[i].eax != y[i].eax || x[i].ecx != y[i].ecx ||
+            x[i].reg.eax != y[i].reg.eax || x[i].reg.ebx != y[i].reg.ebx ||
+            x[i].reg.ecx != y[i].reg.ecx || x[i].reg.edx != y[i].reg.edx)
+            return false;
+    }
+
+    return true;
+}
+
+/// \brief Exit code of the test program
+inline int result()
+{
+    if (failures() != 0)
+        std::cerr << failures() << " checks failed" << std::endl;
+
+    return failures() == 0 ? 0 : 1;
+}
+
+} // namespace test
+
+} // namespace cpuid_info
+
+#define CHECK(expr) ::cpuid_info::test::check((expr), #expr, __FILE__, __LINE__)
+
+#define CHECK_EQUAL(a, b)                                                      \
+    ::cpuid_info::test::check_equal((a), (b), #a, #b, __FILE__, __LINE__)
+
+#endif // CPUID_INFO_TEST_HPP
@@ -0,0 +1,77 @@
+#include "test.hpp"
+#include <cpuid_info/cache_param.hpp>
+#include <cpuid_info/cpu_info.hpp>
+
+using namespace cpuid_info;
+
+namespace
+{
+
+// A Zen 4 without TOPOEXT, the caches are only in 0x80000005/0x80000006
+Snapshot without_topoext(const Snapshot &snapshot)
+{
+    Snapshot result;
+    const std::vector<Leaf> &leaves = snapshot.leaves();
+    for (std::size_t i = 0; i != leaves.size(); ++i)
+        if (leaves[i].eax != 0x8000001D)
+            result.insert(leaves[i].eax, leaves[i].ecx, leaves[i].reg);
+    Register reg(result.get(0x80000001));
+    reg.ecx &= ~(1U << 22);
+    result.insert(0x80000001, 0x00, reg);
+
+    return result;
+}
+
+void test_legacy_matches_topoext()
+{
+    Snapshot zen4(test::load_fixture("epyc_zen4.txt")[0]);
+    CpuInfo info(zen4);
+    const std::vector<CacheParam> &topoext = info.caches();
+    std::vector<CacheParam> legacy(legacy_amd_caches(zen4));
+    if (!CHECK_EQUAL(topoext.size(), 4u) ||
+        !CHECK_EQUAL(legacy.size(), topoext.size()))
+        return;
+
+    // The L3 associativity code 0x9 defers to leaf 0x8000001D
+    for (std::size_t i = 0; i != legacy.size(); ++i) {
+        CHECK_EQUAL(legacy[i].type(), topoext[i].type());
+        CHECK_EQUAL(legacy[i].level(), topoext[i].level());
+        CHECK_EQUAL(legacy[i].size(), topoext[i].size());
+        CHECK_EQUAL(legacy[i].ways(), topoext[i].ways());
+        CHECK_EQUAL(legacy[i].sets(), topoext[i].sets());
+        CHECK_EQUAL(legacy[i].line_size(), topoext[i].line_size());
+    }
+}
+
+void test_legacy_unknown_ways()
+{
+    CpuInfo info(without_topoext(test::load_fixture("epyc_zen4.txt")[0]));
+    const std::vector<CacheParam> &caches = info.caches();
+    if (!CHECK_EQUAL(caches.size(), 4u))
+        return;
+
+    CHECK_EQUAL(caches[0].size(), 32u * 1024);
+    CHECK_EQUAL(caches[0].ways(), 8u);
+    CHECK_EQUAL(caches[2].level(), 2u);
+    CHECK_EQUAL(caches[2].size(), 1024u * 1024);
+    CHECK_EQUAL(caches[2].ways(), 8u);
+
+    // The L3 keeps its level and size without the leaf its ways are in
+    CHECK_EQUAL(caches[3].level(), 3u);
+    CHECK_EQUAL(caches[3].type(), "Unified");
+    CHECK_EQUAL(caches[3].size(), 32u * 1024 * 1024);
+    CHECK_EQUAL(caches[3].ways(), 0u);
+    CHECK_EQUAL(caches[3].sets(), 0u);
+    CHECK_EQUAL(caches[3].line_size(), 64u);
+    CHECK_EQUAL(caches[3].max_proc_sharing(), 2u);
+}
+
+} // namespace
+
+int main()
+{
+    test_legacy_matches_topoext();
+    test_legacy_unknown_ways();
+
+    return test::result();
+}
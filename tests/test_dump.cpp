@@ -0,0 +1,113 @@
+#include "test.hpp"
+#include <cpuid_info/dump.hpp>
+#include <cstring>
+#include <sstream>
+
+using namespace cpuid_info;
+
+namespace
+{
+
+const char *const fixtures[] = {"epyc_zen4.txt", "sapphire_rapids_kvm.txt",
+    "skylake_sp.txt", "xen_hvm.txt"};
+const unsigned fixture_count = sizeof(fixtures) / sizeof(fixtures[0]);
+
+std::vector<Snapshot> parse(const char *text)
+{
+    std::vector<Snapshot> snapshots;
+    parse_dump(text, std::strlen(text), snapshots);
+
+    return snapshots;
+}
+
+void test_round_trip()
+{
+    for (unsigned i = 0; i != fixture_count; ++i) {
+        std::vector<Snapshot> cpus = test::load_fixture(fixtures[i]);
+        std::stringstream dump;
+        write_dump(dump, cpus);
+        std::vector<Snapshot> copy;
+        if (!CHECK(read_dump(dump, copy)) ||
+            !CHECK_EQUAL(copy.size(), cpus.size()))
+            continue;
+        for (std::size_t j = 0; j != cpus.size(); ++j)
+            CHECK(test::same_leaves(copy[j], cpus[j]));
+    }
+}
+
+void test_fixtures_complete()
+{
+    // Capturing a fixture again reads no leaf it lacks and finds all of them
+    for (unsigned i = 0; i != fixture_count; ++i) {
+        std::vector<Snapshot> cpus = test::load_fixture(fixtures[i]);
+        for (std::size_t j = 0; j != cpus.size(); ++j) {
+            Snapshot again(Snapshot::capture(MockSource(cpus[j])));
+            if (!CHECK(test::same_leaves(again, cpus[j])))
+                std::cerr << fixtures[i] << " CPU " << j << std::endl;
+        }
+    }
+}
+
+void test_cpuid_r_format()
+{
+    // Banner, tabs, upper case hex, CRLF and a missing final newline
+    std::vector<Snapshot> cpus = parse(
+        "cpuid -r\r\n"
+        "CPU 0:\r\n"
+        "   0x00000000 0x00: eax=0x00000016 ebx=0x756e6547 "
+        "ecx=0x6c65746e edx=0x49656e69\r\n"
+        "\t0x00000007 0x00: eax=0x00000000 ebx=0xD19FFFFB "
+        "ecx=0x00000018 edx=0x9C000000\r\n"
+        "CPU 1:\n"
+        "   0x80000000 0x00:  eax=0x80000008  ebx=0x00000000 "
+        "ecx=0x00000000 edx=0x00000000");
+    if (!CHECK_EQUAL(cpus.size(), 2u))
+        return;
+    CHECK_EQUAL(cpus[0].leaves().size(), 2u);
+    CHECK_EQUAL(cpus[0].max_basic(), 0x16u);
+    CHECK_EQUAL(cpus[0].get(0x07).ebx, 0xd19ffffbu);
+    CHECK_EQUAL(cpus[0].get(0x07).edx, 0x9c000000u);
+    CHECK_EQUAL(cpus[1].max_extended(), 0x80000008u);
+}
+
+void test_cpuid_r_headers()
+{
+    // `cpuid -1 -r` writes "CPU:", leaves before any "CPU n:" header form
+    // one snapshot, headers without leaves are dropped and so are lines
+    // that are not a whole leaf
+    std::vector<Snapshot> cpus = parse(
+        "CPU:\n"
+        "   0x00000000 0x00: eax=0x0000000d ebx=0 ecx=0 edx=0\n"
+        "   0x00000000 0x00: eax=0x0000000d ebx=0x756e6547 "
+        "ecx=0x6c65746e edx=0x49656e69\n"
+        "CPU 1:\n"
+        "CPU 2:\n"
+        "   0x00000001 0x00: eax=0x00050657 ebx=0x00000800 "
+        "ecx=0xfffa3203 edx=0x178bfbff\n");
+    if (!CHECK_EQUAL(cpus.size(), 2u))
+        return;
+    CHECK_EQUAL(cpus[0].leaves().size(), 1u);
+    CHECK_EQUAL(cpus[0].get(0x00).ebx, 0x756e6547u);
+    CHECK_EQUAL(cpus[1].get(0x01).eax, 0x00050657u);
+}
+
+void test_not_a_dump()
+{
+    std::vector<Snapshot> cpus;
+    const char text[] = "CPU 0:\n   0x00000001 0x00: eax=0x00050657\n";
+    CHECK(!parse_dump(text, sizeof(text) - 1, cpus));
+    CHECK(cpus.empty());
+}
+
+} // namespace
+
+int main()
+{
+    test_round_trip();
+    test_fixtures_complete();
+    test_cpuid_r_format();
+    test_cpuid_r_headers();
+    test_not_a_dump();
+
+    return test::result();
+}
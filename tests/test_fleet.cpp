@@ -0,0 +1,114 @@
+#include "test.hpp"
+#include <cpuid_info/fleet.hpp>
+#include <cstdio>
+#include <fstream>
+
+using namespace cpuid_info;
+
+namespace
+{
+
+void test_canonical_snapshot()
+{
+    // SMT siblings differ only in their APIC, core and x2APIC IDs
+    std::vector<Snapshot> cpus = test::load_fixture("epyc_zen4.txt");
+    if (!CHECK_EQUAL(cpus.size(), 2u))
+        return;
+    CHECK(!test::same_leaves(cpus[0], cpus[1]));
+
+    Snapshot a(canonical_snapshot(cpus[0]));
+    Snapshot b(canonical_snapshot(cpus[1]));
+    CHECK(test::same_leaves(a, b));
+    CHECK(cpus[1].get(0x80000026).edx != 0);
+    CHECK_EQUAL(b.get(0x80000026).edx, 0u);
+}
+
+bool copy_file(const std::string &from, const std::string &to)
+{
+    std::ifstream in(from.c_str(), std::ios::binary);
+    std::ofstream out(to.c_str(), std::ios::binary);
+    out << in.rdbuf();
+
+    return in && out;
+}
+
+void test_ingest_fleet()
+{
+    // Two hosts of the same type make one group
+    std::vector<std::string> paths;
+    paths.push_back("test_fleet_host1.txt");
+    paths.push_back("test_fleet_host2.txt");
+    for (std::size_t i = 0; i != paths.size(); ++i)
+        CHECK(copy_file(test::data_path("epyc_zen4.txt"), paths[i]));
+
+    FleetSummary fleet = ingest_fleet(paths, 2);
+    CHECK_EQUAL(fleet.files, 2u);
+    CHECK_EQUAL(fleet.hosts, 2u);
+    CHECK_EQUAL(fleet.failed, 0u);
+    if (CHECK_EQUAL(fleet.groups.size(), 1u)) {
+        CHECK_EQUAL(fleet.groups[0].hosts, 2u);
+    }
+    if (CHECK_EQUAL(fleet.mixes.size(), 1u)) {
+        CHECK_EQUAL(fleet.mixes[0].groups.size(), 1u);
+        CHECK_EQUAL(fleet.mixes[0].hosts, 2u);
+    }
+
+    for (std::size_t i = 0; i != paths.size(); ++i)
+        std::remove(paths[i].c_str());
+}
+
+void test_fleet_mixes()
+{
+    // One host of each type and one with both, ingested by three workers
+    std::vector<std::string> paths;
+    paths.push_back("test_fleet_zen4.txt");
+    paths.push_back("test_fleet_skylake.txt");
+    paths.push_back("test_fleet_both.txt");
+    CHECK(copy_file(test::data_path("epyc_zen4.txt"), paths[0]));
+    CHECK(copy_file(test::data_path("skylake_sp.txt"), paths[1]));
+    {
+        std::ofstream out(paths[2].c_str());
+        std::ifstream zen4(test::data_path("epyc_zen4.txt").c_str());
+        std::ifstream skylake(test::data_path("skylake_sp.txt").c_str());
+        out << zen4.rdbuf() << skylake.rdbuf();
+    }
+
+    FleetSummary fleet = ingest_fleet(paths, 3);
+    CHECK_EQUAL(fleet.hosts, 3u);
+    if (CHECK_EQUAL(fleet.groups.size(), 2u)) {
+        CHECK_EQUAL(fleet.groups[0].hosts, 2u);
+        CHECK_EQUAL(fleet.groups[1].hosts, 2u);
+    }
+
+    // Each host is in exactly one mix and every index is valid
+    unsigned long long hosts = 0;
+    bool both = false;
+    for (std::size_t i = 0; i != fleet.mixes.size(); ++i) {
+        const FleetMix &mix = fleet.mixes[i];
+        hosts += mix.hosts;
+        for (std::size_t g = 0; g != mix.groups.size(); ++g)
+            CHECK(mix.groups[g] < fleet.groups.size());
+        if (mix.groups.size() == 2) {
+            both = true;
+            CHECK(mix.groups[0] < mix.groups[1]);
+            CHECK_EQUAL(mix.hosts, 1u);
+        }
+    }
+    CHECK_EQUAL(fleet.mixes.size(), 3u);
+    CHECK_EQUAL(hosts, 3u);
+    CHECK(both);
+
+    for (std::size_t i = 0; i != paths.size(); ++i)
+        std::remove(paths[i].c_str());
+}
+
+} // namespace
+
+int main()
+{
+    test_canonical_snapshot();
+    test_ingest_fleet();
+    test_fleet_mixes();
+
+    return test::result();
+}
@@ -0,0 +1,60 @@
+#include "test.hpp"
+#include <cpuid_info/hypervisor.hpp>
+#include <cstring>
+
+using namespace cpuid_info;
+
+namespace
+{
+
+bool has_feature(const HypervisorInfo &info, const char *name)
+{
+    for (std::size_t i = 0; i != info.features.size(); ++i)
+        if (std::strcmp(info.features[i], name) == 0)
+            return true;
+
+    return false;
+}
+
+void test_kvm()
+{
+    HypervisorInfo info =
+        hypervisor_info(test::load_fixture("sapphire_rapids_kvm.txt")[0]);
+    CHECK(info.vendor == Hypervisor::KVM);
+    CHECK_EQUAL(info.signature, std::string("KVMKVMKVM"));
+    CHECK_EQUAL(info.base, 0x40000000u);
+    CHECK_EQUAL(info.max_leaf, 0x40000001u);
+    CHECK(info.stable_clock);
+    CHECK(has_feature(info, "kvmclock"));
+    CHECK_EQUAL(info.tsc_hz, 0.0);
+}
+
+void test_xen()
+{
+    HypervisorInfo info = hypervisor_info(test::load_fixture("xen_hvm.txt")[0]);
+    CHECK(info.vendor == Hypervisor::Xen);
+    CHECK_EQUAL(info.max_leaf, 0x40000005u);
+    CHECK(info.stable_clock);
+    CHECK(!info.tsc_emulated);
+    CHECK_EQUAL(info.tsc_hz, 2.1e9);
+    CHECK(has_feature(info, "rdtscp"));
+}
+
+void test_bare_metal()
+{
+    HypervisorInfo info =
+        hypervisor_info(test::load_fixture("skylake_sp.txt")[0]);
+    CHECK(info.empty());
+    CHECK(info.features.empty());
+}
+
+} // namespace
+
+int main()
+{
+    test_kvm();
+    test_xen();
+    test_bare_metal();
+
+    return test::result();
+}
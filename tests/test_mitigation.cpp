@@ -0,0 +1,76 @@
+#include "test.hpp"
+#include <cpuid_info/cpu_info.hpp>
+#include <cpuid_info/mitigation.hpp>
+#include <algorithm>
+
+using namespace cpuid_info;
+
+namespace
+{
+
+bool contains(const std::vector<Feature> &features, Feature feature)
+{
+    return std::find(features.begin(), features.end(), feature) !=
+        features.end();
+}
+
+void test_controls()
+{
+    CpuInfo spr(test::load_fixture("sapphire_rapids_kvm.txt")[0]);
+    std::vector<Feature> controls = speculation_controls(spr.features());
+    CHECK(contains(controls, Feature::MD_CLEAR));
+    CHECK(contains(controls, Feature::SPEC_CTRL));
+    CHECK(!contains(controls, Feature::AUTOIBRS));
+
+    CpuInfo zen4(test::load_fixture("epyc_zen4.txt")[0]);
+    controls = speculation_controls(zen4.features());
+    CHECK(contains(controls, Feature::AMD_IBPB));
+    CHECK(contains(controls, Feature::AMD_IBRS));
+    CHECK(contains(controls, Feature::AMD_STIBP));
+    CHECK(contains(controls, Feature::AMD_SSBD));
+    CHECK(contains(controls, Feature::AUTOIBRS));
+    CHECK(!contains(controls, Feature::MD_CLEAR));
+}
+
+void test_vulnerabilities()
+{
+    CpuInfo zen4(test::load_fixture("epyc_zen4.txt")[0]);
+    std::vector<Vulnerability> vulns = read_vulnerabilities(
+        zen4.features(), test::data_path("vulnerabilities"));
+    if (!CHECK_EQUAL(vulns.size(), 3u))
+        return;
+    CHECK_EQUAL(vulns[0].name, std::string("mds"));
+    CHECK_EQUAL(vulns[1].name, std::string("spec_store_bypass"));
+    CHECK_EQUAL(vulns[2].name, std::string("spectre_v2"));
+    CHECK_EQUAL(vulns[2].status.compare(0, 39,
+                    "Mitigation: Enhanced / Automatic IBRS; "),
+        0);
+    CHECK(vulns[0].controls.empty());
+    CHECK(contains(vulns[1].controls, Feature::AMD_SSBD));
+    CHECK(contains(vulns[2].controls, Feature::AUTOIBRS));
+
+    CHECK(read_vulnerabilities(zen4.features(), test::data_path("none"))
+              .empty());
+}
+
+void test_options()
+{
+    std::vector<std::string> options =
+        mitigation_options(test::data_path("cmdline"));
+    if (!CHECK_EQUAL(options.size(), 3u))
+        return;
+    CHECK_EQUAL(options[0], std::string("spectre_v2=retpoline"));
+    CHECK_EQUAL(options[1], std::string("nosmt"));
+    CHECK_EQUAL(options[2], std::string("mds=full,nosmt"));
+}
+
+} // namespace
+
+int main()
+{
+    test_controls();
+    test_vulnerabilities();
+    test_options();
+
+    return test::result();
+}
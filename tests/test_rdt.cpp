@@ -0,0 +1,81 @@
+#include "test.hpp"
+#include <cpuid_info/rdt.hpp>
+
+using namespace cpuid_info;
+
+namespace
+{
+
+void test_skylake_sp()
+{
+    RdtInfo info = rdt_info(test::load_fixture("skylake_sp.txt")[0]);
+    CHECK(info.monitoring());
+    CHECK_EQUAL(info.max_rmid, 223u);
+    CHECK(info.l3_monitoring);
+    CHECK_EQUAL(info.l3_max_rmid, 223u);
+    CHECK_EQUAL(info.l3_scale, 49152u);
+    CHECK_EQUAL(info.l3_counter_width, 24u);
+    CHECK(info.l3_overflow_bit);
+    CHECK(info.l3_occupancy);
+    CHECK(info.l3_total_bandwidth);
+    CHECK(info.l3_local_bandwidth);
+
+    CHECK_EQUAL(info.caches.size(), 1u);
+    const RdtCacheAllocation *l3 = info.cache(3);
+    if (CHECK(l3 != nullptr)) {
+        CHECK_EQUAL(l3->cbm_length, 11u);
+        CHECK_EQUAL(l3->shareable_mask, 0x600u);
+        CHECK_EQUAL(l3->cos_count, 16u);
+        CHECK(l3->cdp);
+    }
+    CHECK(info.cache(2) == nullptr);
+
+    CHECK(info.mba);
+    CHECK_EQUAL(info.mba_max, 90u);
+    CHECK(info.mba_linear);
+    CHECK(!info.mba_amd);
+    CHECK_EQUAL(info.mba_cos_count, 8u);
+}
+
+void test_epyc_zen4()
+{
+    // PQoS reuses leaves 0x0F/0x10, bandwidth limits are in 0x80000020
+    RdtInfo info = rdt_info(test::load_fixture("epyc_zen4.txt")[0]);
+    CHECK_EQUAL(info.max_rmid, 255u);
+    CHECK(info.l3_monitoring);
+    CHECK_EQUAL(info.l3_scale, 64u);
+    CHECK_EQUAL(info.l3_counter_width, 24u);
+    CHECK(info.l3_occupancy);
+    CHECK(info.l3_total_bandwidth);
+    CHECK(info.l3_local_bandwidth);
+
+    const RdtCacheAllocation *l3 = info.cache(3);
+    if (CHECK(l3 != nullptr)) {
+        CHECK_EQUAL(l3->cbm_length, 16u);
+        CHECK_EQUAL(l3->shareable_mask, 0u);
+        CHECK_EQUAL(l3->cos_count, 16u);
+    }
+
+    CHECK(info.mba);
+    CHECK(info.mba_amd);
+    CHECK_EQUAL(info.mba_max, 2048u);
+    CHECK_EQUAL(info.mba_cos_count, 16u);
+}
+
+void test_sapphire_rapids_kvm()
+{
+    // KVM does not pass resource director technology through
+    RdtInfo info = rdt_info(test::load_fixture("sapphire_rapids_kvm.txt")[0]);
+    CHECK(info.empty());
+}
+
+} // namespace
+
+int main()
+{
+    test_skylake_sp();
+    test_epyc_zen4();
+    test_sapphire_rapids_kvm();
+
+    return test::result();
+}
@@ -0,0 +1,140 @@
+#include "test.hpp"
+#include <cpuid_info/resctrl.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#if defined(__linux__)
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace cpuid_info;
+
+namespace
+{
+
+#if defined(__linux__)
+// A resctrl mount of a two socket host, without CDP
+const char *const root = "test_resctrl_root";
+
+const char *const files[][2] = {
+    {"info/L3/cbm_mask", "7ff\n"},
+    {"info/L3/shareable_bits", "600\n"},
+    {"info/L3/min_cbm_bits", "1\n"},
+    {"info/MB/min_bandwidth", "10\n"},
+    {"info/MB/bandwidth_gran", "10\n"},
+    {"schemata", "    L3:0=7ff;1=7ff\n    MB:0=100;1=100\n"},
+};
+
+const std::size_t file_count = sizeof(files) / sizeof(files[0]);
+
+// Parents first
+const char *const dirs[] = {"", "info", "info/L3", "info/MB"};
+
+const std::size_t dir_count = sizeof(dirs) / sizeof(char *);
+
+std::string path(const std::string &name)
+{
+    return name.empty() ? std::string(root) : std::string(root) + "/" + name;
+}
+
+bool make_tree()
+{
+    bool ok = true;
+    for (std::size_t i = 0; ok && i != dir_count; ++i)
+        ok = ::mkdir(path(dirs[i]).c_str(), 0755) == 0;
+    for (std::size_t i = 0; ok && i != file_count; ++i) {
+        std::ofstream out(path(files[i][0]).c_str());
+        out << files[i][1];
+        ok = static_cast<bool>(out);
+    }
+
+    return ok;
+}
+
+void remove_tree()
+{
+    for (std::size_t i = 0; i != file_count; ++i)
+        std::remove(path(files[i][0]).c_str());
+    std::remove(path("critical/schemata").c_str());
+    ::rmdir(path("critical").c_str());
+    for (std::size_t i = dir_count; i != 0; --i)
+        ::rmdir(path(dirs[i - 1]).c_str());
+}
+
+std::string read_file(const std::string &name)
+{
+    std::ifstream in(path(name).c_str());
+    std::stringstream ss;
+    ss << in.rdbuf();
+
+    return ss.str();
+}
+
+void test_plan_and_apply()
+{
+    remove_tree();
+    if (!CHECK(make_tree())) {
+        remove_tree();
+        return;
+    }
+
+    RdtInfo rdt = rdt_info(test::load_fixture("skylake_sp.txt")[0]);
+    ResctrlLayout layout;
+    CHECK(read_resctrl_layout(root, rdt, layout));
+    CHECK(layout.mounted);
+    const ResctrlResource *l3 = layout.find("L3");
+    if (CHECK(l3 != nullptr)) {
+        CHECK_EQUAL(l3->domains.size(), 2u);
+        CHECK_EQUAL(l3->cbm_length, 11u);
+        CHECK_EQUAL(l3->shareable_mask, 0x600u);
+    }
+    const ResctrlResource *mb = layout.find("MB");
+    if (CHECK(mb != nullptr))
+        CHECK_EQUAL(mb->bandwidth_gran, 10u);
+
+    // The high ways are shareable with I/O, so the critical group gets the
+    // four lowest
+    ResctrlPlan plan;
+    CHECK(plan_resctrl(layout, 4, 30, plan));
+    CHECK_EQUAL(plan.critical_mask, 0xfu);
+    CHECK_EQUAL(plan.batch_mask, 0x7f0u);
+    CHECK_EQUAL(plan.critical, std::string("L3:0=f;1=f\nMB:0=100;1=100\n"));
+    CHECK_EQUAL(plan.batch, std::string("L3:0=7f0;1=7f0\nMB:0=70;1=70\n"));
+
+    CHECK(apply_resctrl(root, "critical", plan));
+    CHECK_EQUAL(read_file("critical/schemata"), plan.critical);
+    CHECK_EQUAL(read_file("schemata"), plan.batch);
+
+    // Every way for the critical group leaves none to the default group
+    CHECK(!plan_resctrl(layout, 11, 0, plan));
+
+    remove_tree();
+}
+#endif
+
+void test_parse_reservation()
+{
+    unsigned ways = 0;
+    unsigned mba_percent = 0;
+    CHECK(parse_reservation("4,30", ways, mba_percent));
+    CHECK_EQUAL(ways, 4u);
+    CHECK_EQUAL(mba_percent, 30u);
+    CHECK(parse_reservation("2", ways, mba_percent));
+    CHECK_EQUAL(mba_percent, 0u);
+    CHECK(!parse_reservation("0,0", ways, mba_percent));
+    CHECK(!parse_reservation("4,100", ways, mba_percent));
+}
+
+} // namespace
+
+int main()
+{
+#if defined(__linux__)
+    test_plan_and_apply();
+#endif
+    test_parse_reservation();
+
+    return test::result();
+}
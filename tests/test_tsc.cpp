@@ -0,0 +1,49 @@
+#include "test.hpp"
+#include <cpuid_info/tsc.hpp>
+
+using namespace cpuid_info;
+
+namespace
+{
+
+void test_skylake_sp()
+{
+    // Leaf 0x15 leaves the crystal out, leaf 0x16 gives 2300 MHz base
+    CpuInfo cpu(test::load_fixture("skylake_sp.txt")[0]);
+    TscInfo info = tsc_info(cpu);
+    CHECK(info.source == TscSource::Leaf15Base);
+    CHECK_EQUAL(info.ratio_numerator, 0xb8u);
+    CHECK_EQUAL(info.ratio_denominator, 2u);
+    CHECK_EQUAL(info.crystal_hz, 25000000u);
+    CHECK_EQUAL(info.hz, 2.3e9);
+    CHECK(info.invariant);
+}
+
+void test_xen()
+{
+    CpuInfo cpu(test::load_fixture("xen_hvm.txt")[0]);
+    TscInfo info = tsc_info(cpu);
+    CHECK(info.source == TscSource::Hypervisor);
+    CHECK_EQUAL(info.hz, 2.1e9);
+}
+
+void test_kvm()
+{
+    // Neither leaf 0x15 nor 0x16 nor a hypervisor timing leaf
+    CpuInfo cpu(test::load_fixture("sapphire_rapids_kvm.txt")[0]);
+    TscInfo info = tsc_info(cpu);
+    CHECK(info.source == TscSource::None);
+    CHECK_EQUAL(info.hz, 0.0);
+    CHECK(info.invariant);
+}
+
+} // namespace
+
+int main()
+{
+    test_skylake_sp();
+    test_xen();
+    test_kvm();
+
+    return test::result();
+}
@@ -0,0 +1,87 @@
+#include "test.hpp"
+#include <cpuid_info/compiler_flags.hpp>
+#include <cpuid_info/uarch.hpp>
+#include <string>
+
+using namespace cpuid_info;
+
+namespace
+{
+
+void test_epyc_zen4()
+{
+    // Double pumped AVX-512 keeps the clock, so 512-bit vectors pay off
+    CpuInfo info(test::load_fixture("epyc_zen4.txt")[0]);
+    const Microarch *m = identify_microarch(info);
+    if (CHECK(m != nullptr)) {
+        CHECK_EQUAL(std::string(m->name), "Zen 4");
+        CHECK_EQUAL(std::string(m->march), "znver4");
+        CHECK_EQUAL(m->vector_width, 512u);
+    }
+
+    Quirks quirks = microarch_quirks(info);
+    CHECK(!quirks.slow_pdep_pext);
+    CHECK_EQUAL(quirks.avx512_fma_ports, 1u);
+    CHECK(quirks.rep_movsb == RepMovsb::Large);
+    CHECK(!quirks.split_lock_detect);
+
+    CHECK(isa_level(info.features()) == IsaLevel::V4);
+    CompilerFlags flags = compiler_flags(info);
+    CHECK_EQUAL(flags.march, "x86-64-v4");
+    CHECK_EQUAL(flags.mtune, "znver4");
+    CHECK_EQUAL(flags.vector_width, 512u);
+}
+
+void test_skylake_sp()
+{
+    // Two FMA ports, but the AVX-512 license lowers the whole core's clock
+    CpuInfo info(test::load_fixture("skylake_sp.txt")[0]);
+    const Microarch *m = identify_microarch(info);
+    if (CHECK(m != nullptr)) {
+        CHECK_EQUAL(std::string(m->name), "Skylake-SP");
+        CHECK_EQUAL(std::string(m->march), "skylake-avx512");
+        CHECK_EQUAL(m->vector_width, 256u);
+    }
+
+    Quirks quirks = microarch_quirks(info);
+    CHECK_EQUAL(quirks.avx512_fma_ports, 2u);
+    CHECK(quirks.rep_movsb == RepMovsb::Large);
+    CHECK(!quirks.split_lock_detect);
+
+    CHECK(isa_level(info.features()) == IsaLevel::V4);
+    CompilerFlags flags = compiler_flags(info);
+    CHECK_EQUAL(flags.march, "x86-64-v4");
+    CHECK_EQUAL(flags.mtune, "skylake-avx512");
+    CHECK_EQUAL(flags.vector_width, 256u);
+}
+
+void test_hidden_avx512()
+{
+    // A hypervisor hiding AVX512F keeps the tuning, not the AVX-512 ports
+    Snapshot snapshot(test::load_fixture("epyc_zen4.txt")[0]);
+    Register reg(snapshot.get(0x07));
+    reg.ebx &= ~(1U << 16);
+    snapshot.insert(0x07, 0x00, reg);
+    CpuInfo info(snapshot);
+
+    const Microarch *m = identify_microarch(info);
+    if (CHECK(m != nullptr))
+        CHECK_EQUAL(std::string(m->march), "znver4");
+    CHECK_EQUAL(microarch_quirks(info).avx512_fma_ports, 0u);
+    CHECK(isa_level(info.features()) == IsaLevel::V3);
+    CompilerFlags flags = compiler_flags(info);
+    CHECK_EQUAL(flags.march, "x86-64-v3");
+    CHECK_EQUAL(flags.mtune, "znver4");
+    CHECK_EQUAL(flags.vector_width, 0u);
+}
+
+} // namespace
+
+int main()
+{
+    test_epyc_zen4();
+    test_skylake_sp();
+    test_hidden_avx512();
+
+    return test::result();
+}
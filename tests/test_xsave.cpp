@@ -0,0 +1,95 @@
+#include "test.hpp"
+#include <cpuid_info/cpu_info.hpp>
+#include <cpuid_info/xsave.hpp>
+
+using namespace cpuid_info;
+
+namespace
+{
+
+const XsaveComponent *component(const XsaveInfo &info, unsigned index)
+{
+    for (std::size_t i = 0; i != info.components.size(); ++i)
+        if (info.components[i].index == index)
+            return &info.components[i];
+
+    return nullptr;
+}
+
+void test_sapphire_rapids()
+{
+    XsaveInfo info =
+        xsave_info(test::load_fixture("sapphire_rapids_kvm.txt")[0]);
+    CHECK_EQUAL(info.user_mask, 0x602e7u);
+    CHECK_EQUAL(info.enabled_size, 0x2b00u);
+    CHECK_EQUAL(info.max_size, 0x2b00u);
+    CHECK_EQUAL(info.compacted_size, 0x2a00u);
+    CHECK(info.xsaveopt && info.xsavec && info.xgetbv1 && info.xsaves);
+    CHECK(info.xfd);
+
+    const XsaveComponent *ymm = component(info, 2);
+    if (CHECK(ymm != nullptr)) {
+        CHECK_EQUAL(ymm->size, 256u);
+        CHECK_EQUAL(ymm->offset, 576u);
+        CHECK(!ymm->supervisor);
+    }
+    const XsaveComponent *tiles = component(info, 0x12);
+    if (CHECK(tiles != nullptr)) {
+        CHECK_EQUAL(tiles->size, 0x2000u);
+        CHECK_EQUAL(tiles->offset, 0xb00u);
+        CHECK(tiles->aligned);
+        CHECK(tiles->xfd);
+    }
+    const XsaveComponent *pasid = component(info, 0x0b);
+    if (CHECK(pasid != nullptr))
+        CHECK(pasid->supervisor);
+}
+
+void test_skylake_sp()
+{
+    XsaveInfo info = xsave_info(test::load_fixture("skylake_sp.txt")[0]);
+    CHECK(!info.empty());
+    CHECK(component(info, 3) != nullptr);  // MPX bound registers
+    CHECK(component(info, 4) != nullptr);  // MPX bound config
+    CHECK(component(info, 7) != nullptr);  // ZMM_Hi256
+    CHECK(component(info, 0x12) == nullptr);
+
+    const XsaveComponent *pt = component(info, 8);
+    if (CHECK(pt != nullptr))
+        CHECK(pt->supervisor);
+}
+
+void test_usable_features()
+{
+    CpuInfo info(test::load_fixture("sapphire_rapids_kvm.txt")[0]);
+    const Features &present = info.features();
+    CHECK(present.has(Feature::AVX512F));
+    CHECK(present.has(Feature::AMX_TILE));
+
+    // SSE only: neither AVX nor anything built on it
+    Features sse = usable_features(present, 0x3);
+    CHECK(!sse.has(Feature::AVX2));
+    CHECK(!sse.has(Feature::AVX512F));
+    CHECK(sse.has(Feature::SSE4_2));
+
+    // SSE and AVX state, but no opmask or ZMM state
+    Features avx = usable_features(present, 0x7);
+    CHECK(avx.has(Feature::AVX2));
+    CHECK(!avx.has(Feature::AVX512F));
+    CHECK(!avx.has(Feature::AMX_TILE));
+
+    Features all = usable_features(present, 0x602e7);
+    CHECK(all.has(Feature::AVX512F));
+    CHECK(all.has(Feature::AMX_TILE));
+}
+
+} // namespace
+
+int main()
+{
+    test_sapphire_rapids();
+    test_skylake_sp();
+    test_usable_features();
+
+    return test::result();
+}